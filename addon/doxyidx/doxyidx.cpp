@@ -0,0 +1,425 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2024 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Command line tool to query the search.idx file that doxygen generates
+ *         for the server based search engine, without the need for PHP, and the
+ *         compact JavaScript search data used by the client side search.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "searchidx.h"
+#include "searchshards.h"
+#include "version.h"
+
+/** Escapes a string such that is can be included in a JSON structure */
+static std::string escapeString(const std::string &s)
+{
+  std::string dst;
+  dst.reserve(s.length());
+  for (char ch : s)
+  {
+    switch (ch)
+    {
+      case '\"': dst+="\\\""; break;
+      case '\\': dst+="\\\\"; break;
+      case '\n': dst+="\\n";  break;
+      case '\t': dst+="\\t";  break;
+      default:   dst+=ch;     break;
+    }
+  }
+  return dst;
+}
+
+static void writeJson(std::ostream &out,const std::vector<SearchIdx::Result> &results)
+{
+  out << "{\"hits\":" << results.size() << ",\"items\":[";
+  bool firstItem=true;
+  for (const auto &r : results)
+  {
+    if (!firstItem) out << ",";
+    out << "{\"name\":\"" << escapeString(r.name) << "\","
+        << "\"url\":\""   << escapeString(r.url)  << "\","
+        << "\"rank\":"    << r.rank << ","
+        << "\"words\":[";
+    bool firstWord=true;
+    for (const auto &w : r.words)
+    {
+      if (!firstWord) out << ",";
+      out << "{\"word\":\""  << escapeString(w.word)  << "\","
+          << "\"match\":\""  << escapeString(w.match) << "\","
+          << "\"freq\":"     << w.freq << "}";
+      firstWord=false;
+    }
+    out << "]}";
+    firstItem=false;
+  }
+  out << "]}" << std::endl;
+}
+
+static void writeText(std::ostream &out,const std::vector<SearchIdx::Result> &results)
+{
+  size_t num=1;
+  for (const auto &r : results)
+  {
+    out << std::setw(4) << num++ << ". " << r.name << "  [" << r.url << "]  rank=" << r.rank << std::endl;
+    out << "      matches:";
+    for (const auto &w : r.words)
+    {
+      out << " " << w.match << "(" << w.freq << ")";
+    }
+    out << std::endl;
+  }
+  if (results.empty()) out << "Sorry, no documents matching your query." << std::endl;
+}
+
+/** Answers one query per line read from standard input until end of file,
+ *  keeping the index mapped between queries.
+ */
+static int serveQueries(const SearchIdx &idx,size_t maxResults)
+{
+  std::string line;
+  while (std::getline(std::cin,line))
+  {
+    if (!line.empty() && line.back()=='\r') line.pop_back();
+    writeJson(std::cout,idx.query(line,maxResults));
+  }
+  return 0;
+}
+
+/** Reads the non-empty lines of \a queryFile into \a queries. */
+static bool readQueries(const std::string &queryFile,std::vector<std::string> &queries)
+{
+  std::ifstream f(queryFile);
+  if (!f.is_open())
+  {
+    std::cerr << "Error: could not open query file '" << queryFile << "'" << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(f,line))
+  {
+    if (!line.empty() && line.back()=='\r') line.pop_back();
+    if (!line.empty()) queries.push_back(line);
+  }
+  if (queries.empty())
+  {
+    std::cerr << "Error: no queries found in '" << queryFile << "'" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/** Runs each of \a queries \a rounds times via \a runQuery, which returns the number
+ *  of results, and reports the latency distribution.
+ */
+static void runBenchmark(const std::vector<std::string> &queries,int rounds,
+                         const std::function<size_t(const std::string &)> &runQuery)
+{
+  using clock = std::chrono::steady_clock;
+  std::vector<double> latencies;
+  latencies.reserve(queries.size()*static_cast<size_t>(rounds));
+  size_t totalHits=0;
+  auto start = clock::now();
+  for (int round=0; round<rounds; round++)
+  {
+    for (const auto &q : queries)
+    {
+      auto t0 = clock::now();
+      totalHits += runQuery(q);
+      latencies.push_back(std::chrono::duration<double,std::micro>(clock::now()-t0).count());
+    }
+  }
+  double elapsed = std::chrono::duration<double>(clock::now()-start).count();
+
+  std::sort(latencies.begin(),latencies.end());
+  auto percentile = [&latencies](double pct)
+  {
+    size_t i = static_cast<size_t>(pct/100.0*static_cast<double>(latencies.size()-1)+0.5);
+    return latencies[std::min(i,latencies.size()-1)];
+  };
+  std::cout << "queries:  " << latencies.size() << " (" << queries.size() << " distinct, "
+                            << rounds << " rounds), " << totalHits << " results" << std::endl
+            << "elapsed:  " << elapsed << " s, " << static_cast<double>(latencies.size())/elapsed
+                            << " queries/s" << std::endl
+            << "latency:  p50=" << percentile(50) << " us, p90=" << percentile(90)
+            << " us, p99=" << percentile(99) << " us, max=" << percentile(100) << " us" << std::endl;
+}
+
+static void writeJson(std::ostream &out,const std::vector<SearchShards::Entry> &entries)
+{
+  out << "{\"hits\":" << entries.size() << ",\"items\":[";
+  bool firstItem=true;
+  for (const auto &e : entries)
+  {
+    if (!firstItem) out << ",";
+    out << "{\"id\":\""   << escapeString(e.id)   << "\","
+        << "\"name\":\""  << escapeString(e.name) << "\","
+        << "\"links\":[";
+    bool firstLink=true;
+    for (const auto &l : e.links)
+    {
+      if (!firstLink) out << ",";
+      out << "{\"url\":\"" << escapeString(l.url) << "\","
+          << "\"target\":\"" << (l.parentTarget ? "_parent" : "_blank") << "\"";
+      if (l.hasScope) out << ",\"scope\":\"" << escapeString(l.scope) << "\"";
+      out << "}";
+      firstLink=false;
+    }
+    out << "]}";
+    firstItem=false;
+  }
+  out << "]}" << std::endl;
+}
+
+static void writeText(std::ostream &out,const std::vector<SearchShards::Entry> &entries)
+{
+  size_t num=1;
+  for (const auto &e : entries)
+  {
+    out << std::setw(4) << num++ << ". " << e.name << std::endl;
+    for (const auto &l : e.links)
+    {
+      out << "      [" << l.url << "]";
+      if (l.hasScope) out << "  " << l.scope;
+      out << std::endl;
+    }
+  }
+  if (entries.empty()) out << "No Matches" << std::endl;
+}
+
+enum class Mode { Query, Serve, Bench, Check };
+
+/** Handles the query, serve, bench and check modes for the compact search data in \a args[0] */
+static int runShards(Mode mode,const std::vector<std::string> &args,const std::string &section,
+                     int rounds,size_t maxResults,bool json)
+{
+  SearchShards shards;
+  std::string errorMsg;
+  if (!shards.open(args[0],errorMsg))
+  {
+    std::cerr << "Error: " << errorMsg << std::endl;
+    return 1;
+  }
+  auto query = [&](const std::string &text,size_t &shardsLoaded)
+  {
+    auto entries = shards.query(section,text,shardsLoaded);
+    if (maxResults>0 && entries.size()>maxResults) entries.resize(maxResults);
+    return entries;
+  };
+  switch (mode)
+  {
+    case Mode::Query:
+      {
+        std::string text;
+        for (size_t i=1; i<args.size(); i++)
+        {
+          if (i>1) text+=' ';
+          text+=args[i];
+        }
+        size_t shardsLoaded=0;
+        auto entries = query(text,shardsLoaded);
+        if (json) writeJson(std::cout,entries); else writeText(std::cout,entries);
+      }
+      break;
+    case Mode::Serve:
+      {
+        std::string line;
+        size_t shardsLoaded=0;
+        while (std::getline(std::cin,line))
+        {
+          if (!line.empty() && line.back()=='\r') line.pop_back();
+          writeJson(std::cout,query(line,shardsLoaded));
+        }
+      }
+      break;
+    case Mode::Bench:
+      {
+        std::vector<std::string> queries;
+        if (!readQueries(args[1],queries)) return 1;
+        // cold: every query reads its shards from disk, as on the first search in a browser
+        size_t shardsLoaded=0;
+        std::cout << "cold (shards read for every query):" << std::endl;
+        runBenchmark(queries,rounds,[&](const std::string &q)
+        {
+          shards.clearCache();
+          return query(q,shardsLoaded).size();
+        });
+        std::cout << "shards:   " << static_cast<double>(shardsLoaded)/static_cast<double>(queries.size()*static_cast<size_t>(rounds))
+                  << " read per query" << std::endl;
+        // warm: shards stay loaded, as while typing in the search box
+        std::cout << "warm (shards cached):" << std::endl;
+        runBenchmark(queries,rounds,[&](const std::string &q) { return query(q,shardsLoaded).size(); });
+      }
+      break;
+    case Mode::Check:
+      {
+        SearchShards::Stats stats;
+        if (!shards.check(stats,errorMsg))
+        {
+          std::cerr << "Error: " << errorMsg << std::endl;
+          return 1;
+        }
+        std::cout << "pages:    " << stats.pages   << std::endl
+                  << "shards:   " << stats.shards  << std::endl
+                  << "entries:  " << stats.entries << std::endl
+                  << "links:    " << stats.links   << std::endl
+                  << "bytes:    " << stats.bytes   << std::endl;
+      }
+      break;
+  }
+  return 0;
+}
+
+static void usage(const char *name,int exitVal = 1)
+{
+  std::cerr << "Usage: " << name << " [options] search.idx query..." << std::endl;
+  std::cerr << "       " << name << " [options] --serve search.idx" << std::endl;
+  std::cerr << "       " << name << " [options] --bench search.idx queries.txt" << std::endl;
+  std::cerr << "       " << name << " [options] --js [--serve|--bench|--check] html/search ..." << std::endl;
+  std::cerr << "Options:" << std::endl;
+  std::cerr << "  -n <max>     return at most <max> results per query (default: all)" << std::endl;
+  std::cerr << "  -r <rounds>  number of times each query is run in benchmark mode (default: 100)" << std::endl;
+  std::cerr << "  --json       print the results in JSON format" << std::endl;
+  std::cerr << "  --serve      read one query per line from standard input and answer each" << std::endl;
+  std::cerr << "               with one line of JSON, keeping the index open" << std::endl;
+  std::cerr << "  --bench      run the queries from a file and report latency percentiles" << std::endl;
+  std::cerr << "  --js         use the compact JavaScript search data in the given search directory" << std::endl;
+  std::cerr << "               (COMPACT_SEARCH_INDEX=YES) instead of search.idx" << std::endl;
+  std::cerr << "  -s <section> section of the JavaScript search data to query (default: all)" << std::endl;
+  std::cerr << "  --check      with --js: read all shards, validate them and print their totals" << std::endl;
+  std::cerr << "  -h, --help   print this help" << std::endl;
+  std::cerr << "  -v, --version  print version information" << std::endl;
+  exit(exitVal);
+}
+
+int main(int argc,const char **argv)
+{
+  Mode mode = Mode::Query;
+  bool json = false;
+  bool js = false;
+  std::string section = "all";
+  size_t maxResults = 0;
+  int rounds = 100;
+  std::vector<std::string> args;
+  for (int i=1; i<argc; i++)
+  {
+    if (std::strcmp(argv[i],"-n")==0 && i+1<argc)
+    {
+      maxResults = static_cast<size_t>(std::max(0,atoi(argv[++i])));
+    }
+    else if (std::strcmp(argv[i],"-r")==0 && i+1<argc)
+    {
+      rounds = std::max(1,atoi(argv[++i]));
+    }
+    else if (std::strcmp(argv[i],"-s")==0 && i+1<argc)
+    {
+      section = argv[++i];
+    }
+    else if (std::strcmp(argv[i],"--js")==0)
+    {
+      js = true;
+    }
+    else if (std::strcmp(argv[i],"--check")==0)
+    {
+      mode = Mode::Check;
+    }
+    else if (std::strcmp(argv[i],"--json")==0)
+    {
+      json = true;
+    }
+    else if (std::strcmp(argv[i],"--serve")==0)
+    {
+      mode = Mode::Serve;
+    }
+    else if (std::strcmp(argv[i],"--bench")==0)
+    {
+      mode = Mode::Bench;
+    }
+    else if (std::strcmp(argv[i],"-h")==0 || std::strcmp(argv[i],"--help")==0)
+    {
+      usage(argv[0],0);
+    }
+    else if (std::strcmp(argv[i],"-v")==0 || std::strcmp(argv[i],"--version")==0)
+    {
+      std::cout << argv[0] << " version: " << getFullVersion() << std::endl;
+      exit(0);
+    }
+    else
+    {
+      args.emplace_back(argv[i]);
+    }
+  }
+  if (args.empty() ||
+      (mode==Mode::Query && args.size()<2) ||
+      (mode==Mode::Serve && args.size()!=1) ||
+      (mode==Mode::Bench && args.size()!=2) ||
+      (mode==Mode::Check && (args.size()!=1 || !js)))
+  {
+    usage(argv[0]);
+  }
+
+  if (js)
+  {
+    return runShards(mode,args,section,rounds,maxResults,json);
+  }
+
+  SearchIdx idx;
+  std::string errorMsg;
+  if (!idx.open(args[0],errorMsg))
+  {
+    std::cerr << "Error: " << errorMsg << std::endl;
+    return 1;
+  }
+
+  switch (mode)
+  {
+    case Mode::Serve:
+      return serveQueries(idx,maxResults);
+    case Mode::Bench:
+      {
+        std::vector<std::string> queries;
+        if (!readQueries(args[1],queries)) return 1;
+        runBenchmark(queries,rounds,[&](const std::string &q) { return idx.query(q,maxResults).size(); });
+      }
+      break;
+    case Mode::Check:
+      break;
+    case Mode::Query:
+      {
+        std::string query;
+        for (size_t i=1; i<args.size(); i++)
+        {
+          if (i>1) query+=' ';
+          query+=args[i];
+        }
+        auto results = idx.query(query,maxResults);
+        if (json) writeJson(std::cout,results); else writeText(std::cout,results);
+      }
+      break;
+  }
+  return 0;
+}
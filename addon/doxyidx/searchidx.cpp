@@ -0,0 +1,454 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2024 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "searchidx.h"
+
+// Layout of search.idx (all integers are 32 bit big endian):
+//
+//  "DOXS"                                   header
+//  int[65536]                               offset of the word list per
+//                                           (first,second) character pair, 0 if empty
+//  { char word[]; int statOffset; }* '\0'   word lists, zero terminated
+//  padding to a multiple of 4 bytes
+//  { int numDocs; { int urlOffset; int freq; }[numDocs] }*
+//                                           posting list per word, freq is
+//                                           2*count, bit 0 marks a high priority doc
+//  { char name[]; char url[]; }*            document info
+
+static const size_t   headerSize      = 4;
+static const size_t   numIndexEntries = 256*256;
+
+namespace {
+
+/** Occurrence of an indexed word in a document */
+struct Hit
+{
+  uint32_t url;      // offset of the document info
+  uint32_t matchIdx; // index of the matching indexed word
+  uint32_t freq;     // raw frequency as stored in the file
+  double   rank;
+};
+
+/** All hits for a single word of the query */
+struct WordHits
+{
+  std::string word;
+  bool required  = false;
+  bool forbidden = false;
+  std::vector<std::string_view> matches;
+  std::vector<Hit> hits;       // sorted on url
+  std::vector<uint32_t> docs;  // sorted unique urls of hits
+};
+
+/** Accumulated rank of a document */
+struct DocScore
+{
+  uint32_t url;
+  double   rank = 0.0;
+  std::vector<std::pair<size_t,size_t>> hits; // (word index, hit index)
+};
+
+/** Intersects the sorted lists \a a and \a b. When one list is much shorter than
+ *  the other, the longer one is searched with exponentially growing steps, so
+ *  the cost depends on the size of the short list only.
+ */
+std::vector<uint32_t> intersect(const std::vector<uint32_t> &a,const std::vector<uint32_t> &b)
+{
+  const std::vector<uint32_t> &small = a.size()<=b.size() ? a : b;
+  const std::vector<uint32_t> &large = a.size()<=b.size() ? b : a;
+  std::vector<uint32_t> result;
+  result.reserve(small.size());
+  if (small.size()*16<large.size())
+  {
+    size_t pos=0;
+    for (uint32_t v : small)
+    {
+      size_t step=1;
+      while (pos+step<large.size() && large[pos+step]<v) step*=2;
+      auto last = large.begin()+static_cast<std::ptrdiff_t>(std::min(pos+step+1,large.size()));
+      pos = static_cast<size_t>(std::lower_bound(large.begin()+static_cast<std::ptrdiff_t>(pos),last,v)-large.begin());
+      if (pos==large.size()) break;
+      if (large[pos]==v) result.push_back(v);
+    }
+  }
+  else
+  {
+    std::set_intersection(small.begin(),small.end(),large.begin(),large.end(),std::back_inserter(result));
+  }
+  return result;
+}
+
+std::vector<uint32_t> merge(const std::vector<uint32_t> &a,const std::vector<uint32_t> &b)
+{
+  std::vector<uint32_t> result;
+  result.reserve(a.size()+b.size());
+  std::set_union(a.begin(),a.end(),b.begin(),b.end(),std::back_inserter(result));
+  return result;
+}
+
+} // namespace
+
+struct SearchIdx::Private
+{
+  const unsigned char *data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE file    = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#else
+  void *mapped = nullptr;
+#endif
+  std::vector<unsigned char> buffer; // used if the file cannot be mapped
+
+  bool map(const std::string &fileName);
+  void unmap();
+
+  uint32_t readInt(size_t offset) const
+  {
+    if (offset+4>size) return 0;
+    const unsigned char *d = data+offset;
+    return (static_cast<uint32_t>(d[0])<<24) | (static_cast<uint32_t>(d[1])<<16) |
+           (static_cast<uint32_t>(d[2])<<8)  |  static_cast<uint32_t>(d[3]);
+  }
+  std::string_view readString(size_t &offset) const
+  {
+    if (offset>=size) return std::string_view();
+    const char *s = reinterpret_cast<const char *>(data+offset);
+    const void *end = memchr(s,0,size-offset);
+    if (end==nullptr) { offset=size; return std::string_view(); }
+    size_t len = static_cast<size_t>(static_cast<const char*>(end)-s);
+    offset+=len+1;
+    return std::string_view(s,len);
+  }
+
+  void lookup(WordHits &wh) const;
+};
+
+#ifdef _WIN32
+bool SearchIdx::Private::map(const std::string &fileName)
+{
+  file = CreateFileA(fileName.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+  if (file==INVALID_HANDLE_VALUE) return false;
+  LARGE_INTEGER fileSize;
+  if (GetFileSizeEx(file,&fileSize) && fileSize.QuadPart>0)
+  {
+    mapping = CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+    if (mapping)
+    {
+      data = static_cast<const unsigned char *>(MapViewOfFile(mapping,FILE_MAP_READ,0,0,0));
+      if (data)
+      {
+        size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+      }
+    }
+  }
+  unmap();
+  return false;
+}
+
+void SearchIdx::Private::unmap()
+{
+  if (data && buffer.empty()) UnmapViewOfFile(data);
+  if (mapping) CloseHandle(mapping);
+  if (file!=INVALID_HANDLE_VALUE) CloseHandle(file);
+  mapping = nullptr;
+  file    = INVALID_HANDLE_VALUE;
+  data    = nullptr;
+  size    = 0;
+  buffer.clear();
+}
+#else
+bool SearchIdx::Private::map(const std::string &fileName)
+{
+  int fd = ::open(fileName.c_str(),O_RDONLY);
+  if (fd==-1) return false;
+  struct stat st;
+  if (fstat(fd,&st)==0 && st.st_size>0)
+  {
+    void *ptr = mmap(nullptr,static_cast<size_t>(st.st_size),PROT_READ,MAP_SHARED,fd,0);
+    if (ptr!=MAP_FAILED)
+    {
+      mapped = ptr;
+      data   = static_cast<const unsigned char *>(ptr);
+      size   = static_cast<size_t>(st.st_size);
+    }
+  }
+  ::close(fd);
+  return data!=nullptr;
+}
+
+void SearchIdx::Private::unmap()
+{
+  if (mapped) munmap(mapped,size);
+  mapped = nullptr;
+  data   = nullptr;
+  size   = 0;
+  buffer.clear();
+}
+#endif
+
+/** Collects the hits of all indexed words that start with \a wh.word and
+ *  computes their rank in the same way as search.php does.
+ */
+void SearchIdx::Private::lookup(WordHits &wh) const
+{
+  const std::string &word = wh.word;
+  if (word.length()<2) return;
+  size_t idx = static_cast<unsigned char>(word[0])*256+static_cast<unsigned char>(word[1]);
+  size_t offset = readInt(headerSize+idx*4);
+  if (offset==0) return;
+
+  struct Stat { size_t offset; uint32_t multiplier; };
+  std::vector<Stat> stats;
+  for (;;)
+  {
+    std::string_view w = readString(offset);
+    if (w.empty()) break;
+    size_t statOffset = readInt(offset);
+    offset+=4;
+    if (w.compare(0,word.length(),word)==0) // indexed word starts with the query word
+    {
+      // whole word matches have a double weight
+      stats.push_back({ statOffset, w.length()==word.length() ? 2u : 1u });
+      wh.matches.push_back(w);
+    }
+  }
+
+  uint64_t totalHi=0, totalFreqHi=0, totalFreqLo=0;
+  for (uint32_t m=0; m<stats.size(); m++)
+  {
+    size_t statOffset = stats[m].offset;
+    size_t numDocs = std::min<size_t>(readInt(statOffset),(size-std::min(size,statOffset+4))/8);
+    const size_t first = wh.hits.size();
+    wh.hits.resize(first+numDocs);
+    for (size_t i=0; i<numDocs; i++)
+    {
+      size_t o = statOffset+4+i*8;
+      Hit &hit   = wh.hits[first+i];
+      hit.url      = readInt(o);
+      hit.freq     = readInt(o+4);
+      hit.matchIdx = m;
+      hit.rank     = 0.0;
+      if (hit.freq&1) // word occurs in high priority doc
+      {
+        totalHi++;
+        totalFreqHi+=static_cast<uint64_t>(hit.freq)*stats[m].multiplier;
+      }
+      else
+      {
+        totalFreqLo+=static_cast<uint64_t>(hit.freq)*stats[m].multiplier;
+      }
+    }
+  }
+  double totalFreq = static_cast<double>((totalHi+1)*totalFreqLo+totalFreqHi);
+  if (totalFreq<=0.0) totalFreq=1.0;
+  for (Hit &hit : wh.hits)
+  {
+    double f = static_cast<double>((hit.freq>>1)*stats[hit.matchIdx].multiplier);
+    hit.rank = (hit.freq&1) ? (f+static_cast<double>(totalFreqLo))/totalFreq : f/totalFreq;
+  }
+
+  // the posting lists are written in hash order, so sort the hits on document
+  std::stable_sort(wh.hits.begin(),wh.hits.end(),[](const Hit &h1,const Hit &h2) { return h1.url<h2.url; });
+  wh.docs.reserve(wh.hits.size());
+  for (const Hit &hit : wh.hits)
+  {
+    if (wh.docs.empty() || wh.docs.back()!=hit.url) wh.docs.push_back(hit.url);
+  }
+}
+
+//---------------------------------------------------------------------------
+
+SearchIdx::SearchIdx() : p(std::make_unique<Private>())
+{
+}
+
+SearchIdx::~SearchIdx()
+{
+  close();
+}
+
+bool SearchIdx::open(const std::string &fileName,std::string &errorMsg)
+{
+  close();
+  if (!p->map(fileName)) // fall back to reading the file into memory
+  {
+    std::ifstream f(fileName,std::ios::binary);
+    if (!f.is_open())
+    {
+      errorMsg = "cannot open search index file '"+fileName+"'";
+      return false;
+    }
+    p->buffer.assign(std::istreambuf_iterator<char>(f),std::istreambuf_iterator<char>());
+    p->data = p->buffer.data();
+    p->size = p->buffer.size();
+  }
+  if (p->size<headerSize+numIndexEntries*4 || memcmp(p->data,"DOXS",4)!=0)
+  {
+    errorMsg = "file '"+fileName+"' is not a valid search index";
+    close();
+    return false;
+  }
+  return true;
+}
+
+void SearchIdx::close()
+{
+  p->unmap();
+}
+
+bool SearchIdx::isOpen() const
+{
+  return p->data!=nullptr;
+}
+
+std::vector<SearchIdx::Result> SearchIdx::query(const std::string &queryString,size_t maxResults) const
+{
+  std::vector<Result> results;
+  if (!isOpen()) return results;
+
+  // split the query into words
+  std::vector<WordHits> words;
+  size_t i=0, len=queryString.length();
+  while (i<len)
+  {
+    while (i<len && queryString[i]==' ') i++;
+    size_t s=i;
+    while (i<len && queryString[i]!=' ') i++;
+    if (i==s) break;
+    std::string word = queryString.substr(s,i-s);
+    bool required=false, forbidden=false;
+    if (word[0]=='+') { word=word.substr(1); required=true; }
+    if (!word.empty() && word[0]=='-') { word=word.substr(1); forbidden=true; }
+    std::transform(word.begin(),word.end(),word.begin(),
+        [](unsigned char c) { return static_cast<char>(c>='A' && c<='Z' ? c+'a'-'A' : c); });
+    auto it = std::find_if(words.begin(),words.end(),[&word](const WordHits &wh) { return wh.word==word; });
+    if (it==words.end())
+    {
+      words.emplace_back();
+      it = words.end()-1;
+      it->word = word;
+    }
+    it->required  |= required;
+    it->forbidden |= forbidden;
+  }
+
+  bool hasRequired=false;
+  for (auto &wh : words)
+  {
+    p->lookup(wh);
+    hasRequired |= wh.required;
+  }
+
+  // documents that must contain all required words and none of the forbidden ones
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> excluded;
+  bool first=true;
+  for (const auto &wh : words)
+  {
+    if (wh.required)
+    {
+      candidates = first ? wh.docs : intersect(candidates,wh.docs);
+      first=false;
+    }
+    if (wh.forbidden)
+    {
+      excluded = merge(excluded,wh.docs);
+    }
+  }
+  if (hasRequired && candidates.empty()) return results;
+
+  std::vector<DocScore> docs;
+  std::unordered_map<uint32_t,size_t> docIndex;
+  for (size_t wi=0; wi<words.size(); wi++)
+  {
+    const auto &hits = words[wi].hits;
+    size_t ci=0, ei=0;
+    for (size_t hi=0; hi<hits.size(); hi++)
+    {
+      uint32_t url = hits[hi].url;
+      if (hasRequired)
+      {
+        while (ci<candidates.size() && candidates[ci]<url) ci++;
+        if (ci==candidates.size()) break;
+        if (candidates[ci]!=url) continue;
+      }
+      while (ei<excluded.size() && excluded[ei]<url) ei++;
+      if (ei<excluded.size() && excluded[ei]==url) continue;
+
+      auto it = docIndex.find(url);
+      if (it==docIndex.end())
+      {
+        it = docIndex.emplace(url,docs.size()).first;
+        docs.emplace_back();
+        docs.back().url = url;
+      }
+      DocScore &ds = docs[it->second];
+      ds.rank+=hits[hi].rank;
+      ds.hits.emplace_back(wi,hi);
+    }
+  }
+
+  auto higherRank = [](const DocScore &d1,const DocScore &d2)
+  {
+    return d1.rank!=d2.rank ? d1.rank>d2.rank : d1.url<d2.url;
+  };
+  if (maxResults>0 && maxResults<docs.size())
+  {
+    std::partial_sort(docs.begin(),docs.begin()+static_cast<std::ptrdiff_t>(maxResults),docs.end(),higherRank);
+    docs.resize(maxResults);
+  }
+  else
+  {
+    std::sort(docs.begin(),docs.end(),higherRank);
+  }
+
+  // only the documents that are returned need their name and url
+  results.reserve(docs.size());
+  for (const auto &ds : docs)
+  {
+    size_t offset = ds.url;
+    Result r;
+    r.name = std::string(p->readString(offset));
+    r.url  = std::string(p->readString(offset));
+    r.rank = ds.rank;
+    for (const auto &wh : ds.hits)
+    {
+      const WordHits &w = words[wh.first];
+      const Hit &hit    = w.hits[wh.second];
+      r.words.push_back({ w.word, std::string(w.matches[hit.matchIdx]), static_cast<int>(hit.freq>>1) });
+    }
+    results.push_back(std::move(r));
+  }
+  return results;
+}
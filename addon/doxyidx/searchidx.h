@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2024 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef SEARCHIDX_H
+#define SEARCHIDX_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/** @brief Read-only view on a \c search.idx file as written by SearchIndex::write().
+ *
+ *  The file is memory mapped when opened, so queries only touch the pages of
+ *  the words and documents they need. A single instance can be queried from
+ *  multiple threads concurrently.
+ *
+ *  The query syntax and ranking are the same as those of the \c search.php
+ *  script that doxygen generates for the server based search engine:
+ *  words are matched as prefixes of the indexed words, a word prefixed
+ *  with \c + must appear in every result and a word prefixed with \c - must
+ *  not appear in any result.
+ */
+class SearchIdx
+{
+  public:
+    /** A query word and the indexed word it matched in a document */
+    struct WordMatch
+    {
+      std::string word;   //!< the word as given in the query
+      std::string match;  //!< the indexed word it matched
+      int freq;           //!< number of occurrences in the document
+    };
+
+    /** A document found by a query */
+    struct Result
+    {
+      std::string name;   //!< the title of the document
+      std::string url;    //!< the url of the document relative to the HTML output
+      double rank;        //!< the relevance of the document (higher is better)
+      std::vector<WordMatch> words;
+    };
+
+    SearchIdx();
+   ~SearchIdx();
+    SearchIdx(const SearchIdx &) = delete;
+    SearchIdx &operator=(const SearchIdx &) = delete;
+
+    /** Maps the index file \a fileName. Returns \c false and sets \a errorMsg if
+     *  the file cannot be opened or is not a valid search index.
+     */
+    bool open(const std::string &fileName,std::string &errorMsg);
+
+    /** Unmaps the index file, if one is open. */
+    void close();
+
+    /** Returns \c true if an index file is open. */
+    bool isOpen() const;
+
+    /** Returns the documents matching \a queryString, sorted by decreasing rank.
+     *  If \a maxResults is non-zero at most that many results are returned.
+     */
+    std::vector<Result> query(const std::string &queryString,size_t maxResults=0) const;
+
+  private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -0,0 +1,443 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+
+#include "searchshards.h"
+
+// Layout of the compact search data, see writeCompactSearchDataPage() in searchindex_js.cpp:
+//
+//  <section>_<letter>.js      searchDataIndex('<page>',[[firstId,lastId],...]);
+//  <section>_<letter>_<n>.js  searchDataShard('<page>_<n>',[file,...],[scope,...],[entry,...]);
+//
+//  entry = [sharedPrefixLength,idSuffix,name,link1,link2,...]
+//  link  = fileIndex,anchor,target,scopeIndex (-1 if there is no scope)
+//
+// Ids are front-coded: the id of an entry is the first sharedPrefixLength UTF-16 code units
+// of the id of the previous entry in the shard, followed by idSuffix.
+
+namespace {
+
+/** A value of the JavaScript literals used in the search data */
+struct Value
+{
+  std::variant<long,std::string,std::vector<Value>> v;
+
+  bool isNumber() const { return std::holds_alternative<long>(v); }
+  bool isString() const { return std::holds_alternative<std::string>(v); }
+  bool isArray()  const { return std::holds_alternative<std::vector<Value>>(v); }
+  long number() const { return std::get<long>(v); }
+  const std::string &string() const { return std::get<std::string>(v); }
+  const std::vector<Value> &array() const { return std::get<std::vector<Value>>(v); }
+};
+
+/** Parser for a call with literal arguments, like name('a',[1,2]); */
+class LiteralParser
+{
+  public:
+    explicit LiteralParser(std::string_view s) : m_s(s) {}
+
+    /** Parses a call of \a function and stores its arguments in \a args */
+    bool parseCall(const std::string &function,std::vector<Value> &args)
+    {
+      skipSpace();
+      if (m_s.compare(m_pos,function.size(),function)!=0) return false;
+      m_pos+=function.size();
+      if (!expect('(')) return false;
+      skipSpace();
+      if (peek()==')') { m_pos++; return true; }
+      for (;;)
+      {
+        Value val;
+        if (!parseValue(val)) return false;
+        args.push_back(std::move(val));
+        skipSpace();
+        char c = get();
+        if (c==')') return true;
+        if (c!=',') return false;
+      }
+    }
+
+  private:
+    char peek() const { return m_pos<m_s.size() ? m_s[m_pos] : 0; }
+    char get() { return m_pos<m_s.size() ? m_s[m_pos++] : 0; }
+    void skipSpace() { while (m_pos<m_s.size() && isspace(static_cast<unsigned char>(m_s[m_pos]))) m_pos++; }
+    bool expect(char c) { skipSpace(); return get()==c; }
+
+    bool parseValue(Value &val)
+    {
+      skipSpace();
+      char c = peek();
+      if (c=='\'') return parseString(val);
+      if (c=='[') return parseArray(val);
+      if (c=='-' || isdigit(static_cast<unsigned char>(c))) return parseNumber(val);
+      return false;
+    }
+
+    bool parseNumber(Value &val)
+    {
+      size_t start = m_pos;
+      if (peek()=='-') m_pos++;
+      while (isdigit(static_cast<unsigned char>(peek()))) m_pos++;
+      if (m_pos==start || (m_pos==start+1 && m_s[start]=='-')) return false;
+      val.v = std::stol(std::string(m_s.substr(start,m_pos-start)));
+      return true;
+    }
+
+    bool parseArray(Value &val)
+    {
+      m_pos++; // [
+      std::vector<Value> items;
+      skipSpace();
+      if (peek()==']') { m_pos++; val.v = std::move(items); return true; }
+      for (;;)
+      {
+        Value item;
+        if (!parseValue(item)) return false;
+        items.push_back(std::move(item));
+        skipSpace();
+        char c = get();
+        if (c==']') break;
+        if (c!=',') return false;
+      }
+      val.v = std::move(items);
+      return true;
+    }
+
+    //! parses a single quoted string with the escapes produced by convertToJSString()
+    bool parseString(Value &val)
+    {
+      m_pos++; // '
+      std::string result;
+      for (;;)
+      {
+        if (m_pos>=m_s.size()) return false;
+        char c = m_s[m_pos++];
+        if (c=='\'') break;
+        if (c!='\\') { result+=c; continue; }
+        if (m_pos>=m_s.size()) return false;
+        c = m_s[m_pos++];
+        if (c=='u' && peek()=='{') // \u{hex} code point
+        {
+          size_t end = m_s.find('}',m_pos);
+          if (end==std::string_view::npos) return false;
+          unsigned long cp = std::stoul(std::string(m_s.substr(m_pos+1,end-m_pos-1)),nullptr,16);
+          m_pos = end+1;
+          appendUTF8(result,cp);
+        }
+        else
+        {
+          result+=c;
+        }
+      }
+      val.v = std::move(result);
+      return true;
+    }
+
+    static void appendUTF8(std::string &s,unsigned long cp)
+    {
+      if (cp<0x80)         { s+=static_cast<char>(cp); }
+      else if (cp<0x800)   { s+=static_cast<char>(0xC0|(cp>>6));  s+=static_cast<char>(0x80|(cp&0x3F)); }
+      else if (cp<0x10000) { s+=static_cast<char>(0xE0|(cp>>12)); s+=static_cast<char>(0x80|((cp>>6)&0x3F));
+                             s+=static_cast<char>(0x80|(cp&0x3F)); }
+      else                 { s+=static_cast<char>(0xF0|(cp>>18)); s+=static_cast<char>(0x80|((cp>>12)&0x3F));
+                             s+=static_cast<char>(0x80|((cp>>6)&0x3F)); s+=static_cast<char>(0x80|(cp&0x3F)); }
+    }
+
+    std::string_view m_s;
+    size_t m_pos = 0;
+};
+
+//! returns the number of bytes of the first \a units UTF-16 code units of UTF-8 string \a s
+size_t utf16UnitsToBytes(const std::string &s,size_t units)
+{
+  size_t i=0;
+  while (i<s.size() && units>0)
+  {
+    unsigned char c = static_cast<unsigned char>(s[i]);
+    size_t len = c<0x80 ? 1 : (c&0xE0)==0xC0 ? 2 : (c&0xF0)==0xE0 ? 3 : 4;
+    size_t n   = len==4 ? 2 : 1; // 4 byte sequences are a surrogate pair in UTF-16
+    if (n>units) break;
+    units-=n;
+    i+=len;
+  }
+  return std::min(i,s.size());
+}
+
+//! converts the search text into an id, like convertToId() in search.js
+std::string convertToId(const std::string &text)
+{
+  std::string result;
+  size_t end = text.find_last_not_of(' ');
+  for (size_t i=0; end!=std::string::npos && i<=end; i++)
+  {
+    unsigned char c = static_cast<unsigned char>(tolower(static_cast<unsigned char>(text[i])));
+    if ((c>='a' && c<='z') || (c>='0' && c<='9') || c>=0x80)
+    {
+      result+=static_cast<char>(c);
+    }
+    else
+    {
+      char buf[8];
+      snprintf(buf,sizeof(buf),"_%02x",c);
+      result+=buf;
+    }
+  }
+  return result;
+}
+
+bool readFile(const std::filesystem::path &path,std::string &contents)
+{
+  std::ifstream f(path,std::ios::binary);
+  if (!f.is_open()) return false;
+  std::ostringstream ss;
+  ss << f.rdbuf();
+  contents = ss.str();
+  return true;
+}
+
+std::string lower(std::string s)
+{
+  std::transform(s.begin(),s.end(),s.begin(),[](unsigned char c) { return static_cast<char>(tolower(c)); });
+  return s;
+}
+
+} // namespace
+
+struct SearchShards::Private
+{
+  struct Range
+  {
+    std::string firstId;
+    std::string lastId;
+  };
+  std::filesystem::path dir;
+  std::map<std::string,std::vector<Range>> pages; // page name -> id range per shard
+  std::unordered_map<std::string,std::vector<Entry>> cache; // shard name -> entries
+
+  bool loadShard(const std::string &shardName,std::vector<Entry> &entries,size_t &bytes,std::string &errorMsg) const
+  {
+    std::string contents;
+    std::filesystem::path path = dir / (shardName+".js");
+    if (!readFile(path,contents))
+    {
+      errorMsg = "could not read shard "+path.string();
+      return false;
+    }
+    bytes += contents.size();
+    std::vector<Value> args;
+    LiteralParser parser(contents);
+    if (!parser.parseCall("searchDataShard",args) || args.size()!=4 ||
+        !args[0].isString() || !args[1].isArray() || !args[2].isArray() || !args[3].isArray())
+    {
+      errorMsg = "shard "+path.string()+" is not valid";
+      return false;
+    }
+    const auto &files  = args[1].array();
+    const auto &scopes = args[2].array();
+    std::string id;
+    for (const auto &e : args[3].array())
+    {
+      const auto *fields = e.isArray() ? &e.array() : nullptr;
+      if (fields==nullptr || fields->size()<3 || (fields->size()-3)%4!=0 ||
+          !(*fields)[0].isNumber() || !(*fields)[1].isString() || !(*fields)[2].isString())
+      {
+        errorMsg = "shard "+path.string()+" has an invalid entry";
+        return false;
+      }
+      Entry entry;
+      id = id.substr(0,utf16UnitsToBytes(id,static_cast<size_t>((*fields)[0].number())))+(*fields)[1].string();
+      entry.id   = id;
+      entry.name = (*fields)[2].string();
+      for (size_t i=3; i<fields->size(); i+=4)
+      {
+        const Value &file = (*fields)[i], &anchor = (*fields)[i+1], &target = (*fields)[i+2], &scope = (*fields)[i+3];
+        if (!file.isNumber() || file.number()<0 || static_cast<size_t>(file.number())>=files.size() ||
+            !files[static_cast<size_t>(file.number())].isString() || !anchor.isString() || !target.isNumber() ||
+            !scope.isNumber() || scope.number()<-1 || scope.number()>=static_cast<long>(scopes.size()))
+        {
+          errorMsg = "shard "+path.string()+" has an invalid link for entry '"+entry.id+"'";
+          return false;
+        }
+        Link link;
+        link.url = files[static_cast<size_t>(file.number())].string();
+        if (!anchor.string().empty()) link.url += "#"+anchor.string();
+        link.parentTarget = target.number()!=0;
+        if (scope.number()>=0)
+        {
+          const Value &s = scopes[static_cast<size_t>(scope.number())];
+          if (!s.isString())
+          {
+            errorMsg = "shard "+path.string()+" has an invalid scope table";
+            return false;
+          }
+          link.hasScope = true;
+          link.scope = s.string();
+        }
+        entry.links.push_back(std::move(link));
+      }
+      entries.push_back(std::move(entry));
+    }
+    return true;
+  }
+};
+
+SearchShards::SearchShards() : p(std::make_unique<Private>())
+{
+}
+
+SearchShards::~SearchShards() = default;
+
+bool SearchShards::open(const std::string &searchDir,std::string &errorMsg)
+{
+  p->dir = searchDir;
+  p->pages.clear();
+  p->cache.clear();
+  std::error_code ec;
+  for (const auto &de : std::filesystem::directory_iterator(p->dir,ec))
+  {
+    if (!de.is_regular_file() || de.path().extension()!=".js") continue;
+    std::string contents;
+    if (!readFile(de.path(),contents) || contents.compare(0,15,"searchDataIndex")!=0) continue;
+    std::vector<Value> args;
+    LiteralParser parser(contents);
+    if (!parser.parseCall("searchDataIndex",args) || args.size()!=2 || !args[0].isString() || !args[1].isArray())
+    {
+      errorMsg = "index file "+de.path().string()+" is not valid";
+      return false;
+    }
+    std::vector<Private::Range> ranges;
+    for (const auto &r : args[1].array())
+    {
+      if (!r.isArray() || r.array().size()!=2 || !r.array()[0].isString() || !r.array()[1].isString())
+      {
+        errorMsg = "index file "+de.path().string()+" has an invalid id range";
+        return false;
+      }
+      ranges.push_back({ r.array()[0].string(), r.array()[1].string() });
+    }
+    p->pages.emplace(args[0].string(),std::move(ranges));
+  }
+  if (ec)
+  {
+    errorMsg = "could not read directory "+searchDir+": "+ec.message();
+    return false;
+  }
+  if (p->pages.empty())
+  {
+    errorMsg = "no compact search data found in "+searchDir+", was COMPACT_SEARCH_INDEX enabled?";
+    return false;
+  }
+  return true;
+}
+
+std::vector<SearchShards::Entry> SearchShards::query(const std::string &section,const std::string &text,size_t &shardsLoaded)
+{
+  std::vector<Entry> results;
+  std::string searchId = convertToId(text);
+  if (searchId.empty()) return results;
+  // like search.js only compare the id ranges for ASCII input
+  bool exact = std::all_of(searchId.begin(),searchId.end(),[](unsigned char c) { return c<0x80; });
+  std::string prefix = section+"_";
+  for (auto it = p->pages.lower_bound(prefix); it!=p->pages.end() && it->first.compare(0,prefix.size(),prefix)==0; ++it)
+  {
+    const std::string &page = it->first;
+    // skip the pages of other sections that start with the same name, e.g. "all_0" vs "all_0_1"
+    if (page.find('_',prefix.size())!=std::string::npos) continue;
+    for (size_t i=0; i<it->second.size(); i++)
+    {
+      const auto &range = it->second[i];
+      if (exact && (range.firstId.compare(0,searchId.size(),searchId)>0 || range.lastId<searchId)) continue;
+      char suffix[20];
+      snprintf(suffix,sizeof(suffix),"_%zx",i);
+      std::string shardName = page+suffix;
+      auto cit = p->cache.find(shardName);
+      if (cit==p->cache.end())
+      {
+        std::vector<Entry> entries;
+        size_t bytes=0;
+        std::string errorMsg;
+        if (!p->loadShard(shardName,entries,bytes,errorMsg)) continue;
+        shardsLoaded++;
+        cit = p->cache.emplace(shardName,std::move(entries)).first;
+      }
+      for (const auto &entry : cit->second)
+      {
+        if (lower(entry.id).compare(0,searchId.size(),searchId)==0) results.push_back(entry);
+      }
+    }
+  }
+  return results;
+}
+
+bool SearchShards::check(Stats &stats,std::string &errorMsg)
+{
+  stats = Stats();
+  std::error_code ec;
+  for (const auto &de : std::filesystem::directory_iterator(p->dir,ec))
+  {
+    if (de.is_regular_file() && de.path().extension()==".js" && p->pages.count(de.path().stem().string()))
+    {
+      stats.bytes += static_cast<size_t>(de.file_size(ec));
+    }
+  }
+  for (const auto &[page,ranges] : p->pages)
+  {
+    stats.pages++;
+    for (size_t i=0; i<ranges.size(); i++)
+    {
+      char suffix[20];
+      snprintf(suffix,sizeof(suffix),"_%zx",i);
+      std::vector<Entry> entries;
+      if (!p->loadShard(page+suffix,entries,stats.bytes,errorMsg)) return false;
+      if (entries.empty())
+      {
+        errorMsg = "shard "+page+suffix+" is empty";
+        return false;
+      }
+      for (const auto &entry : entries)
+      {
+        if (entry.id<ranges[i].firstId || entry.id>ranges[i].lastId)
+        {
+          errorMsg = "id '"+entry.id+"' of shard "+page+suffix+" is outside the range ['"+
+                     ranges[i].firstId+"','"+ranges[i].lastId+"'] of the index";
+          return false;
+        }
+        if (entry.links.empty())
+        {
+          errorMsg = "entry '"+entry.id+"' of shard "+page+suffix+" has no links";
+          return false;
+        }
+        stats.links += entry.links.size();
+      }
+      stats.shards++;
+      stats.entries += entries.size();
+    }
+  }
+  return true;
+}
+
+void SearchShards::clearCache()
+{
+  p->cache.clear();
+}
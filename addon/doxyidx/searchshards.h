@@ -0,0 +1,94 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef SEARCHSHARDS_H
+#define SEARCHSHARDS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/** @brief Reader for the compact JavaScript search data written with
+ *  COMPACT_SEARCH_INDEX enabled.
+ *
+ *  The search directory holds one index file per section and starting letter,
+ *  listing the id range of each of its shards, and the shard files themselves.
+ *  Like search.js, a query only loads the shards whose id range can contain
+ *  the searched prefix. Loaded shards are cached until clearCache() is called.
+ *
+ *  An instance must not be used from multiple threads concurrently.
+ */
+class SearchShards
+{
+  public:
+    /** A link of an entry, as used by search.js */
+    struct Link
+    {
+      std::string url;           //!< url relative to the HTML output, including the anchor
+      bool parentTarget = true;  //!< true if the link opens in the parent window
+      bool hasScope = false;     //!< false if no scope is shown
+      std::string scope;         //!< scope shown with the link
+    };
+
+    /** An entry of the search data */
+    struct Entry
+    {
+      std::string id;            //!< id used for matching the search text
+      std::string name;          //!< name as shown
+      std::vector<Link> links;
+    };
+
+    /** Totals found by check() */
+    struct Stats
+    {
+      size_t pages = 0;          //!< number of index files
+      size_t shards = 0;         //!< number of shard files
+      size_t entries = 0;        //!< number of entries in all shards
+      size_t links = 0;          //!< number of links in all entries
+      size_t bytes = 0;          //!< size of the index and shard files
+    };
+
+    SearchShards();
+   ~SearchShards();
+    SearchShards(const SearchShards &) = delete;
+    SearchShards &operator=(const SearchShards &) = delete;
+
+    /** Reads the index files in \a searchDir. Returns \c false and sets \a errorMsg
+     *  if the directory cannot be read or contains no compact search data.
+     */
+    bool open(const std::string &searchDir,std::string &errorMsg);
+
+    /** Returns the entries of section \a section (e.g. "all" or "classes") whose
+     *  id starts with the id of \a text, in the same way as search.js matches them.
+     *  Unlike search.js only ASCII letters are folded to lower case.
+     *  The number of shards that had to be read from disk is added to \a shardsLoaded.
+     */
+    std::vector<Entry> query(const std::string &section,const std::string &text,size_t &shardsLoaded);
+
+    /** Reads all shards and checks that they are well formed and that their ids are
+     *  within the range listed in the index. Returns \c false and sets \a errorMsg
+     *  for the first problem found.
+     */
+    bool check(Stats &stats,std::string &errorMsg);
+
+    /** Forgets the shards loaded so far */
+    void clearCache();
+
+  private:
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
@@ -24,6 +24,18 @@
 #include <regex>
 #include <filesystem>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
 
 
 // Xapian include
@@ -139,40 +151,154 @@ static std::string unescapeXmlEntities(const std::string &s)
   return result;
 }
 
+enum FieldNames
+{
+  UnknownField = 0,
+  TypeField    = 1,
+  NameField    = 2,
+  ArgsField    = 3,
+  TagField     = 4,
+  UrlField     = 5,
+  KeywordField = 6,
+  TextField    = 7,
+  HashField    = 8,  //!< not part of the input: hash of the content used for incremental updates
+  OrdinalField = 9   //!< not part of the input: number of earlier documents in the same file with the same identity
+};
+
+/** The fields of a single `<doc>` element as found in the search data,
+ *  in the order in which they appeared.
+ */
+using RawDocument = std::vector< std::pair<FieldNames,std::string> >;
+
+/** Position of a batch of documents in the input, used to write the batches
+ *  in input order whatever the order in which the threads produce them.
+ */
+struct BatchPosition
+{
+  size_t file  = 0;     //!< index of the input file
+  size_t index = 0;     //!< index of the batch within the file
+  bool   last  = false; //!< this is the last batch of the file
+};
+
+struct RawBatch
+{
+  BatchPosition pos;
+  std::vector<RawDocument> docs;
+};
+
+/** A document ready to be added to the database */
+struct IndexDocument
+{
+  Xapian::Document doc;
+  std::string      idTerm;   //!< unique term identifying the document across runs
+  std::string      tagTerm;  //!< term identifying the project the document belongs to
+  std::string      hash;     //!< hash of the document's content
+};
+
+struct DocBatch
+{
+  BatchPosition pos;
+  std::vector<IndexDocument> docs;
+};
+
+/** Simple blocking queue with a maximum size, used to pass batches of documents
+ *  between the parser, builder and writer threads.
+ */
+template<class T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(size_t maxSize) : m_maxSize(maxSize) {}
+
+    /** Adds \a item to the queue, waiting while the queue is full.
+     *  Items pushed after close() has been called are dropped.
+     */
+    void push(T &&item)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_notFull.wait(lock,[this]() { return m_closed || m_items.size()<m_maxSize; });
+      if (m_closed) return;
+      m_items.push_back(std::move(item));
+      m_notEmpty.notify_one();
+    }
+
+    /** Takes the next item from the queue, waiting while the queue is empty.
+     *  Returns false if the queue is closed and no items are left.
+     */
+    bool pop(T &item)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_notEmpty.wait(lock,[this]() { return m_closed || !m_items.empty(); });
+      if (m_items.empty()) return false;
+      item = std::move(m_items.front());
+      m_items.pop_front();
+      m_notFull.notify_one();
+      return true;
+    }
+
+    void close()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_closed = true;
+      m_notEmpty.notify_all();
+      m_notFull.notify_all();
+    }
+
+  private:
+    size_t m_maxSize;
+    bool m_closed = false;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<T> m_items;
+};
+
+/** Joins a set of threads when it goes out of scope, after calling \a stop to make
+ *  them finish. Created before the first thread is started, so the threads are
+ *  also joined when starting one of them fails.
+ */
+class ThreadJoiner
+{
+  public:
+    ThreadJoiner(std::vector<std::thread> &threads,const std::function<void()> &stop)
+      : m_threads(threads), m_stop(stop) {}
+   ~ThreadJoiner()
+    {
+      m_stop();
+      for (auto &t : m_threads)
+      {
+        if (t.joinable()) t.join();
+      }
+    }
+    ThreadJoiner(const ThreadJoiner &) = delete;
+    ThreadJoiner &operator=(const ThreadJoiner &) = delete;
+
+  private:
+    std::vector<std::thread> &m_threads;
+    std::function<void()> m_stop;
+};
+
 /** This class is a wrapper around SAX style XML parser, which
  *  parses the file without first building a DOM tree in memory.
+ *  The documents found are passed in batches to the \a output queue.
  */
 class XMLContentHandler
 {
   public:
-    /** Handler for parsing XML data */
-    XMLContentHandler(const std::string &path)
-      : m_db(path+"doxysearch.db",Xapian::DB_CREATE_OR_OVERWRITE),
-        m_stemmer("english")
+    /** Handler for parsing the XML data of input file number \a fileIndex */
+    XMLContentHandler(BoundedQueue<RawBatch> &output,size_t batchSize,size_t fileIndex)
+      : m_output(output), m_batchSize(batchSize)
     {
       m_curFieldName = UnknownField;
-      m_indexer.set_stemmer(m_stemmer);
-      m_indexer.set_document(m_doc);
+      m_batch.pos.file = fileIndex;
     }
 
-    /** Free data handler */
+    /** Passes on the remaining documents, also when there are none, to mark the end of the file */
    ~XMLContentHandler()
     {
-      m_db.commit();
+      flush(true);
     }
 
-    enum FieldNames
-    {
-      UnknownField = 0,
-      TypeField    = 1,
-      NameField    = 2,
-      ArgsField    = 3,
-      TagField     = 4,
-      UrlField     = 5,
-      KeywordField = 6,
-      TextField    = 7
-    };
-
     /** Handler for a start tag. Called for `<doc>` and `<field>` tags */
     void startElement(const std::string &name, const XMLHandlers::Attributes &attrib)
     {
@@ -199,34 +325,23 @@ class XMLContentHandler
     {
       if (name=="doc") // </doc>
       {
-        std::string term = m_doc.get_value(NameField);
-        std::string partTerm;
-        size_t pos = term.rfind("::");
-        if (pos!=std::string::npos)
-        {
-          partTerm = term.substr(pos+2);
-        }
-        if (m_doc.get_value(TypeField)=="class" ||
-            m_doc.get_value(TypeField)=="file" ||
-            m_doc.get_value(TypeField)=="namespace") // containers get highest prio
+        // documents with identical identifying fields are told apart by their order in the file
+        std::string identity;
+        for (const auto &[field,data] : m_doc)
         {
-          safeAddTerm(term,m_doc,1000);
-          if (!partTerm.empty())
+          if (field==TagField || field==UrlField || field==NameField || field==ArgsField)
           {
-            safeAddTerm(partTerm,m_doc,500);
+            identity += std::to_string(field) + '=' + data + '\t';
           }
         }
-        else // members and others get lower prio
+        size_t ordinal = m_identities[identity]++;
+        if (ordinal>0) m_doc.emplace_back(OrdinalField,std::to_string(ordinal));
+        m_batch.docs.push_back(std::move(m_doc));
+        m_doc.clear();
+        if (m_batch.docs.size()>=m_batchSize)
         {
-          safeAddTerm(m_doc.get_value(NameField),m_doc,100);
-          if (!partTerm.empty())
-          {
-            safeAddTerm(partTerm,m_doc,50);
-          }
+          flush(false);
         }
-        m_db.add_document(m_doc);
-        m_doc.clear_values();
-        m_doc.clear_terms();
       }
       else if (name=="field" && m_curFieldName!=UnknownField) // </field>
       {
@@ -234,28 +349,7 @@ class XMLContentHandler
         m_data = reduce(m_data);
         // replace XML entities
         m_data = unescapeXmlEntities(m_data);
-        // add data to the document
-        m_doc.add_value(m_curFieldName,m_data);
-        switch (m_curFieldName)
-        {
-          case TypeField:
-          case NameField:
-          case TagField:
-          case UrlField:
-            // meta data that is not searchable
-            break;
-          case KeywordField:
-            addWords(m_data,m_doc,50);
-            break;
-          case ArgsField:
-            addIdentifiers(m_data,m_doc,10);
-            break;
-          case TextField:
-            addWords(m_data,m_doc,2);
-            break;
-          default:
-            break;
-        }
+        m_doc.emplace_back(m_curFieldName,m_data);
         m_data="";
         m_curFieldName=UnknownField;
       }
@@ -271,22 +365,228 @@ class XMLContentHandler
     void error(const std::string &fileName,int lineNr,const std::string &msg)
     {
       std::cerr << "Fatal error at " << fileName << ":" << lineNr << ": " << msg << std::endl;
+      m_failed = true;
     }
 
+    bool failed() const { return m_failed; }
+
   private:
+    void flush(bool last)
+    {
+      if (!m_batch.docs.empty() || last)
+      {
+        BatchPosition pos = m_batch.pos;
+        m_batch.pos.last = last;
+        m_output.push(std::move(m_batch));
+        m_batch.docs.clear();
+        m_batch.pos = pos;
+        m_batch.pos.index++;
+      }
+    }
 
     // internal state
-    Xapian::WritableDatabase m_db;
-    Xapian::Document m_doc;
-    Xapian::TermGenerator m_indexer;
-    Xapian::Stem m_stemmer;
+    BoundedQueue<RawBatch> &m_output;
+    size_t m_batchSize;
+    RawBatch m_batch;
+    RawDocument m_doc;
     std::string m_data;
     FieldNames m_curFieldName;
+    std::unordered_map<std::string,size_t> m_identities;
+    bool m_failed = false;
+};
+
+/** Returns a 64-bit FNV-1a hash of \a s as a hexadecimal string.
+ *  The result is stored in the database, so it must be the same for every build.
+ */
+static std::string stableHash(const std::string &s)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (unsigned char c : s)
+  {
+    h ^= c;
+    h *= 1099511628211ULL;
+  }
+  char buf[17];
+  snprintf(buf,sizeof(buf),"%016llx",static_cast<unsigned long long>(h));
+  return buf;
+}
+
+/** Turns the raw fields of a document into a Xapian document with its terms */
+static IndexDocument buildDocument(const RawDocument &raw)
+{
+  IndexDocument result;
+  Xapian::Document &doc = result.doc;
+  std::string content;
+  std::string ordinal;
+  for (const auto &[field,data] : raw)
+  {
+    if (field==OrdinalField)
+    {
+      ordinal = data;
+      continue;
+    }
+    // add data to the document
+    doc.add_value(field,data);
+    content += std::to_string(field) + '=' + data + '\n';
+    switch (field)
+    {
+      case TypeField:
+      case NameField:
+      case TagField:
+      case UrlField:
+        // meta data that is not searchable
+        break;
+      case KeywordField:
+        addWords(data,doc,50);
+        break;
+      case ArgsField:
+        addIdentifiers(data,doc,10);
+        break;
+      case TextField:
+        addWords(data,doc,2);
+        break;
+      default:
+        break;
+    }
+  }
+
+  std::string term = doc.get_value(NameField);
+  std::string partTerm;
+  size_t pos = term.rfind("::");
+  if (pos!=std::string::npos)
+  {
+    partTerm = term.substr(pos+2);
+  }
+  if (doc.get_value(TypeField)=="class" ||
+      doc.get_value(TypeField)=="file" ||
+      doc.get_value(TypeField)=="namespace") // containers get highest prio
+  {
+    safeAddTerm(term,doc,1000);
+    if (!partTerm.empty())
+    {
+      safeAddTerm(partTerm,doc,500);
+    }
+  }
+  else // members and others get lower prio
+  {
+    safeAddTerm(doc.get_value(NameField),doc,100);
+    if (!partTerm.empty())
+    {
+      safeAddTerm(partTerm,doc,50);
+    }
+  }
+
+  // identify the document by its project, location and name, so an updated
+  // version of the same symbol replaces the old one in incremental mode.
+  std::string tag = doc.get_value(TagField);
+  result.idTerm  = "Q"+stableHash(tag+'\t'+doc.get_value(UrlField)+'\t'+
+                                  doc.get_value(NameField)+'\t'+doc.get_value(ArgsField)+'\t'+ordinal);
+  result.tagTerm = "XTAG"+stableHash(tag);
+  result.hash    = stableHash(content);
+  doc.add_boolean_term(result.idTerm);
+  doc.add_boolean_term(result.tagTerm);
+  doc.add_value(HashField,result.hash);
+  return result;
+}
+
+/** Writes documents to the search database. In update mode only documents that
+ *  are new or whose content changed are written, and documents of the same projects
+ *  that are no longer present in the input are removed at the end.
+ */
+class IndexWriter
+{
+  public:
+    IndexWriter(const std::string &path,bool update,size_t commitInterval)
+      : m_db(path+"doxysearch.db",update ? Xapian::DB_CREATE_OR_OPEN : Xapian::DB_CREATE_OR_OVERWRITE),
+        m_update(update), m_commitInterval(commitInterval)
+    {
+      // an index written by an older version has no document identities, so it cannot be updated
+      if (m_update && m_db.get_doccount()>0 && m_db.get_metadata(formatKey)!=formatVersion)
+      {
+        std::cout << "Existing index does not support updates, rebuilding it" << std::endl;
+        m_db.close();
+        m_db = Xapian::WritableDatabase(path+"doxysearch.db",Xapian::DB_CREATE_OR_OVERWRITE);
+        m_update = false;
+      }
+      m_db.set_metadata(formatKey,formatVersion);
+    }
+
+    void write(DocBatch &batch)
+    {
+      for (auto &d : batch.docs)
+      {
+        if (m_update)
+        {
+          m_tagTerms.insert(d.tagTerm);
+          Xapian::PostingIterator pit = m_db.postlist_begin(d.idTerm);
+          if (pit!=m_db.postlist_end(d.idTerm) && m_db.get_document(*pit).get_value(HashField)==d.hash)
+          {
+            m_seen.insert(*pit);
+            m_unchanged++;
+            continue;
+          }
+          m_seen.insert(m_db.replace_document(d.idTerm,d.doc));
+        }
+        else
+        {
+          m_db.add_document(d.doc);
+        }
+        m_written++;
+        if (++m_pending>=m_commitInterval)
+        {
+          m_db.commit();
+          m_pending=0;
+        }
+      }
+    }
+
+    void finish()
+    {
+      size_t removed=0;
+      if (m_update) // remove documents of the indexed projects that were not seen in this run
+      {
+        std::vector<Xapian::docid> stale;
+        for (const auto &tagTerm : m_tagTerms)
+        {
+          for (Xapian::PostingIterator pit = m_db.postlist_begin(tagTerm); pit!=m_db.postlist_end(tagTerm); ++pit)
+          {
+            if (m_seen.find(*pit)==m_seen.end()) stale.push_back(*pit);
+          }
+        }
+        for (auto id : stale)
+        {
+          m_db.delete_document(id);
+        }
+        removed = stale.size();
+      }
+      m_db.commit();
+      if (m_update)
+      {
+        std::cout << "Updated index: " << m_written << " documents written, " << m_unchanged
+                  << " unchanged, " << removed << " removed" << std::endl;
+      }
+    }
+
+  private:
+    static constexpr const char *formatKey     = "doxyindexer.format";
+    static constexpr const char *formatVersion = "1"; // documents have id and project terms
+    Xapian::WritableDatabase m_db;
+    bool m_update;
+    size_t m_commitInterval;
+    size_t m_pending = 0;
+    size_t m_written = 0;
+    size_t m_unchanged = 0;
+    std::unordered_set<Xapian::docid> m_seen;
+    std::unordered_set<std::string> m_tagTerms;
 };
 
 static void usage(const char *name, int exitVal = 1)
 {
-  std::cerr << "Usage: " << name << " [-o output_dir] searchdata.xml [searchdata2.xml ...]" << std::endl;
+  std::cerr << "Usage: " << name << " [-o output_dir] [-u] [-j threads] [-b commit_interval] searchdata.xml [searchdata2.xml ...]" << std::endl;
+  std::cerr << "  -u  update an existing index: only documents that changed are written" << std::endl;
+  std::cerr << "      and documents no longer present in the search data are removed" << std::endl;
+  std::cerr << "  -j  number of threads used for parsing and indexing (default: number of cores)" << std::endl;
+  std::cerr << "  -b  number of documents after which the changes are committed (default: 100000)" << std::endl;
   exit(exitVal);
 }
 
@@ -311,6 +611,24 @@ bool dirExists(const char *path)
   return std::filesystem::is_directory(path, ec);
 }
 
+/** Returns the value of option \a arg at argv[i+1] as a positive number */
+static size_t numberArgument(int &i,int argc,const char **argv,const std::string &arg)
+{
+  if (i>=argc-1)
+  {
+    std::cerr << "Error: missing parameter for " << arg << " option" << std::endl;
+    usage(argv[0]);
+  }
+  i++;
+  int value = atoi(argv[i]);
+  if (value<1)
+  {
+    std::cerr << "Error: invalid value " << argv[i] << " for " << arg << " option" << std::endl;
+    usage(argv[0]);
+  }
+  return static_cast<size_t>(value);
+}
+
 /** main function to index data */
 int main(int argc,const char **argv)
 {
@@ -319,6 +637,10 @@ int main(int argc,const char **argv)
     usage(argv[0]);
   }
   std::string outputDir;
+  std::vector<std::string> inputFiles;
+  bool update = false;
+  size_t numThreads = std::max(1u,std::thread::hardware_concurrency());
+  size_t commitInterval = 100000;
   for (int i=1;i<argc;i++)
   {
     const std::string arg{ argv[i] };
@@ -340,6 +662,18 @@ int main(int argc,const char **argv)
         }
       }
     }
+    else if (arg == "-u")
+    {
+      update = true;
+    }
+    else if (arg == "-j")
+    {
+      numThreads = numberArgument(i,argc,argv,arg);
+    }
+    else if (arg == "-b")
+    {
+      commitInterval = numberArgument(i,argc,argv,arg);
+    }
     else if (arg == "-h" || arg == "--help")
     {
       usage(argv[0],0);
@@ -349,43 +683,163 @@ int main(int argc,const char **argv)
       std::cerr << argv[0] << " version: " << getFullVersion() << std::endl;
       exit(0);
     }
+    else
+    {
+      inputFiles.push_back(arg);
+    }
   }
 
+  // The input files are parsed in parallel and the documents found are passed in batches
+  // to a set of builder threads that generate the terms. The resulting documents are written
+  // to the database by the main thread, as a Xapian database only supports a single writer.
+  const size_t batchSize = 1000;
+  BoundedQueue<RawBatch> rawQueue(2*numThreads);
+  BoundedQueue<DocBatch> docQueue(2*numThreads);
+  std::mutex outputMutex;
+  std::atomic<size_t> nextFile{0};
+  std::atomic<bool> aborted{false};
+  std::atomic<bool> parseFailed{false};
+  std::atomic<size_t> activeParsers{0};
+  std::atomic<size_t> activeBuilders{0};
+  // an exception in a worker thread stops the pipeline and is rethrown on the main thread
+  std::exception_ptr threadError;
+  auto abortPipeline = [&]()
+  {
+    aborted = true;
+    rawQueue.close();
+    docQueue.close();
+  };
+  auto guarded = [&](const std::function<void()> &body)
+  {
+    try
+    {
+      body();
+    }
+    catch (...)
+    {
+      {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (!threadError) threadError = std::current_exception();
+      }
+      abortPipeline();
+    }
+  };
+
+  int result = 0;
   try
   {
     if (!outputDir.empty() && outputDir.at(outputDir.length()-1)!=pathSep)
     {
       outputDir+=pathSep;
     }
-    XMLContentHandler contentHandler(outputDir);
-    XMLHandlers handlers;
-    handlers.startElement = [&contentHandler](const std::string &name,const XMLHandlers::Attributes &attrs)  { contentHandler.startElement(name,attrs);   };
-    handlers.endElement   = [&contentHandler](const std::string &name)                                       { contentHandler.endElement(name);           };
-    handlers.characters   = [&contentHandler](const std::string &chars)                                      { contentHandler.characters(chars);          };
-    handlers.error        = [&contentHandler](const std::string &fileName,int lineNr,const std::string &msg) { contentHandler.error(fileName,lineNr,msg); };
-    for (int i=1;i<argc;i++)
+    IndexWriter writer(outputDir,update,commitInterval);
+
+    std::vector<std::thread> workers;
+    // stops the workers, which is a no-op if the pipeline already finished, and joins them
+    ThreadJoiner joiner(workers,abortPipeline);
+
+    size_t numParsers = std::min(numThreads,inputFiles.size());
+    activeParsers  = numParsers;
+    activeBuilders = numThreads;
+    for (size_t t=0;t<numParsers;t++)
     {
-      if (std::string(argv[i])=="-o")
+      workers.emplace_back(guarded,[&]()
       {
-        i++;
-      }
-      else
+        size_t i;
+        while (!aborted && (i=nextFile++)<inputFiles.size())
+        {
+          const std::string &fileName = inputFiles[i];
+          {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            std::cout << "Processing " << fileName << "..." << std::endl;
+          }
+          std::string inputStr = fileToString(fileName);
+          XMLContentHandler contentHandler(rawQueue,batchSize,i);
+          XMLHandlers handlers;
+          handlers.startElement = [&contentHandler](const std::string &name,const XMLHandlers::Attributes &attrs)  { contentHandler.startElement(name,attrs);   };
+          handlers.endElement   = [&contentHandler](const std::string &name)                                       { contentHandler.endElement(name);           };
+          handlers.characters   = [&contentHandler](const std::string &chars)                                      { contentHandler.characters(chars);          };
+          handlers.error        = [&contentHandler,&outputMutex](const std::string &fn,int lineNr,const std::string &msg)
+          {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            contentHandler.error(fn,lineNr,msg);
+          };
+          XMLParser parser(handlers);
+          parser.parse(fileName.c_str(),inputStr.c_str(),false,[](){},[](){});
+          if (contentHandler.failed())
+          {
+            parseFailed = true;
+            abortPipeline();
+          }
+        }
+        // the last parser to finish tells the builders that no more input follows
+        if (--activeParsers==0) rawQueue.close();
+      });
+    }
+    for (size_t t=0;t<numThreads;t++)
+    {
+      workers.emplace_back(guarded,[&]()
+      {
+        RawBatch rawBatch;
+        while (!aborted && rawQueue.pop(rawBatch))
+        {
+          DocBatch docBatch;
+          docBatch.pos = rawBatch.pos;
+          docBatch.docs.reserve(rawBatch.docs.size());
+          for (const auto &raw : rawBatch.docs)
+          {
+            docBatch.docs.push_back(buildDocument(raw));
+          }
+          docQueue.push(std::move(docBatch));
+        }
+        // the last builder to finish tells the writer that no more documents follow
+        if (--activeBuilders==0) docQueue.close();
+      });
+    }
+    if (numParsers==0) rawQueue.close();
+
+    // the batches arrive in the order in which the builders finish them; they are
+    // written in input order, so the document ids do not depend on thread timing
+    std::map<std::pair<size_t,size_t>,DocBatch> pending;
+    std::pair<size_t,size_t> next{0,0};
+    DocBatch docBatch;
+    while (docQueue.pop(docBatch))
+    {
+      auto key = std::make_pair(docBatch.pos.file,docBatch.pos.index);
+      pending.emplace(key,std::move(docBatch));
+      for (auto it=pending.find(next); it!=pending.end(); it=pending.find(next))
       {
-        std::cout << "Processing " << argv[i] << "..." << std::endl;
-        std::string inputStr = fileToString(argv[i]);
-        XMLParser parser(handlers);
-        parser.parse(argv[i],inputStr.c_str(),false,[](){},[](){});
+        writer.write(it->second);
+        next = it->second.pos.last ? std::make_pair(next.first+1,size_t(0)) : std::make_pair(next.first,next.second+1);
+        pending.erase(it);
       }
     }
+    if (threadError) std::rethrow_exception(threadError);
+    if (parseFailed)
+    {
+      std::cerr << "Error: the search data could not be parsed, the index has not been completed" << std::endl;
+      result = 1;
+    }
+    else
+    {
+      writer.finish();
+    }
   }
   catch(const Xapian::Error &e)
   {
     std::cerr << "Caught exception: " << e.get_description() << std::endl;
+    result = 1;
+  }
+  catch(const std::exception &e)
+  {
+    std::cerr << "Caught exception: " << e.what() << std::endl;
+    result = 1;
   }
   catch(...)
   {
     std::cerr << "Caught an unknown exception" << std::endl;
+    result = 1;
   }
 
-  return 0;
+  return result;
 }
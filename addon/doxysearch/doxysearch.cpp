@@ -23,6 +23,54 @@
 #include <string>
 #include <algorithm>
 #include <filesystem>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <fstream>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+
+// socket includes
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using socket_t = SOCKET;
+static void closeSocket(socket_t s) { closesocket(s); }
+static int lastSocketError() { return WSAGetLastError(); }
+static void setSocketTimeout(socket_t s,int seconds)
+{
+  DWORD ms = static_cast<DWORD>(seconds*1000);
+  setsockopt(s,SOL_SOCKET,SO_RCVTIMEO,reinterpret_cast<const char*>(&ms),sizeof(ms));
+  setsockopt(s,SOL_SOCKET,SO_SNDTIMEO,reinterpret_cast<const char*>(&ms),sizeof(ms));
+}
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+using socket_t = int;
+#define INVALID_SOCKET (-1)
+static void closeSocket(socket_t s) { close(s); }
+static int lastSocketError() { return errno; }
+static void setSocketTimeout(socket_t s,int seconds)
+{
+  timeval tv;
+  tv.tv_sec  = seconds;
+  tv.tv_usec = 0;
+  setsockopt(s,SOL_SOCKET,SO_RCVTIMEO,&tv,sizeof(tv));
+  setsockopt(s,SOL_SOCKET,SO_SNDTIMEO,&tv,sizeof(tv));
+}
+#endif
 
 // Xapian includes
 #include <xapian.h>
@@ -285,9 +333,21 @@ static std::string escapeString(const std::string &s)
   return dst.str();
 }
 
+/** Returns a JSON object containing \a error */
+static std::string errorResult(const std::string &error)
+{
+  return "{\"error\":\"" + escapeString(error) + "\"}";
+}
+
+/** Wraps a JSON result into a call of \a callback (JSON with padding) */
+static std::string jsonp(const std::string &callback,const std::string &json)
+{
+  return callback + "(" + json + ")";
+}
+
 static void showError(const std::string &callback,const std::string &error)
 {
-  std::cout << callback << "({\"error\":\"" << error << "\"})";
+  std::cout << jsonp(callback,errorResult(error));
   exit(0);
 }
 
@@ -295,12 +355,601 @@ static void usage(const char *name, int exitVal = 1)
 {
   std::cerr << "Usage: " << name << "[query_string]" << std::endl;
   std::cerr << "       " << "alternatively the query string can be given by the environment variable QUERY_STRING" << std::endl;
+  std::cerr << "       " << name << " --serve <port> [--threads <n>] [--cache <entries>] [--db <dir>]" << std::endl;
+  std::cerr << "       " << "runs a HTTP server on localhost that answers the queries, keeping the search index open" << std::endl;
+  std::cerr << "       " << name << " --replay <host:port> <query_log> [--threads <n>]" << std::endl;
+  std::cerr << "       " << "replays the query strings in query_log (one per line) against a running server" << std::endl;
   exit(exitVal);
 }
 
+//------------------------------------------------------------------------------------
+
+/** The parameters of a query as passed via the query string */
+struct QueryArgs
+{
+  std::string searchFor;
+  std::string callback;
+  int num=1;
+  int page=0;
+};
+
+/** Decodes the parameters found in \a queryString */
+static QueryArgs parseQueryString(const std::string &queryString)
+{
+  QueryArgs args;
+  std::vector<std::string> parts = split(queryString,'&');
+  for (std::vector<std::string>::const_iterator it=parts.begin();it!=parts.end();++it)
+  {
+    std::vector<std::string> kv = split(*it,'=');
+    if (kv.size()==2)
+    {
+      std::string val = uriDecode(kv[1]);
+      if      (kv[0]=="q")  args.searchFor = val;
+      else if (kv[0]=="n")  args.num       = fromString<int>(val);
+      else if (kv[0]=="p")  args.page      = fromString<int>(val);
+      else if (kv[0]=="cb") args.callback  = val;
+    }
+  }
+  return args;
+}
+
+/** Search database together with a query parser that is set up for it.
+ *  Creating this object opens the database, so it should be reused for multiple queries.
+ *  An object should only be used by one thread at a time.
+ */
+class Searcher
+{
+  public:
+    explicit Searcher(const std::string &indexDir) : m_db(indexDir)
+    {
+      m_parser.set_database(m_db);
+      m_parser.set_default_op(Xapian::Query::OP_AND);
+      m_parser.set_stemming_strategy(Xapian::QueryParser::STEM_ALL);
+      Xapian::termcount max_expansion=100;
+#if (XAPIAN_MAJOR_VERSION==1) && (XAPIAN_MINOR_VERSION==2)
+      m_parser.set_max_wildcard_expansion(max_expansion);
+#else
+      m_parser.set_max_expansion(max_expansion,Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT);
+#endif
+    }
+
+    /** Picks up changes made to the database since it was opened.
+     *  Returns true if a newer version of the database was found.
+     */
+    bool reopen()
+    {
+      return m_db.reopen();
+    }
+
+    /** Returns the search results for \a args as a JSON object */
+    std::string query(const QueryArgs &args)
+    {
+      std::ostringstream out;
+      const std::string &searchFor = args.searchFor;
+      int num = args.num, page = args.page;
+      Xapian::Enquire enquire(m_db);
+
+      std::vector<std::string> words = split(searchFor,' ');
+      Xapian::Query query=m_parser.parse_query(searchFor,
+                                               Xapian::QueryParser::FLAG_DEFAULT  |
+                                               Xapian::QueryParser::FLAG_WILDCARD |
+                                               Xapian::QueryParser::FLAG_PHRASE   |
+                                               Xapian::QueryParser::FLAG_PARTIAL
+                                              );
+      enquire.set_query(query);
+
+      // get results
+      Xapian::MSet matches = enquire.get_mset(page*num,num);
+      unsigned int hits    = matches.get_matches_estimated();
+      unsigned int offset  = page*num;
+      unsigned int pages   = num>0 ? (hits+num-1)/num : 0;
+      if (offset>hits)     offset=hits;
+      if (offset+num>hits) num=hits-offset;
+
+      // write results as JSON
+      out << "{" << std::endl
+          << "  \"hits\":"   << hits   << "," << std::endl
+          << "  \"first\":"  << offset << "," << std::endl
+          << "  \"count\":"  << num    << "," << std::endl
+          << "  \"page\":"   << page   << "," << std::endl
+          << "  \"pages\":"  << pages  << "," << std::endl
+          << "  \"query\": \""  << escapeString(searchFor)  << "\"," << std::endl
+          << "  \"items\":[" << std::endl;
+      // foreach search result
+      unsigned int o = offset;
+      for (Xapian::MSetIterator i = matches.begin(); i != matches.end(); ++i,++o)
+      {
+        std::vector<Fragment> hl;
+        Xapian::Document doc = i.get_document();
+        highlighter(doc.get_value(FIELD_DOC),words,hl);
+        out << "  {\"type\": \"" << doc.get_value(FIELD_TYPE) << "\"," << std::endl
+            << "   \"name\": \"" << doc.get_value(FIELD_NAME) << escapeString(doc.get_value(FIELD_ARGS)) << "\"," << std::endl
+            << "   \"tag\": \""  << doc.get_value(FIELD_TAG) << "\"," << std::endl
+            << "   \"url\": \""  << doc.get_value(FIELD_URL) << "\"," << std::endl;
+        out << "   \"fragments\":[" << std::endl;
+        int c=0;
+        bool first=true;
+        for (std::vector<Fragment>::const_iterator it = hl.begin();it!=hl.end() && c<3;++it,++c)
+        {
+          if (!first) out << "," << std::endl;
+          out << "     \"" << escapeString((*it).text) << "\"";
+          first=false;
+        }
+        if (!first) out << std::endl;
+        out << "   ]" << std::endl;
+        out << "  }";
+        if (o<offset+num-1) out << ",";
+        out << std::endl;
+      }
+      out << " ]" << std::endl << "}";
+      return out.str();
+    }
+
+  private:
+    Xapian::Database m_db;
+    Xapian::QueryParser m_parser;
+};
+
+//------------------------------------------------------------------------------------
+
+/** Thread safe cache holding the results of the most recently used queries.
+ *  While typing in the search box the same prefixes are requested over and over again,
+ *  so even a small cache avoids most of the work.
+ *
+ *  The cache is shared by all workers, which each have their own view of the database.
+ *  Callers pass the version() they read before opening or reopening their view, and
+ *  invalidate() is called when a reopen found a new revision. Results of a view that
+ *  is older than the current version are then neither returned nor stored.
+ */
+class ResultCache
+{
+  public:
+    explicit ResultCache(size_t capacity) : m_capacity(capacity) {}
+
+    bool find(const std::string &key,size_t version,std::string &result)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (version!=m_version) return false;
+      auto it = m_map.find(key);
+      if (it==m_map.end()) return false;
+      m_lru.splice(m_lru.begin(),m_lru,it->second); // move to front
+      result = it->second->second;
+      return true;
+    }
+
+    void insert(const std::string &key,size_t version,const std::string &result)
+    {
+      if (m_capacity==0) return;
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (version!=m_version) return; // computed using an outdated view of the database
+      auto it = m_map.find(key);
+      if (it!=m_map.end())
+      {
+        it->second->second = result;
+        m_lru.splice(m_lru.begin(),m_lru,it->second);
+        return;
+      }
+      m_lru.emplace_front(key,result);
+      m_map.emplace(key,m_lru.begin());
+      if (m_map.size()>m_capacity) // evict least recently used entry
+      {
+        m_map.erase(m_lru.back().first);
+        m_lru.pop_back();
+      }
+    }
+
+    size_t version()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_version;
+    }
+
+    /** Drops all results and returns the new version */
+    size_t invalidate()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_map.clear();
+      m_lru.clear();
+      return ++m_version;
+    }
+
+  private:
+    using Entry = std::pair<std::string,std::string>;
+    size_t m_capacity;
+    size_t m_version = 0;
+    std::mutex m_mutex;
+    std::list<Entry> m_lru;
+    std::unordered_map<std::string,std::list<Entry>::iterator> m_map;
+};
+
+//------------------------------------------------------------------------------------
+
+/** Reads a HTTP request header from \a s. Returns false if the connection was closed
+ *  or the request is too large.
+ */
+static bool readRequest(socket_t s,std::string &request)
+{
+  const size_t maxRequestSize = 16384;
+  char buf[4096];
+  while (request.find("\r\n\r\n")==std::string::npos)
+  {
+    if (request.size()>maxRequestSize) return false;
+    int n = static_cast<int>(recv(s,buf,sizeof(buf),0));
+    if (n<=0) return false;
+    request.append(buf,static_cast<size_t>(n));
+  }
+  return true;
+}
+
+/** Writes all of \a data to socket \a s */
+static bool sendAll(socket_t s,const std::string &data)
+{
+  size_t sent=0;
+  while (sent<data.size())
+  {
+    int n = static_cast<int>(send(s,data.data()+sent,static_cast<int>(data.size()-sent),0));
+    if (n<=0) return false;
+    sent+=static_cast<size_t>(n);
+  }
+  return true;
+}
+
+static void sendResponse(socket_t s,const std::string &status,const std::string &body)
+{
+  std::ostringstream out;
+  out << "HTTP/1.1 " << status << "\r\n"
+      << "Content-Type: application/javascript;charset=utf-8\r\n"
+      << "Content-Length: " << body.size() << "\r\n"
+      << "Cache-Control: no-cache\r\n"
+      << "Connection: close\r\n\r\n"
+      << body;
+  sendAll(s,out.str());
+}
+
+//! number of seconds a client connection may be idle before the server closes it
+static const int clientTimeout = 10;
+
+//! maximum number of accepted connections per worker thread waiting to be handled
+static const size_t maxQueuedPerThread = 64;
+
+/** Local HTTP server answering search queries.
+ *
+ *  Each worker thread has its own Searcher object, so the database is opened
+ *  only once per thread instead of once per query as in CGI mode. The server only
+ *  listens on the loopback interface and is meant to be put behind the web server
+ *  that serves the documentation (e.g. using a reverse proxy rule).
+ */
+class SearchServer
+{
+  public:
+    SearchServer(const std::string &indexDir,int port,size_t numThreads,size_t cacheSize)
+      : m_indexDir(indexDir), m_port(port), m_numThreads(numThreads), m_cache(cacheSize) {}
+
+    int run()
+    {
+      socket_t listenSocket = socket(AF_INET,SOCK_STREAM,0);
+      if (listenSocket==INVALID_SOCKET)
+      {
+        std::cerr << "Error: could not create socket" << std::endl;
+        return 1;
+      }
+      int yes=1;
+      setsockopt(listenSocket,SOL_SOCKET,SO_REUSEADDR,reinterpret_cast<const char*>(&yes),sizeof(yes));
+      sockaddr_in addr;
+      memset(&addr,0,sizeof(addr));
+      addr.sin_family      = AF_INET;
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port        = htons(static_cast<unsigned short>(m_port));
+      if (bind(listenSocket,reinterpret_cast<sockaddr*>(&addr),sizeof(addr))!=0 ||
+          listen(listenSocket,SOMAXCONN)!=0)
+      {
+        std::cerr << "Error: could not listen on port " << m_port << std::endl;
+        closeSocket(listenSocket);
+        return 1;
+      }
+      std::vector<std::thread> workers;
+      for (size_t i=0;i<m_numThreads;i++)
+      {
+        workers.emplace_back([this]() { worker(); });
+      }
+      std::cerr << "Serving " << m_indexDir << " on http://127.0.0.1:" << m_port
+                << "/ using " << m_numThreads << " threads" << std::endl;
+      // delay after a failed accept(), doubled for each consecutive failure, so persistent
+      // errors such as running out of file descriptors do not make the loop spin
+      const std::chrono::milliseconds minBackoff(10), maxBackoff(1000);
+      std::chrono::milliseconds backoff = minBackoff;
+      size_t numErrors = 0;
+      for (;;)
+      {
+        socket_t s = accept(listenSocket,nullptr,nullptr);
+        if (s==INVALID_SOCKET)
+        {
+          if (numErrors++%100==0)
+          {
+            std::cerr << "Warning: accept failed with error " << lastSocketError()
+                      << " (" << numErrors << " consecutive failures)" << std::endl;
+          }
+          std::this_thread::sleep_for(backoff);
+          backoff = std::min(backoff*2,maxBackoff);
+          continue;
+        }
+        numErrors = 0;
+        backoff   = minBackoff;
+        // a client that stops sending or reading must not keep a worker busy forever
+        setSocketTimeout(s,clientTimeout);
+        bool queued = false;
+        {
+          std::lock_guard<std::mutex> lock(m_queueMutex);
+          if (m_queue.size()<m_numThreads*maxQueuedPerThread)
+          {
+            m_queue.push_back(s);
+            queued = true;
+          }
+        }
+        if (queued)
+        {
+          m_queueCond.notify_one();
+        }
+        else // overloaded, tell the client to come back later instead of queuing without bound
+        {
+          sendResponse(s,"503 Service Unavailable","");
+          closeSocket(s);
+        }
+      }
+    }
+
+  private:
+    void worker()
+    {
+      std::unique_ptr<Searcher> searcher;
+      for (;;)
+      {
+        socket_t s;
+        {
+          std::unique_lock<std::mutex> lock(m_queueMutex);
+          m_queueCond.wait(lock,[this]() { return !m_queue.empty(); });
+          s = m_queue.front();
+          m_queue.pop_front();
+        }
+        handleRequest(s,searcher);
+        closeSocket(s);
+      }
+    }
+
+    void handleRequest(socket_t s,std::unique_ptr<Searcher> &searcher)
+    {
+      std::string request;
+      if (!readRequest(s,request)) return;
+      // request line: GET /path?query HTTP/1.1
+      size_t e = request.find("\r\n");
+      std::vector<std::string> requestLine = split(request.substr(0,e),' ');
+      if (requestLine.size()<2 || requestLine[0]!="GET")
+      {
+        sendResponse(s,"405 Method Not Allowed","");
+        return;
+      }
+      const std::string &target = requestLine[1];
+      size_t q = target.find('?');
+      std::string queryString = q!=std::string::npos ? target.substr(q+1) : std::string();
+      if (queryString=="test")
+      {
+        if (dirExists(m_indexDir))
+        {
+          sendResponse(s,"200 OK","Test successful.");
+        }
+        else
+        {
+          sendResponse(s,"200 OK","Test failed: cannot find search index "+m_indexDir);
+        }
+        return;
+      }
+      QueryArgs args = parseQueryString(queryString);
+      try
+      {
+        // read the version before (re)opening, so a concurrent update can only make it too old
+        size_t version = m_cache.version();
+        if (!searcher)
+        {
+          searcher = std::make_unique<Searcher>(m_indexDir);
+        }
+        else if (searcher->reopen()) // index was updated, forget the old results of all workers
+        {
+          version = m_cache.invalidate();
+        }
+        std::string key = args.searchFor+'\n'+std::to_string(args.num)+'\n'+std::to_string(args.page);
+        std::string result;
+        if (!m_cache.find(key,version,result))
+        {
+          result = searcher->query(args);
+          m_cache.insert(key,version,result);
+        }
+        sendResponse(s,"200 OK",jsonp(args.callback,result));
+      }
+      catch (const Xapian::Error &ex)
+      {
+        searcher.reset(); // try to open the database again for the next request
+        sendResponse(s,"200 OK",jsonp(args.callback,errorResult(ex.get_description())));
+      }
+      catch (...)
+      {
+        searcher.reset();
+        sendResponse(s,"200 OK",jsonp(args.callback,errorResult("Unknown Exception!")));
+      }
+    }
+
+    std::string m_indexDir;
+    int m_port;
+    size_t m_numThreads;
+    ResultCache m_cache;
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueCond;
+    std::deque<socket_t> m_queue;
+};
+
+//------------------------------------------------------------------------------------
+
+/** Sends a single query to a server at \a addr and waits for the complete response.
+ *  Returns false in case of a connection error or a non 200 status.
+ */
+static bool sendQuery(const sockaddr_in &addr,const std::string &host,const std::string &queryString)
+{
+  socket_t s = socket(AF_INET,SOCK_STREAM,0);
+  if (s==INVALID_SOCKET) return false;
+  bool ok = false;
+  if (connect(s,reinterpret_cast<const sockaddr*>(&addr),sizeof(addr))==0 &&
+      sendAll(s,"GET /?"+queryString+" HTTP/1.1\r\nHost: "+host+"\r\nConnection: close\r\n\r\n"))
+  {
+    std::string response;
+    char buf[4096];
+    int n;
+    while ((n=static_cast<int>(recv(s,buf,sizeof(buf),0)))>0)
+    {
+      response.append(buf,static_cast<size_t>(n));
+    }
+    ok = response.compare(0,12,"HTTP/1.1 200")==0 &&
+         response.find("\"error\":")==std::string::npos;
+  }
+  closeSocket(s);
+  return ok;
+}
+
+/** Load test: replays the queries in \a logFile against the server at \a hostPort
+ *  using \a numThreads concurrent clients, and reports the latency distribution.
+ */
+static int replayQueries(const std::string &hostPort,const std::string &logFile,size_t numThreads)
+{
+  size_t colon = hostPort.rfind(':');
+  if (colon==std::string::npos)
+  {
+    std::cerr << "Error: expected <host:port> but got " << hostPort << std::endl;
+    return 1;
+  }
+  std::string host = hostPort.substr(0,colon);
+  addrinfo hints;
+  memset(&hints,0,sizeof(hints));
+  hints.ai_family   = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *res = nullptr;
+  if (getaddrinfo(host.c_str(),hostPort.substr(colon+1).c_str(),&hints,&res)!=0 || res==nullptr)
+  {
+    std::cerr << "Error: could not resolve " << hostPort << std::endl;
+    return 1;
+  }
+  sockaddr_in addr;
+  memcpy(&addr,res->ai_addr,sizeof(addr));
+  freeaddrinfo(res);
+
+  std::ifstream f(logFile);
+  if (!f.is_open())
+  {
+    std::cerr << "Error: could not open " << logFile << std::endl;
+    return 1;
+  }
+  // each line is either a complete query string (q=...&n=...) or just the text searched for
+  std::vector<std::string> queries;
+  std::string line;
+  while (getline(f,line))
+  {
+    if (!line.empty() && line[line.size()-1]=='\r') line.resize(line.size()-1);
+    if (line.empty()) continue;
+    if (line.find('=')==std::string::npos)
+    {
+      std::string encoded;
+      for (char c : line) encoded += c==' ' ? '+' : c;
+      line = "q="+encoded+"&n=20&p=0&cb=replay";
+    }
+    queries.push_back(line);
+  }
+
+  using clock = std::chrono::steady_clock;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> failures{0};
+  std::vector<double> latencies(queries.size());
+  auto start = clock::now();
+  std::vector<std::thread> clients;
+  for (size_t t=0;t<numThreads;t++)
+  {
+    clients.emplace_back([&]()
+    {
+      size_t i;
+      while ((i=next++)<queries.size())
+      {
+        auto t0 = clock::now();
+        if (!sendQuery(addr,host,queries[i])) failures++;
+        latencies[i] = std::chrono::duration<double,std::milli>(clock::now()-t0).count();
+      }
+    });
+  }
+  for (auto &c : clients) c.join();
+  double elapsed = std::chrono::duration<double>(clock::now()-start).count();
+
+  std::sort(latencies.begin(),latencies.end());
+  auto percentile = [&latencies](double pct)
+  {
+    if (latencies.empty()) return 0.0;
+    size_t idx = static_cast<size_t>(pct/100.0*static_cast<double>(latencies.size()-1)+0.5);
+    return latencies[idx];
+  };
+  std::cout << "queries:  " << queries.size() << " (" << failures << " failed)" << std::endl
+            << "clients:  " << numThreads << std::endl
+            << "duration: " << elapsed << " s" << std::endl
+            << "rate:     " << (elapsed>0 ? static_cast<double>(queries.size())/elapsed : 0.0) << " queries/s" << std::endl
+            << "latency:  p50=" << percentile(50) << " ms, p90=" << percentile(90)
+            << " ms, p99=" << percentile(99) << " ms, max=" << percentile(100) << " ms" << std::endl;
+  return failures>0 ? 1 : 0;
+}
+
+/** Processes the options for server (--serve) and load test (--replay) mode */
+static int runServerMode(int argc,char **argv)
+{
+  std::string mode = argv[1];
+  if (argc<3) usage(argv[0]);
+  std::string indexDir = "doxysearch.db";
+  size_t numThreads = std::max(1u,std::thread::hardware_concurrency());
+  size_t cacheSize  = 10000;
+  int optStart = mode=="--replay" ? 4 : 3;
+  if (argc<optStart) usage(argv[0]);
+  for (int i=optStart;i<argc;i++)
+  {
+    std::string opt = argv[i];
+    if (i+1>=argc) usage(argv[0]);
+    if      (opt=="--threads") numThreads = std::max(1,fromString<int>(argv[++i]));
+    else if (opt=="--cache")   cacheSize  = std::max(0,fromString<int>(argv[++i]));
+    else if (opt=="--db")      indexDir   = argv[++i];
+    else usage(argv[0]);
+  }
+#ifdef _WIN32
+  WSADATA wsaData;
+  if (WSAStartup(MAKEWORD(2,2),&wsaData)!=0)
+  {
+    std::cerr << "Error: could not initialize sockets" << std::endl;
+    return 1;
+  }
+#else
+  signal(SIGPIPE,SIG_IGN); // a client closing its connection should not stop the server
+#endif
+  if (mode=="--serve")
+  {
+    char *end = nullptr;
+    long port = strtol(argv[2],&end,10);
+    if (end==argv[2] || *end!='\0' || port<1 || port>65535)
+    {
+      std::cerr << "Error: invalid port " << argv[2] << ", expected a number between 1 and 65535" << std::endl;
+      return 1;
+    }
+    SearchServer server(indexDir,static_cast<int>(port),numThreads,cacheSize);
+    return server.run();
+  }
+  return replayQueries(argv[2],argv[3],numThreads);
+}
+
 /** Main routine */
 int main(int argc,char **argv)
 {
+  if (argc>=2 && (std::string(argv[1])=="--serve" || std::string(argv[1])=="--replay"))
+  {
+    return runServerMode(argc,argv);
+  }
   // process inputs that were passed to us via QUERY_STRING
   std::string callback;
   try
@@ -341,21 +990,8 @@ int main(int argc,char **argv)
 
     std::cout << "Content-Type:application/javascript;charset=utf-8\r\n\n";
     // parse query string
-    std::vector<std::string> parts = split(queryString,'&');
-    std::string              searchFor;
-    int num=1,page=0;
-    for (std::vector<std::string>::const_iterator it=parts.begin();it!=parts.end();++it)
-    {
-      std::vector<std::string> kv = split(*it,'=');
-      if (kv.size()==2)
-      {
-        std::string val = uriDecode(kv[1]);
-        if      (kv[0]=="q")  searchFor = val;
-        else if (kv[0]=="n")  num       = fromString<int>(val);
-        else if (kv[0]=="p")  page      = fromString<int>(val);
-        else if (kv[0]=="cb") callback  = val;
-      }
-    }
+    QueryArgs args = parseQueryString(queryString);
+    callback = args.callback;
 
     std::string indexDir = "doxysearch.db";
 
@@ -373,74 +1009,9 @@ int main(int argc,char **argv)
       exit(0);
     }
 
-    // create query
-    Xapian::Database db(indexDir);
-    Xapian::Enquire enquire(db);
-
-    std::vector<std::string> words = split(searchFor,' ');
-    Xapian::QueryParser parser;
-    parser.set_database(db);
-    parser.set_default_op(Xapian::Query::OP_AND);
-    parser.set_stemming_strategy(Xapian::QueryParser::STEM_ALL);
-    Xapian::termcount max_expansion=100;
-#if (XAPIAN_MAJOR_VERSION==1) && (XAPIAN_MINOR_VERSION==2)
-    parser.set_max_wildcard_expansion(max_expansion);
-#else
-    parser.set_max_expansion(max_expansion,Xapian::Query::WILDCARD_LIMIT_MOST_FREQUENT);
-#endif
-    Xapian::Query query=parser.parse_query(searchFor,
-                                           Xapian::QueryParser::FLAG_DEFAULT  |
-                                           Xapian::QueryParser::FLAG_WILDCARD |
-                                           Xapian::QueryParser::FLAG_PHRASE   |
-                                           Xapian::QueryParser::FLAG_PARTIAL
-                                          );
-    enquire.set_query(query);
-
-    // get results
-    Xapian::MSet matches = enquire.get_mset(page*num,num);
-    unsigned int hits    = matches.get_matches_estimated();
-    unsigned int offset  = page*num;
-    unsigned int pages   = num>0 ? (hits+num-1)/num : 0;
-    if (offset>hits)     offset=hits;
-    if (offset+num>hits) num=hits-offset;
-
-    // write results as JSONP
-    std::cout << callback.c_str() << "(";
-    std::cout << "{" << std::endl
-              << "  \"hits\":"   << hits   << "," << std::endl
-              << "  \"first\":"  << offset << "," << std::endl
-              << "  \"count\":"  << num    << "," << std::endl
-              << "  \"page\":"   << page   << "," << std::endl
-              << "  \"pages\":"  << pages  << "," << std::endl
-              << "  \"query\": \""  << escapeString(searchFor)  << "\"," << std::endl
-              << "  \"items\":[" << std::endl;
-    // foreach search result
-    unsigned int o = offset;
-    for (Xapian::MSetIterator i = matches.begin(); i != matches.end(); ++i,++o)
-    {
-      std::vector<Fragment> hl;
-      Xapian::Document doc = i.get_document();
-      highlighter(doc.get_value(FIELD_DOC),words,hl);
-      std::cout << "  {\"type\": \"" << doc.get_value(FIELD_TYPE) << "\"," << std::endl
-                << "   \"name\": \"" << doc.get_value(FIELD_NAME) << escapeString(doc.get_value(FIELD_ARGS)) << "\"," << std::endl
-                << "   \"tag\": \""  << doc.get_value(FIELD_TAG) << "\"," << std::endl
-                << "   \"url\": \""  << doc.get_value(FIELD_URL) << "\"," << std::endl;
-      std::cout << "   \"fragments\":[" << std::endl;
-      int c=0;
-      bool first=true;
-      for (std::vector<Fragment>::const_iterator it = hl.begin();it!=hl.end() && c<3;++it,++c)
-      {
-        if (!first) std::cout << "," << std::endl;
-        std::cout << "     \"" << escapeString((*it).text) << "\"";
-        first=false;
-      }
-      if (!first) std::cout << std::endl;
-      std::cout << "   ]" << std::endl;
-      std::cout << "  }";
-      if (o<offset+num-1) std::cout << ",";
-      std::cout << std::endl;
-    }
-    std::cout << " ]" << std::endl << "})" << std::endl;
+    // run query and write results as JSONP
+    Searcher searcher(indexDir);
+    std::cout << jsonp(callback,searcher.query(args)) << std::endl;
   }
   catch (const Xapian::Error &e) // Xapian exception
   {
@@ -0,0 +1,500 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+/** @file
+ *  @brief Micro-benchmarks for the building blocks that dominate doxygen's run time.
+ *
+ *  Each benchmark runs on input that is generated in the same way on every run,
+ *  with a doubling number of iterations until a batch takes at least the
+ *  requested minimum time. The time per iteration of that batch is reported.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "commentcnv.h"
+#include "config.h"
+#include "docnode.h"
+#include "docparser.h"
+#include "doxygen.h"
+#include "entry.h"
+#include "fortranscanner.h"
+#include "markdown.h"
+#include "portable.h"
+#include "pre.h"
+#include "qcstring.h"
+#include "regex.h"
+#include "scanner.h"
+#include "textdocvisitor.h"
+#include "textstream.h"
+#include "version.h"
+
+namespace
+{
+
+/** A benchmark runs its body \a iterations times and returns a value that
+ *  depends on the work done, so the compiler cannot optimize it away.
+ */
+struct Benchmark
+{
+  const char *name;
+  std::function<size_t(size_t iterations)> body;
+};
+
+//------------------------------------------------------------------------
+// input generators
+
+std::string makeIdentifierText(size_t lines)
+{
+  std::string s;
+  for (size_t i=0; i<lines; i++)
+  {
+    s+="  ns"+std::to_string(i%7)+"::Class"+std::to_string(i)+"<int> *member"+std::to_string(i)+
+       " = findSymbol(\"name"+std::to_string(i)+"\", 0x"+std::to_string(i*31)+"); // comment\n";
+  }
+  return s;
+}
+
+std::string makeSourceFile(size_t classes)
+{
+  std::string s;
+  s+="#define VERSION 3\n#define MAX(a,b) ((a)>(b)?(a):(b))\n";
+  for (size_t i=0; i<classes; i++)
+  {
+    std::string n = std::to_string(i);
+    s+="#if VERSION > "+std::to_string(i%5)+" && !defined(SKIP_"+n+")\n";
+    s+="/** Class "+n+". */\nclass Class"+n+"\n{\n  public:\n";
+    s+="    int method"+n+"(int a,int b) const { return MAX(a,b)+"+n+"; }\n";
+    s+="};\n#else\n/* disabled */\n#endif\n";
+  }
+  return s;
+}
+
+std::string makeHeaderFile(size_t classes)
+{
+  // a large, heavily documented header with tab and space indentation
+  std::string s;
+  s+="/** @file\n *  @brief Generated header.\n */\n\n#ifndef BENCH_H\n#define BENCH_H\n\nnamespace bench\n{\n\n";
+  for (size_t i=0; i<classes; i++)
+  {
+    std::string n = std::to_string(i);
+    s+="/// Class "+n+" holds a value.\n///\n/// A longer description of class "+n+" that spans\n";
+    s+="/// several lines, with \\c code and a <b>bold</b> word.\nclass Class"+n+" : public Base"+n+"\n{\n";
+    s+="  public:\n\t/** Creates an instance with value \\a v. */\n\tClass"+n+"(int v) : m_value(v) {}\n";
+    s+="\t/// Returns the value.\n\tint value() const { return m_value; }\n";
+    s+="    /** Sets the value.\n     *  @param v the new value\n     */\n    void setValue(int v);\n";
+    s+="  private:\n\tint m_value = "+n+"; //!< the value\n};\n\n";
+  }
+  s+="} // namespace bench\n\n#endif\n";
+  return s;
+}
+
+std::string makeFortranModule(size_t routines)
+{
+  std::string s;
+  s+="!> Generated module.\nmodule bench\n  implicit none\ncontains\n";
+  for (size_t i=0; i<routines; i++)
+  {
+    std::string n = std::to_string(i);
+    s+="  !> Subroutine "+n+" adds two values.\n  !! @param[in] a first value\n  !! @param[out] b result\n";
+    s+="  subroutine sub"+n+"(a, b)\n    integer, intent(in) :: a !< first value\n";
+    s+="    integer, intent(out) :: b !< result\n\t    b = a + &\n         & "+n+"\n  end subroutine sub"+n+"\n\n";
+  }
+  s+="end module bench\n";
+  return s;
+}
+
+std::string makeMarkdownPage(size_t sections)
+{
+  std::string s;
+  s+="# Title {#title}\n\n";
+  for (size_t i=0; i<sections; i++)
+  {
+    std::string n = std::to_string(i);
+    s+="## Section "+n+" {#sec"+n+"}\n\n";
+    s+="Some *emphasis*, some **bold** text, `code "+n+"` and a [link](https://www.doxygen.nl/"+n+").\n\n";
+    s+="- item one\n- item two\n  1. nested\n  2. list\n\n";
+    s+="| Column | Value |\n|--------|------:|\n| a | "+n+" |\n| b | "+n+" |\n\n";
+    s+="```cpp\nint x = "+n+";\n```\n\n> quoted text "+n+"\n\n";
+  }
+  return s;
+}
+
+std::string makeDocBlock(size_t paragraphs)
+{
+  std::string s;
+  s+="Brief description of the function.\n\n";
+  for (size_t i=0; i<paragraphs; i++)
+  {
+    std::string n = std::to_string(i);
+    s+="Paragraph "+n+" with <b>bold</b>, \\c code, \\e emphasis and a link to https://www.doxygen.nl.\n";
+    s+="- first item "+n+"\n- second item\n  - nested item\n\n";
+    s+="<table><tr><th>Key</th><th>Value</th></tr><tr><td>a</td><td>"+n+"</td></tr></table>\n\n";
+  }
+  s+="\\param value the input value\n\\param other the other value\n\\returns the result\n";
+  s+="\\note A note with \\ref nonexisting.\n";
+  return s;
+}
+
+//------------------------------------------------------------------------
+// benchmarks
+
+std::vector<Benchmark> benchmarks()
+{
+  static const std::string idText   = makeIdentifierText(200);
+  static const std::string source   = makeSourceFile(100);
+  static const std::string markdown = makeMarkdownPage(50);
+  static const std::string docBlock = makeDocBlock(20);
+  static const std::string header   = makeHeaderFile(500);
+  static const std::string largeHeader = makeHeaderFile(10000);
+  static const std::string fortran  = makeFortranModule(500);
+
+  return
+  {
+    { "regex/search_identifiers", [](size_t n)
+      {
+        static const reg::Ex re(R"(\a[\w:]*)");
+        size_t count=0;
+        for (size_t i=0; i<n; i++)
+        {
+          reg::Iterator it(idText,re);
+          reg::Iterator end;
+          for (; it!=end; ++it) count++;
+        }
+        return count;
+      }
+    },
+    { "regex/replace", [](size_t n)
+      {
+        static const reg::Ex re(R"(0x\d+)");
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          len+=reg::replace(idText,re,"ADDR").length();
+        }
+        return len;
+      }
+    },
+    { "regex/match_wildcard", [](size_t n)
+      {
+        static const reg::Ex re("*.cpp",reg::Ex::Mode::Wildcard);
+        size_t count=0;
+        for (size_t i=0; i<n; i++)
+        {
+          for (const char *f : { "src/doxygen.cpp", "src/doxygen.h", "a/b/c/markdown.cpp", "README.md" })
+          {
+            if (reg::match(f,re)) count++;
+          }
+        }
+        return count;
+      }
+    },
+    { "qcstring/append", [](size_t n)
+      {
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          QCString s;
+          for (int j=0; j<200; j++)
+          {
+            s+="member";
+            s+=QCString().setNum(j);
+            s+=',';
+          }
+          len+=s.length();
+        }
+        return len;
+      }
+    },
+    { "qcstring/find_substitute", [](size_t n)
+      {
+        QCString text(idText);
+        size_t count=0;
+        for (size_t i=0; i<n; i++)
+        {
+          count+=static_cast<size_t>(text.find("findSymbol",static_cast<int>(i%100)));
+          count+=substitute(text,"::",".").length();
+        }
+        return count;
+      }
+    },
+    { "qcstring/simplify_strip", [](size_t n)
+      {
+        QCString text(idText);
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          len+=text.simplifyWhiteSpace().stripWhiteSpace().lower().length();
+        }
+        return len;
+      }
+    },
+    { "textstream/write", [](size_t n)
+      {
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          TextStream t;
+          for (int j=0; j<1000; j++)
+          {
+            t << "<td class=\"memname\">" << j << ' ' << QCString("name") << 3.5 << "</td>\n";
+          }
+          len+=t.str().length();
+        }
+        return len;
+      }
+    },
+    { "markdown/process", [](size_t n)
+      {
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          Markdown md("bench.md",1);
+          int startNewlines=0;
+          len+=md.process(markdown,startNewlines).length();
+        }
+        return len;
+      }
+    },
+    { "docparser/parse_render", [](size_t n)
+      {
+        // parses a documentation block and renders it, like generateDoc() does
+        size_t len=0;
+        auto parser { createDocParser() };
+        for (size_t i=0; i<n; i++)
+        {
+          auto ast { validatingParseDoc(*parser.get(),"bench.h",1,nullptr,nullptr,docBlock,DocOptions()) };
+          auto astImpl = dynamic_cast<const DocNodeAST*>(ast.get());
+          if (astImpl)
+          {
+            TextStream t;
+            TextDocVisitor visitor(t);
+            std::visit(visitor,astImpl->root);
+            len+=t.str().length();
+          }
+        }
+        return len;
+      }
+    },
+    { "pre/process_file", [](size_t n)
+      {
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          Preprocessor pp;
+          std::string output;
+          pp.processFile("bench.h",source,output);
+          len+=output.length();
+        }
+        return len;
+      }
+    },
+    { "commentcnv/convert_header", [](size_t n)
+      {
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          std::string output;
+          convertCppComments(header,output,"bench.h");
+          len+=output.length();
+        }
+        return len;
+      }
+    },
+    { "scanner/parse_header", [](size_t n)
+      {
+        // scans the header in the same way as parseFile() does after the comment conversion
+        std::string converted;
+        convertCppComments(header,converted,"bench.h");
+        size_t count=0;
+        for (size_t i=0; i<n; i++)
+        {
+          COutlineParser parser;
+          auto root = std::make_shared<Entry>();
+          parser.parseInput("bench.h",converted.c_str(),root,nullptr);
+          count+=root->children().size();
+        }
+        return count;
+      }
+    },
+    { "commentcnv/convert_large_header", [](size_t n)
+      {
+        // a multi megabyte header, long comment and whitespace runs dominate here
+        size_t len=0;
+        for (size_t i=0; i<n; i++)
+        {
+          std::string output;
+          convertCppComments(largeHeader,output,"large.h");
+          len+=output.length();
+        }
+        return len;
+      }
+    },
+    { "scanner/parse_large_header", [](size_t n)
+      {
+        std::string converted;
+        convertCppComments(largeHeader,converted,"large.h");
+        size_t count=0;
+        for (size_t i=0; i<n; i++)
+        {
+          COutlineParser parser;
+          auto root = std::make_shared<Entry>();
+          parser.parseInput("large.h",converted.c_str(),root,nullptr);
+          count+=root->children().size();
+        }
+        return count;
+      }
+    },
+    { "scanner/parse_fortran", [](size_t n)
+      {
+        size_t count=0;
+        for (size_t i=0; i<n; i++)
+        {
+          FortranOutlineParserFree parser;
+          auto root = std::make_shared<Entry>();
+          parser.parseInput("bench.f90",fortran.c_str(),root,nullptr);
+          count+=root->children().size();
+        }
+        return count;
+      }
+    },
+  };
+}
+
+struct Result
+{
+  const char *name;
+  size_t iterations;
+  double nsPerIteration;
+};
+
+Result run(const Benchmark &b,double minTime)
+{
+  using clock = std::chrono::steady_clock;
+  volatile size_t sink = b.body(1); // warm up caches and static initialization
+  size_t iterations=1;
+  for (;;)
+  {
+    auto start = clock::now();
+    sink = sink + b.body(iterations);
+    double elapsed = std::chrono::duration<double>(clock::now()-start).count();
+    if (elapsed>=minTime || iterations>=(size_t(1)<<40))
+    {
+      return Result{ b.name, iterations, elapsed*1e9/static_cast<double>(iterations) };
+    }
+    iterations*=2;
+  }
+}
+
+void usage(const char *name,int exitVal = 1)
+{
+  std::cerr << "Usage: " << name << " [options] [filter]" << std::endl;
+  std::cerr << "Runs the micro-benchmarks whose name contains filter (default: all)." << std::endl;
+  std::cerr << "Options:" << std::endl;
+  std::cerr << "  --min-time <s>  minimum duration of the measured batch (default: 0.5)" << std::endl;
+  std::cerr << "  --json          print the results in JSON format" << std::endl;
+  std::cerr << "  --list          list the available benchmarks" << std::endl;
+  std::cerr << "  -h, --help      print this help" << std::endl;
+  std::cerr << "  -v, --version   print version information" << std::endl;
+  exit(exitVal);
+}
+
+} // namespace
+
+int main(int argc,const char **argv)
+{
+  double minTime = 0.5;
+  bool json = false;
+  bool list = false;
+  std::string filter;
+  for (int i=1; i<argc; i++)
+  {
+    if (std::strcmp(argv[i],"--min-time")==0 && i+1<argc)
+    {
+      minTime = std::max(0.001,atof(argv[++i]));
+    }
+    else if (std::strcmp(argv[i],"--json")==0)
+    {
+      json = true;
+    }
+    else if (std::strcmp(argv[i],"--list")==0)
+    {
+      list = true;
+    }
+    else if (std::strcmp(argv[i],"-h")==0 || std::strcmp(argv[i],"--help")==0)
+    {
+      usage(argv[0],0);
+    }
+    else if (std::strcmp(argv[i],"-v")==0 || std::strcmp(argv[i],"--version")==0)
+    {
+      std::cout << argv[0] << " version: " << getFullVersion() << std::endl;
+      exit(0);
+    }
+    else if (argv[i][0]=='-' || !filter.empty())
+    {
+      usage(argv[0]);
+    }
+    else
+    {
+      filter = argv[i];
+    }
+  }
+
+  // the markdown and preprocessor benchmarks need the global state and a valid configuration
+  initDoxygen();
+  checkConfiguration();
+  adjustConfiguration();
+  Config_updateBool(QUIET,TRUE);
+  Config_updateBool(WARNINGS,FALSE);
+
+  std::vector<Result> results;
+  for (const auto &b : benchmarks())
+  {
+    if (!filter.empty() && std::strstr(b.name,filter.c_str())==nullptr) continue;
+    if (list)
+    {
+      std::cout << b.name << std::endl;
+      continue;
+    }
+    results.push_back(run(b,minTime));
+    if (!json)
+    {
+      const Result &r = results.back();
+      std::cout << std::left << std::setw(32) << r.name << std::right
+                << std::fixed << std::setprecision(1) << std::setw(14) << r.nsPerIteration << " ns/iteration"
+                << std::setw(12) << r.iterations << " iterations" << std::endl;
+    }
+  }
+
+  if (json)
+  {
+    std::cout << "{\"version\":\"" << getFullVersion() << "\",\"minTime\":" << minTime << ",\"benchmarks\":[";
+    for (size_t i=0; i<results.size(); i++)
+    {
+      const Result &r = results[i];
+      std::cout << (i>0 ? "," : "") << "\n{\"name\":\"" << r.name << "\",\"iterations\":" << r.iterations
+                << ",\"nsPerIteration\":" << std::fixed << std::setprecision(1) << r.nsPerIteration << "}";
+    }
+    std::cout << "\n]}" << std::endl;
+  }
+  cleanUpDoxygen();
+  return 0;
+}
@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 1997-2025 by Dimitri van Heesch.
+#
+# Permission to use, copy, modify, and distribute this software and its
+# documentation under the terms of the GNU General Public License is hereby
+# granted. No representations are made about the suitability of this software
+# for any purpose. It is provided "as is" without express or implied warranty.
+# See the GNU General Public License for more details.
+#
+# Documents produced by Doxygen are derivative works derived from the
+# input used in their production; they are not affected by this license.
+
+"""Generates a synthetic project to benchmark doxygen with.
+
+The corpus is fully determined by the size parameters and the seed, so runs
+on different machines or revisions process exactly the same input. It contains
+C++ (deep namespace and class hierarchies, templates, many includes and cross
+references), Python, Fortran and Markdown sources.
+"""
+
+import argparse
+import os
+import random
+import shutil
+import sys
+
+class Corpus:
+    def __init__(self, args):
+        self.args = args
+        self.rnd = random.Random(args.seed)
+        self.outdir = args.outdir
+        self.classes = []   # fully qualified names of the generated C++ classes
+        self.headers = []   # include names of the generated C++ headers
+        self.files = 0
+        self.bytes = 0
+
+    def write(self, name, text):
+        path = os.path.join(self.outdir, name)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        with open(path, 'w', encoding='utf-8', newline='\n') as f:
+            f.write(text)
+        self.files += 1
+        self.bytes += len(text)
+
+    def pick(self, seq, n):
+        return self.rnd.sample(seq, min(n, len(seq))) if seq else []
+
+    # ------------------------------------------------------------------
+    # C++
+
+    def namespace_path(self, index):
+        parts = []
+        for level in range(self.args.depth):
+            parts.append('ns%d' % ((index >> level) % self.args.namespaces))
+        return parts
+
+    def gen_cpp(self):
+        a = self.args
+        for fi in range(a.cpp_files):
+            ns = self.namespace_path(fi)
+            header = 'cpp/%s/file%d.h' % ('/'.join(ns), fi)
+            include = '%s/file%d.h' % ('/'.join(ns), fi)
+            guard = 'FILE%d_H' % fi
+            out = []
+            out.append('/** @file\n *  @brief Synthetic header %d.\n */\n' % fi)
+            out.append('#ifndef %s\n#define %s\n\n' % (guard, guard))
+            for inc in self.pick(self.headers, a.includes):
+                out.append('#include "%s"\n' % inc)
+            out.append('\n#define FILE%d_VERSION %d\n' % (fi, fi))
+            out.append('#if FILE%d_VERSION > 0 && defined(%s)\n#define FILE%d_ENABLED 1\n#endif\n\n' % (fi, guard, fi))
+            for n in ns:
+                out.append('namespace %s {\n' % n)
+            out.append('\n')
+            new_classes = []
+            for ci in range(a.classes):
+                cname = 'Class%d_%d' % (fi, ci)
+                qname = '::'.join(ns + [cname])
+                bases = self.pick(self.classes[-4 * a.classes:], 1) if self.rnd.random() < 0.7 else []
+                refs = self.pick(self.classes, a.refs)
+                templ = self.rnd.random() < a.templates
+                out.append('/** @brief Synthetic class %s.\n *\n' % cname)
+                out.append(' *  Related to %s.\n' % (', '.join(refs) if refs else 'nothing'))
+                out.append(' *  @see %s\n */\n' % (refs[0] if refs else cname))
+                if templ:
+                    out.append('template<typename T, int N = %d>\n' % (ci + 1))
+                out.append('class %s%s\n{\n  public:\n' % (cname, (' : public ' + bases[0]) if bases else ''))
+                out.append('    /** Constructs a %s. */\n    %s();\n' % (cname, cname))
+                out.append('    /** Destroys the object. */\n    virtual ~%s();\n' % cname)
+                methods = []
+                for mi in range(a.members):
+                    ret = 'T' if templ and mi % 2 == 0 else 'int'
+                    ref = refs[mi % len(refs)] if refs else None
+                    arg = ('const %s &other' % ref) if ref else 'int value'
+                    out.append('    /** Member %d of %s, see %s.\n' % (mi, cname, ref or cname))
+                    out.append('     *  @param %s the input\n' % arg.split()[-1].lstrip('&'))
+                    out.append('     *  @return the result\n     */\n')
+                    out.append('    %s method%d(%s) const;\n' % (ret, mi, arg))
+                    methods.append((ret, mi, arg))
+                out.append('  protected:\n    int m_value = %d; //!< the stored value\n' % ci)
+                if templ:
+                    out.append('    T m_data[N]; //!< the stored data\n')
+                out.append('};\n\n')
+                new_classes.append((cname, qname, templ, methods))
+            out.append('/** Free function of file %d. */\nint freeFunction%d(int value);\n\n' % (fi, fi))
+            for n in reversed(ns):
+                out.append('} // namespace %s\n' % n)
+            out.append('\n#endif\n')
+            self.write(header, ''.join(out))
+
+            src = []
+            src.append('#include "%s"\n\n' % include)
+            for n in ns:
+                src.append('namespace %s {\n' % n)
+            for cname, qname, templ, methods in new_classes:
+                if templ:
+                    continue
+                src.append('\n%s::%s() {}\n%s::~%s() {}\n' % (cname, cname, cname, cname))
+                for ret, mi, arg in methods:
+                    src.append('%s %s::method%d(%s) const\n{\n' % (ret, cname, mi, arg))
+                    if arg.startswith('const'):
+                        src.append('  return m_value + freeFunction%d(%d);\n}\n' % (fi, mi))
+                    else:
+                        src.append('  return m_value + value;\n}\n')
+            src.append('\nint freeFunction%d(int value)\n{\n' % fi)
+            src.append('  // calls into other files to create cross references\n')
+            for _ in range(a.refs if fi > 0 else 0):
+                src.append('  value += freeFunction%d(value - 1);\n' % self.rnd.randrange(fi))
+            src.append('  return value;\n}\n\n')
+            for n in reversed(ns):
+                src.append('} // namespace %s\n' % n)
+            self.write('cpp/%s/file%d.cpp' % ('/'.join(ns), fi), ''.join(src))
+
+            self.headers.append(include)
+            self.classes.extend(c[1] for c in new_classes)
+
+    # ------------------------------------------------------------------
+    # Python
+
+    def gen_python(self):
+        a = self.args
+        modules = []
+        for fi in range(a.python_files):
+            pkg = 'pkg%d' % (fi % a.namespaces)
+            name = 'module%d' % fi
+            out = ['"""Synthetic module %d.\n\nSee also %s.\n"""\n\n' % (fi, ', '.join(self.pick(modules, 3)) or 'nothing')]
+            for mod in self.pick(modules, a.includes):
+                out.append('import %s\n' % mod)
+            out.append('\n')
+            for ci in range(a.classes):
+                cname = 'PyClass%d_%d' % (fi, ci)
+                base = 'PyClass%d_%d' % (fi, ci - 1) if ci > 0 else 'object'
+                out.append('class %s(%s):\n' % (cname, base))
+                out.append('    """Synthetic class %s.\n\n    Derived from %s.\n    """\n\n' % (cname, base))
+                out.append('    def __init__(self, value=%d):\n' % ci)
+                out.append('        """Constructs the object from @p value."""\n')
+                out.append('        self.value = value\n\n')
+                for mi in range(a.members):
+                    out.append('    def method%d(self, other):\n' % mi)
+                    out.append('        """Combines the object with @p other.\n\n')
+                    out.append('        @param other the other object\n        @return the combined value\n        """\n')
+                    out.append('        return self.value + %d * other\n\n' % mi)
+            self.write('python/%s/%s.py' % (pkg, name), ''.join(out))
+            modules.append('%s.%s' % (pkg, name))
+
+    # ------------------------------------------------------------------
+    # Fortran
+
+    def gen_fortran(self):
+        a = self.args
+        modules = []
+        for fi in range(a.fortran_files):
+            name = 'fmod%d' % fi
+            out = ['!> @brief Synthetic Fortran module %d.\n' % fi]
+            out.append('module %s\n' % name)
+            for mod in self.pick(modules, a.includes):
+                out.append('  use %s\n' % mod)
+            out.append('  implicit none\n\n')
+            for ci in range(a.classes):
+                out.append('  !> Synthetic derived type %d.\n' % ci)
+                out.append('  type :: ftype%d_%d\n' % (fi, ci))
+                out.append('    integer :: value = %d !< the stored value\n' % ci)
+                out.append('    real, dimension(%d) :: data !< the stored data\n' % (ci + 1))
+                out.append('  end type ftype%d_%d\n\n' % (fi, ci))
+            out.append('contains\n\n')
+            for mi in range(a.members):
+                out.append('  !> Computes the result %d.\n' % mi)
+                out.append('  !! @param[in] x the input\n  !! @return the result\n')
+                out.append('  function compute%d_%d(x) result(y)\n' % (fi, mi))
+                out.append('    integer, intent(in) :: x\n    integer :: y\n')
+                out.append('    y = x * %d\n' % (mi + 1))
+                out.append('  end function compute%d_%d\n\n' % (fi, mi))
+            out.append('end module %s\n' % name)
+            self.write('fortran/%s.f90' % name, ''.join(out))
+            modules.append(name)
+
+    # ------------------------------------------------------------------
+    # Markdown
+
+    def gen_markdown(self):
+        a = self.args
+        for fi in range(a.markdown_pages):
+            out = ['# Synthetic page %d {#page%d}\n\n' % (fi, fi)]
+            for si in range(a.members):
+                out.append('## Section %d {#page%d_sec%d}\n\n' % (si, fi, si))
+                refs = self.pick(self.classes, 3)
+                out.append('This *section* refers to %s and **emphasises** `code`.\n' %
+                           (', '.join(refs) if refs else 'nothing'))
+                if fi > 0:
+                    out.append('Continue with @ref page%d_sec%d.\n' % (self.rnd.randrange(fi), si))
+                out.append('\n- item one\n- item two with a [link](https://www.doxygen.nl)\n  1. nested\n  2. list\n\n')
+                out.append('| Column | Value |\n|--------|------:|\n| a | %d |\n| b | %d |\n\n' % (si, fi))
+                out.append('```cpp\nint x = %d;\n```\n\n> A quote for section %d.\n\n' % (si, si))
+            self.write('markdown/page%d.md' % fi, ''.join(out))
+
+    def generate(self):
+        if os.path.isdir(self.outdir):
+            shutil.rmtree(self.outdir)
+        os.makedirs(self.outdir)
+        self.gen_cpp()
+        self.gen_python()
+        self.gen_fortran()
+        self.gen_markdown()
+
+
+PRESETS = {
+    # name: cpp_files, python_files, fortran_files, markdown_pages
+    'small':  (50, 10, 10, 10),
+    'medium': (500, 100, 50, 100),
+    'large':  (3000, 500, 200, 500),
+}
+
+def add_arguments(parser):
+    parser.add_argument('--size', choices=sorted(PRESETS), default='small',
+                        help='preset for the number of files (default: small)')
+    parser.add_argument('--seed', type=int, default=1, help='seed for the random generator (default: 1)')
+    parser.add_argument('--cpp-files', type=int, help='number of C++ header/source pairs')
+    parser.add_argument('--python-files', type=int, help='number of Python modules')
+    parser.add_argument('--fortran-files', type=int, help='number of Fortran modules')
+    parser.add_argument('--markdown-pages', type=int, help='number of Markdown pages')
+    parser.add_argument('--classes', type=int, default=5, help='classes per file (default: 5)')
+    parser.add_argument('--members', type=int, default=8, help='members per class (default: 8)')
+    parser.add_argument('--depth', type=int, default=4, help='namespace/directory depth (default: 4)')
+    parser.add_argument('--namespaces', type=int, default=4, help='namespaces per level (default: 4)')
+    parser.add_argument('--includes', type=int, default=8, help='includes/imports per file (default: 8)')
+    parser.add_argument('--refs', type=int, default=6, help='cross references per class (default: 6)')
+    parser.add_argument('--templates', type=float, default=0.3, help='fraction of template classes (default: 0.3)')
+
+def apply_preset(args):
+    cpp, py, f90, md = PRESETS[args.size]
+    if args.cpp_files is None: args.cpp_files = cpp
+    if args.python_files is None: args.python_files = py
+    if args.fortran_files is None: args.fortran_files = f90
+    if args.markdown_pages is None: args.markdown_pages = md
+
+def generate(args):
+    apply_preset(args)
+    corpus = Corpus(args)
+    corpus.generate()
+    return corpus
+
+def main():
+    parser = argparse.ArgumentParser(description='generate a synthetic project to benchmark doxygen')
+    parser.add_argument('--outdir', required=True, help='directory to write the corpus to (is removed first)')
+    add_arguments(parser)
+    args = parser.parse_args()
+    corpus = generate(args)
+    print('Generated %d files (%d bytes) in %s' % (corpus.files, corpus.bytes, args.outdir))
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 1997-2025 by Dimitri van Heesch.
+#
+# Permission to use, copy, modify, and distribute this software and its
+# documentation under the terms of the GNU General Public License is hereby
+# granted. No representations are made about the suitability of this software
+# for any purpose. It is provided "as is" without express or implied warranty.
+# See the GNU General Public License for more details.
+#
+# Documents produced by Doxygen are derivative works derived from the
+# input used in their production; they are not affected by this license.
+
+"""Runs doxygen on a synthetic corpus at several thread counts.
+
+For every run the statistics file (STATISTICS_FILE) written by doxygen is
+collected, and the results of all runs plus the micro-benchmarks of doxybench
+are combined in one JSON report. When a baseline report is given, the
+differences are printed so two revisions can be compared.
+"""
+
+import argparse
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+import generate_corpus
+
+DOXYFILE = """\
+PROJECT_NAME           = "Benchmark"
+OUTPUT_DIRECTORY       = {output}
+INPUT                  = {input}
+RECURSIVE              = YES
+FILE_PATTERNS          = *.h *.cpp *.py *.f90 *.md
+EXTRACT_ALL            = YES
+EXTRACT_PRIVATE        = YES
+EXTRACT_STATIC         = YES
+SOURCE_BROWSER         = YES
+REFERENCED_BY_RELATION = YES
+REFERENCES_RELATION    = YES
+ENABLE_PREPROCESSING   = YES
+SEARCH_INCLUDES        = YES
+INCLUDE_PATH           = {input}/cpp
+QUIET                  = YES
+WARNINGS               = NO
+WARN_IF_UNDOCUMENTED   = NO
+GENERATE_HTML          = YES
+GENERATE_LATEX         = NO
+GENERATE_XML           = {xml}
+HAVE_DOT               = NO
+NUM_PROC_THREADS       = {threads}
+STATISTICS_FILE        = {statistics}
+"""
+
+def run_doxygen(args, corpus_dir, threads, repeat):
+    workdir = os.path.join(args.outdir, 'run_t%d_%d' % (threads, repeat))
+    os.makedirs(workdir, exist_ok=True)
+    statistics = os.path.join(workdir, 'statistics.json')
+    doxyfile = os.path.join(workdir, 'Doxyfile')
+    with open(doxyfile, 'w', encoding='utf-8') as f:
+        f.write(DOXYFILE.format(output=os.path.join(workdir, 'out'), input=corpus_dir,
+                                xml='YES' if args.xml else 'NO',
+                                threads=threads, statistics=statistics))
+    start = time.monotonic()
+    result = subprocess.run([args.doxygen, doxyfile], cwd=workdir,
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    wall = time.monotonic() - start
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr)
+        raise SystemExit('doxygen failed with exit code %d for %d threads' % (result.returncode, threads))
+    with open(statistics, encoding='utf-8') as f:
+        stats = json.load(f)
+    return {
+        'wallSeconds': wall,
+        'elapsedSeconds': stats['elapsedSeconds'],
+        'peakMemoryBytes': stats['peakMemoryBytes'],
+        'phases': {p['name']: p['seconds'] for p in stats['phases']},
+        'memoryLayout': stats.get('memoryLayout', {}),
+    }
+
+def best_of(runs):
+    """The fastest run is the least disturbed by other activity on the machine."""
+    return min(runs, key=lambda r: r['wallSeconds'])
+
+def run_micro(args):
+    if not args.doxybench:
+        return None
+    cmd = [args.doxybench, '--json', '--min-time', str(args.min_time)]
+    result = subprocess.run(cmd, stdout=subprocess.PIPE, text=True)
+    if result.returncode != 0:
+        raise SystemExit('doxybench failed with exit code %d' % result.returncode)
+    return json.loads(result.stdout)
+
+def print_report(report):
+    print('Corpus: %d files, %d bytes' % (report['corpus']['files'], report['corpus']['bytes']))
+    print('%8s %12s %12s %10s %12s' % ('threads', 'wall (s)', 'doxygen (s)', 'speedup', 'peak (MB)'))
+    base = None
+    for threads, run in sorted(report['runs'].items(), key=lambda i: int(i[0])):
+        base = base or run['wallSeconds']
+        print('%8s %12.3f %12.3f %10.2f %12.1f' % (threads, run['wallSeconds'], run['elapsedSeconds'],
+                                                  base / run['wallSeconds'], run['peakMemoryBytes'] / 1e6))
+    layout = report['runs'][max(report['runs'], key=int)].get('memoryLayout', {}) if report['runs'] else {}
+    if layout:
+        print('\n%-12s %10s %10s %14s %14s' % ('symbols', 'objects', 'with data', 'compact (MB)', 'flat (MB)'))
+        for name, l in layout.items():
+            print('%-12s %10d %10d %14.1f %14.1f' % (name, l['objects'], l['withData'],
+                                                    l['compactBytes'] / 1e6, l['flatBytes'] / 1e6))
+    if report.get('micro'):
+        print('\n%-32s %14s' % ('micro-benchmark', 'ns/iteration'))
+        for m in report['micro']['benchmarks']:
+            print('%-32s %14.1f' % (m['name'], m['nsPerIteration']))
+
+def relative(new, old):
+    return '%+7.1f%%' % ((new - old) / old * 100.0) if old else '    n/a'
+
+def compare(report, baseline):
+    print('\nCompared to the baseline:')
+    for threads, run in sorted(report['runs'].items(), key=lambda i: int(i[0])):
+        old = baseline.get('runs', {}).get(threads)
+        if not old:
+            continue
+        print('  %2s threads: wall %s, peak memory %s' % (threads,
+              relative(run['wallSeconds'], old['wallSeconds']),
+              relative(run['peakMemoryBytes'], old['peakMemoryBytes'])))
+        for phase, seconds in run['phases'].items():
+            if phase in old['phases'] and seconds > 0.05:
+                print('      %-48s %s' % (phase, relative(seconds, old['phases'][phase])))
+    old_micro = {m['name']: m for m in (baseline.get('micro') or {}).get('benchmarks', [])}
+    for m in (report.get('micro') or {}).get('benchmarks', []):
+        if m['name'] in old_micro:
+            print('  %-32s %s' % (m['name'], relative(m['nsPerIteration'], old_micro[m['name']]['nsPerIteration'])))
+
+def main():
+    parser = argparse.ArgumentParser(description='benchmark doxygen on a synthetic project')
+    parser.add_argument('--doxygen', required=True, help='doxygen executable to benchmark')
+    parser.add_argument('--doxybench', help='doxybench executable for the micro-benchmarks')
+    parser.add_argument('--outdir', required=True, help='directory for the corpus, the runs and the report')
+    parser.add_argument('--threads', default='1,2,4,8', help='comma separated thread counts (default: 1,2,4,8)')
+    parser.add_argument('--repeat', type=int, default=3, help='runs per thread count, the fastest is reported (default: 3)')
+    parser.add_argument('--xml', action='store_true', help='also generate XML output')
+    parser.add_argument('--min-time', type=float, default=0.5, help='minimum seconds per micro-benchmark (default: 0.5)')
+    parser.add_argument('--baseline', help='earlier report to compare the results with')
+    parser.add_argument('--report', help='report file (default: <outdir>/report.json)')
+    generate_corpus.add_arguments(parser)
+    args = parser.parse_args()
+
+    args.outdir = os.path.abspath(args.outdir)
+    corpus_dir = os.path.join(args.outdir, 'corpus')
+    args.doxygen = os.path.abspath(args.doxygen)
+    gen_args = argparse.Namespace(**vars(args))
+    gen_args.outdir = corpus_dir
+    corpus = generate_corpus.generate(gen_args)
+
+    report = {
+        'machine': {'platform': platform.platform(), 'processor': platform.processor(), 'cpus': os.cpu_count()},
+        'corpus': {'size': args.size, 'seed': args.seed, 'files': corpus.files, 'bytes': corpus.bytes},
+        'runs': {},
+        'micro': run_micro(args),
+    }
+    for threads in [int(t) for t in args.threads.split(',')]:
+        runs = [run_doxygen(args, corpus_dir, threads, i) for i in range(args.repeat)]
+        report['runs'][str(threads)] = best_of(runs)
+
+    report_file = args.report or os.path.join(args.outdir, 'report.json')
+    with open(report_file, 'w', encoding='utf-8') as f:
+        json.dump(report, f, indent=2)
+    print_report(report)
+    if args.baseline:
+        with open(args.baseline, encoding='utf-8') as f:
+            compare(report, json.load(f))
+    print('\nReport written to %s' % report_file)
+
+if __name__ == '__main__':
+    sys.exit(main())
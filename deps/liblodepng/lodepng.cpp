@@ -926,6 +926,100 @@ static unsigned encodeLZ77(uivector* out, const unsigned char* in, size_t size,
 }
 #endif
 
+/*
+Fast LZ77 encoder using zlib style hash chains: every position is hashed on its
+first 3 bytes, and only the most recent maxChain positions with the same hash
+within the window are tested. This bounds the work per byte, unlike the brute
+force search above which tests every offset in the window.
+*/
+static const unsigned CHAIN_HASH_BITS = 15;
+static const unsigned CHAIN_HASH_SIZE = 1u << CHAIN_HASH_BITS;
+static const unsigned CHAIN_NONE = 0xffffffffu;
+
+static unsigned getChainHash(const unsigned char* data, size_t pos)
+{
+  return ((data[pos] << 10) ^ (data[pos + 1] << 5) ^ data[pos + 2]) & (CHAIN_HASH_SIZE - 1);
+}
+
+static void insertChainHash(uivector* head, uivector* prev, const unsigned char* in, size_t size, size_t pos, unsigned windowSize)
+{
+  if(pos + 2 < size)
+  {
+    unsigned hash = getChainHash(in, pos);
+    prev->data[pos % windowSize] = head->data[hash];
+    head->data[hash] = (unsigned)pos;
+  }
+}
+
+static unsigned encodeLZ77_chain(uivector* out, const unsigned char* in, size_t size, unsigned windowSize, unsigned maxChain)
+{
+  uivector head, prev; /*head: most recent position per hash, prev: previous position with the same hash, per window slot*/
+  size_t pos;
+  unsigned error = 0;
+
+  if(windowSize == 0) return 60; /*error: invalid window size*/
+
+  uivector_init(&head);
+  uivector_init(&prev);
+  if(!uivector_resizev(&head, CHAIN_HASH_SIZE, CHAIN_NONE)) error = 9917;
+  if(!error && !uivector_resizev(&prev, windowSize, CHAIN_NONE)) error = 9918;
+
+  for(pos = 0; !error && pos < size; pos++)
+  {
+    size_t length = 0, offset = 0; /*the length and offset found for the current position*/
+
+    if(pos + 2 < size)
+    {
+      unsigned candidate = head.data[getChainHash(in, pos)];
+      unsigned chain = maxChain;
+      while(candidate != CHAIN_NONE && pos - candidate < windowSize && chain > 0)
+      {
+        size_t current_length = 0;
+        unsigned next;
+        while(pos + current_length < size && in[candidate + current_length] == in[pos + current_length] && current_length < MAX_SUPPORTED_DEFLATE_LENGTH)
+        {
+          current_length++;
+        }
+        if(current_length > length)
+        {
+          length = current_length;
+          offset = pos - candidate;
+          if(current_length == MAX_SUPPORTED_DEFLATE_LENGTH) break;
+        }
+        next = prev.data[candidate % windowSize];
+        if(next == CHAIN_NONE || next >= candidate) break; /*end of chain*/
+        candidate = next;
+        chain--;
+      }
+    }
+
+    /**encode it as length/distance pair or literal value**/
+    if(length < 3) /*only lengths of 3 or higher are supported as length/distance pair*/
+    {
+      if(!uivector_push_back(out, in[pos])) error = 9921;
+      insertChainHash(&head, &prev, in, size, pos, windowSize);
+    }
+    else
+    {
+      size_t end = pos + length;
+      addLengthDistance(out, length, offset);
+      for(; pos < end; pos++) insertChainHash(&head, &prev, in, size, pos, windowSize);
+      pos--; /*-1 for loop's pos++*/
+    }
+  }
+
+  uivector_cleanup(&head);
+  uivector_cleanup(&prev);
+  return error;
+}
+
+/*select the LZ77 encoder based on the settings*/
+static unsigned encodeLZ77_select(uivector* out, const unsigned char* in, size_t size, const LodeZlib_DeflateSettings* settings)
+{
+  if(settings->maxChainLength > 0) return encodeLZ77_chain(out, in, size, settings->windowSize, settings->maxChainLength);
+  return encodeLZ77(out, in, size, settings->windowSize);
+}
+
 /* /////////////////////////////////////////////////////////////////////////// */
 
 static unsigned deflateNoCompression(ucvector* out, const unsigned char* data, size_t datasize)
@@ -1035,7 +1129,7 @@ static unsigned deflateDynamic(ucvector* out, const unsigned char* data, size_t
   {
     if(settings->useLZ77)
     {
-      error = encodeLZ77(&lz77_encoded, data, datasize, settings->windowSize); /*LZ77 encoded*/
+      error = encodeLZ77_select(&lz77_encoded, data, datasize, settings); /*LZ77 encoded*/
       if(error) break;
     }
     else
@@ -1189,7 +1283,7 @@ static unsigned deflateFixed(ucvector* out, const unsigned char* data, size_t da
   {
     uivector lz77_encoded;
     uivector_init(&lz77_encoded);
-    error = encodeLZ77(&lz77_encoded, data, datasize, settings->windowSize);
+    error = encodeLZ77_select(&lz77_encoded, data, datasize, settings);
     if(!error) writeLZ77data(&bp, out, &lz77_encoded, &codes, &codesD);
     uivector_cleanup(&lz77_encoded);
   }
@@ -1311,6 +1405,7 @@ void LodeZlib_DeflateSettings_init(LodeZlib_DeflateSettings* settings)
   settings->btype = 2; /*compress with dynamic huffman tree (not in the mathematical sense, just not the predefined one)*/
   settings->useLZ77 = 1;
   settings->windowSize = 2048; /*this is a good tradeoff between speed and compression ratio*/
+  settings->maxChainLength = 0; /*exhaustive search within the window*/
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -1346,25 +1441,37 @@ static unsigned LodePNG_compress(unsigned char** out, size_t* outsize, const uns
 /* / CRC32                                                                  / */
 /* ////////////////////////////////////////////////////////////////////////// */
 
-static unsigned Crc32_crc_table_computed = 0;
-static unsigned Crc32_crc_table[256];
-
-/*Make the table for a fast CRC.*/
-static void Crc32_make_crc_table(void)
+/*Table for a fast CRC, using slicing-by-4: entry [k][n] is the CRC of byte n followed by k zero bytes.
+It is filled by a static initializer, so that concurrent encoders do not race on lazily computing it.*/
+struct Crc32_table
 {
-  unsigned int c, k, n;
-  for(n = 0; n < 256; n++)
+  unsigned data[4][256];
+  Crc32_table()
   {
-    c = n;
-    for(k = 0; k < 8; k++)
+    unsigned int c, k, n;
+    for(n = 0; n < 256; n++)
+    {
+      c = n;
+      for(k = 0; k < 8; k++)
+      {
+        if(c & 1) c = (unsigned int)(0xedb88320L ^ (c >> 1));
+        else c = c >> 1;
+      }
+      data[0][n] = c;
+    }
+    for(n = 0; n < 256; n++)
     {
-      if(c & 1) c = (unsigned int)(0xedb88320L ^ (c >> 1));
-      else c = c >> 1;
+      c = data[0][n];
+      for(k = 1; k < 4; k++)
+      {
+        c = data[0][c & 0xff] ^ (c >> 8);
+        data[k][n] = c;
+      }
     }
-    Crc32_crc_table[n] = c;
   }
-  Crc32_crc_table_computed = 1;
-}
+};
+
+static const Crc32_table Crc32_crc_table;
 
 /*Update a running CRC with the bytes buf[0..len-1]--the CRC should be
 initialized to all 1's, and the transmitted value is the 1's complement of the
@@ -1372,12 +1479,19 @@ final running CRC (see the crc() routine below).*/
 static unsigned Crc32_update_crc(const unsigned char* buf, unsigned int crc, size_t len)
 {
   unsigned int c = crc;
-  size_t n;
+  const unsigned (*t)[256] = Crc32_crc_table.data;
 
-  if(!Crc32_crc_table_computed) Crc32_make_crc_table();
-  for(n = 0; n < len; n++)
+  while(len >= 4)
+  {
+    c ^= (unsigned)buf[0] | ((unsigned)buf[1] << 8) | ((unsigned)buf[2] << 16) | ((unsigned)buf[3] << 24);
+    c = t[3][c & 0xff] ^ t[2][(c >> 8) & 0xff] ^ t[1][(c >> 16) & 0xff] ^ t[0][c >> 24];
+    buf += 4;
+    len -= 4;
+  }
+  while(len > 0)
   {
-    c = Crc32_crc_table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
+    c = t[0][(c ^ *buf++) & 0xff] ^ (c >> 8);
+    len--;
   }
   return c;
 }
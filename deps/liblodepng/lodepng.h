@@ -47,6 +47,7 @@ typedef struct LodeZlib_DeflateSettings /*deflate = compress*/
   unsigned btype; /*the block type for LZ*/
   unsigned useLZ77; /*whether or not to use LZ77*/
   unsigned windowSize; /*the maximum is 32768*/
+  unsigned maxChainLength; /*0 for an exhaustive search of the window, otherwise the maximum number of hash chain matches to test per position (faster)*/
 } LodeZlib_DeflateSettings;
 
 
@@ -0,0 +1,142 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "construct.h"
+
+/** @brief Monotonic memory arena.
+ *
+ *  Memory is handed out from large blocks by bumping a pointer, and is only
+ *  released when the arena itself is destroyed. This makes it suitable for
+ *  data structures that are built once and then freed as a whole, such as
+ *  the abstract syntax tree of a documentation block.
+ *
+ *  The arena is not thread safe.
+ */
+class Arena
+{
+  public:
+    Arena() = default;
+    NON_COPYABLE(Arena)
+
+    /** Returns \a size bytes of memory aligned to \a alignment. */
+    void *allocate(size_t size,size_t alignment)
+    {
+      size_t offset = (m_used+alignment-1) & ~(alignment-1);
+      if (m_blocks.empty() || offset+size>m_blockSize)
+      {
+        addBlock(size+alignment);
+        offset = (m_used+alignment-1) & ~(alignment-1);
+      }
+      m_used = offset+size;
+      m_bytesAllocated += size;
+      return m_blocks.back().get()+offset;
+    }
+
+    /** Returns the number of bytes handed out so far */
+    size_t bytesAllocated() const { return m_bytesAllocated; }
+
+    /** Returns the number of blocks allocated from the heap so far */
+    size_t numBlocks() const { return m_blocks.size(); }
+
+    /** Returns the arena new objects of the calling thread should be allocated from,
+     *  or nullptr if they should be allocated from the heap.
+     */
+    static Arena *current() { return currentRef(); }
+
+    /** Makes an arena the current arena of the calling thread during the lifetime of
+     *  this object.
+     */
+    class Scope
+    {
+      public:
+        explicit Scope(Arena *arena) : m_previous(currentRef()) { currentRef()=arena; }
+       ~Scope() { currentRef()=m_previous; }
+        NON_COPYABLE(Scope)
+      private:
+        Arena *m_previous;
+    };
+
+  private:
+    static constexpr size_t minBlockSize = 16*1024;
+    static constexpr size_t maxBlockSize = 1024*1024;
+
+    static Arena *&currentRef()
+    {
+      thread_local Arena *arena = nullptr;
+      return arena;
+    }
+
+    void addBlock(size_t minSize)
+    {
+      // grow the block size with the number of blocks, so small documents need a single
+      // small block and large documents only need a few blocks
+      m_blockSize = std::max(minSize,m_blocks.empty() ? minBlockSize : std::min(2*m_blockSize,maxBlockSize));
+      m_blocks.push_back(std::make_unique<char[]>(m_blockSize));
+      m_used = 0;
+    }
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    size_t m_blockSize = 0;
+    size_t m_used = 0;
+    size_t m_bytesAllocated = 0;
+};
+
+/** @brief Allocator that allocates from an Arena, or from the heap if no arena is given.
+ *
+ *  Deallocating memory from an arena is a no-op, the memory is released when the
+ *  arena is destroyed.
+ */
+template<class T>
+class ArenaAllocator
+{
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator(Arena *arena=nullptr) noexcept : m_arena(arena) {}
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : m_arena(other.arena()) {}
+
+    T *allocate(size_t n)
+    {
+      return m_arena ? static_cast<T*>(m_arena->allocate(n*sizeof(T),alignof(T)))
+                     : std::allocator<T>().allocate(n);
+    }
+    void deallocate(T *p,size_t n)
+    {
+      if (m_arena==nullptr) std::allocator<T>().deallocate(p,n);
+    }
+
+    Arena *arena() const { return m_arena; }
+
+    friend bool operator==(const ArenaAllocator &a1,const ArenaAllocator &a2) { return a1.m_arena==a2.m_arena; }
+    friend bool operator!=(const ArenaAllocator &a1,const ArenaAllocator &a2) { return a1.m_arena!=a2.m_arena; }
+
+  private:
+    Arena *m_arena;
+};
+
+#endif
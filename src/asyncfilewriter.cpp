@@ -0,0 +1,180 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "asyncfilewriter.h"
+#include "config.h"
+#include "fileinfo.h"
+#include "message.h"
+#include "portable.h"
+#include "threadpool.h"
+
+//! maximum number of bytes that can be queued before write() blocks
+static const size_t maxPendingBytes = 64*1024*1024;
+
+//! Returns true if the file \a fileName exists and has exactly the given \a contents.
+static bool hasSameContents(const QCString &fileName,const std::string &contents)
+{
+  FileInfo fi(fileName.str());
+  if (!fi.exists() || !fi.isFile() || fi.size()!=contents.size()) return false;
+  std::ifstream f = Portable::openInputStream(fileName,true);
+  if (!f.is_open()) return false;
+  const size_t chunkSize = 64*1024;
+  std::vector<char> buf(chunkSize);
+  size_t pos = 0;
+  while (pos<contents.size())
+  {
+    size_t len = std::min(chunkSize,contents.size()-pos);
+    if (!f.read(buf.data(),static_cast<std::streamsize>(len)) ||
+        memcmp(buf.data(),contents.data()+pos,len)!=0)
+    {
+      return false;
+    }
+    pos+=len;
+  }
+  return true;
+}
+
+//! Writes \a contents to the file \a fileName, returns false if the file could not be opened.
+static bool writeFile(const QCString &fileName,const std::string &contents)
+{
+  if (hasSameContents(fileName,contents)) return true; // keep the existing file and its time stamp
+
+  FILE *f = Portable::fopen(fileName,"wb");
+  if (f==nullptr)
+  {
+    return false;
+  }
+  if (!contents.empty() && fwrite(contents.data(),1,contents.size(),f)!=contents.size())
+  {
+    err("Failed to write {} bytes to file {}\n",contents.size(),fileName);
+  }
+  Portable::fclose(f);
+  return true;
+}
+
+struct AsyncFileWriter::Private
+{
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t pendingBytes = 0;
+  size_t pendingFiles = 0;
+  // files queued by write(), which take precedence over files queued by writeIfAbsent()
+  std::unordered_set<std::string> writtenFiles;
+  // first file that could not be opened, reported by checkFailure()
+  QCString failedFile;
+  // each writer is a pool with a single thread, so files assigned to it are written in order
+  std::vector< std::unique_ptr<ThreadPool> > writers;
+};
+
+AsyncFileWriter &AsyncFileWriter::instance()
+{
+  static AsyncFileWriter theInstance;
+  return theInstance;
+}
+
+AsyncFileWriter::AsyncFileWriter() : p(std::make_unique<Private>())
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+  std::unique_lock<std::mutex> lock(p->mutex);
+  p->cond.wait(lock,[&]{ return p->pendingFiles==0; });
+}
+
+void AsyncFileWriter::write(const QCString &fileName,std::string &&contents)
+{
+  queue(fileName,std::move(contents),false);
+}
+
+void AsyncFileWriter::writeIfAbsent(const QCString &fileName,std::string &&contents)
+{
+  queue(fileName,std::move(contents),true);
+}
+
+void AsyncFileWriter::queue(const QCString &fileName,std::string &&contents,bool ifAbsent)
+{
+  checkFailure();
+  size_t size = contents.size();
+  ThreadPool *writer = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(p->mutex);
+    if (!ifAbsent) p->writtenFiles.insert(fileName.str());
+    if (p->writers.empty())
+    {
+      std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+      if (numThreads<1) numThreads=1;
+      for (size_t i=0;i<numThreads;i++)
+      {
+        p->writers.push_back(std::make_unique<ThreadPool>(1));
+      }
+    }
+    // back-pressure: wait until the writers have caught up
+    p->cond.wait(lock,[&]{ return p->pendingBytes==0 || p->pendingBytes+size<=maxPendingBytes; });
+    p->pendingBytes+=size;
+    p->pendingFiles++;
+    writer = p->writers[std::hash<std::string>()(fileName.str()) % p->writers.size()].get();
+  }
+  writer->queue([this,fileName,size,ifAbsent,data=std::move(contents)]()
+  {
+    // all writes to one file are done by the same writer in queue order, so a file queued
+    // by write() after this one still overwrites it
+    bool skip = false;
+    if (ifAbsent)
+    {
+      std::lock_guard<std::mutex> lock(p->mutex);
+      skip = p->writtenFiles.find(fileName.str())!=p->writtenFiles.end() || FileInfo(fileName.str()).exists();
+    }
+    bool ok = skip || writeFile(fileName,data);
+    {
+      std::lock_guard<std::mutex> lock(p->mutex);
+      if (!ok && p->failedFile.isEmpty()) p->failedFile = fileName;
+      p->pendingBytes-=size;
+      p->pendingFiles--;
+    }
+    p->cond.notify_all();
+  });
+}
+
+void AsyncFileWriter::waitForCompletion()
+{
+  {
+    std::unique_lock<std::mutex> lock(p->mutex);
+    p->cond.wait(lock,[&]{ return p->pendingFiles==0; });
+  }
+  checkFailure();
+}
+
+void AsyncFileWriter::checkFailure()
+{
+  QCString fileName;
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    fileName = p->failedFile;
+    p->failedFile.clear();
+  }
+  if (!fileName.isEmpty())
+  {
+    // same as when the file was opened directly by the output generator
+    term("Could not open file {} for writing\n",fileName);
+  }
+}
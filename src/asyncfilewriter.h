@@ -0,0 +1,63 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef ASYNCFILEWRITER_H
+#define ASYNCFILEWRITER_H
+
+#include <memory>
+#include <string>
+
+#include "qcstring.h"
+#include "construct.h"
+
+/** Singleton that writes completed output files on dedicated writer threads,
+ *  so that the threads rendering the pages do not wait for the file system.
+ *
+ *  Files are assigned to a writer based on their name, so multiple writes
+ *  to the same file are performed in the order in which they were queued.
+ *  When too much data is pending, write() blocks until the writers catch up.
+ *  A file is not rewritten if it already has the requested contents.
+ *  If a file cannot be opened, doxygen is terminated from the next call to
+ *  write() or waitForCompletion(), on the thread making that call.
+ */
+class AsyncFileWriter
+{
+  public:
+    static AsyncFileWriter &instance();
+
+    /** Queues \a contents to be written to the file \a fileName. */
+    void write(const QCString &fileName,std::string &&contents);
+
+    /** Queues \a contents to be written to the file \a fileName, unless that file
+     *  already exists or is also queued by write(), in which case the other file wins.
+     *  Used for secondary files, such as man page links, that share names with pages.
+     */
+    void writeIfAbsent(const QCString &fileName,std::string &&contents);
+
+    /** Blocks until all queued files have been written. */
+    void waitForCompletion();
+
+  private:
+    AsyncFileWriter();
+   ~AsyncFileWriter();
+    NON_COPYABLE(AsyncFileWriter)
+    void queue(const QCString &fileName,std::string &&contents,bool ifAbsent);
+    void checkFailure();
+
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+#endif
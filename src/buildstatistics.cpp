@@ -0,0 +1,209 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#include "buildstatistics.h"
+#include "config.h"
+#include "debug.h"
+#include "definitionimpl.h"
+#include "doxygen.h"
+#include "lazydata.h"
+#include "memberdef.h"
+#include "message.h"
+#include "portable.h"
+#include "util.h"
+#include "version.h"
+
+namespace
+{
+
+struct Item
+{
+  QCString category;
+  QCString name;
+  double seconds;
+  size_t size;
+};
+
+//! maximum number of dot graphs listed in the report
+const size_t maxDotGraphs = 100;
+
+void sortBySeconds(std::vector<Item> &items)
+{
+  std::stable_sort(items.begin(),items.end(),[](const auto &i1,const auto &i2) { return i1.seconds>i2.seconds; });
+}
+
+QCString jsonString(const QCString &s)
+{
+  return "\""+convertToJSONString(s.str())+"\"";
+}
+
+template<class T>
+void writeCacheStats(std::ostream &t,const char *name,const T &cache)
+{
+  t << "    " << jsonString(name) << ": { "
+    << "\"size\": "     << cache.size()     << ", "
+    << "\"capacity\": " << cache.capacity() << ", "
+    << "\"hits\": "     << cache.hits()     << ", "
+    << "\"misses\": "   << cache.misses()   << " },\n";
+}
+
+void writeLayoutStats(std::ostream &t,const char *name,const LazyDataStats &stats,bool last)
+{
+  t << "    " << jsonString(name) << ": { "
+    << "\"objects\": "      << stats.objects      << ", "
+    << "\"withData\": "     << stats.withData     << ", "
+    << "\"compactBytes\": " << stats.compactBytes << ", "
+    << "\"flatBytes\": "    << stats.flatBytes    << " }" << (last ? "\n" : ",\n");
+}
+
+} // namespace
+
+struct BuildStatistics::Private
+{
+  std::mutex mutex;
+  std::vector<std::pair<QCString,double>> phases;
+  std::vector<Item> inputFiles;
+  std::vector<Item> compounds;
+  std::vector<Item> dotGraphs;
+};
+
+BuildStatistics::BuildStatistics() : p(std::make_unique<Private>())
+{
+}
+
+BuildStatistics::~BuildStatistics() = default;
+
+BuildStatistics &BuildStatistics::instance()
+{
+  static BuildStatistics theInstance;
+  return theInstance;
+}
+
+bool BuildStatistics::isEnabled()
+{
+  return !Config_getString(STATISTICS_FILE).isEmpty();
+}
+
+void BuildStatistics::addPhase(const QCString &name,double seconds)
+{
+  if (!isEnabled()) return;
+  std::lock_guard<std::mutex> lock(p->mutex);
+  p->phases.emplace_back(name,seconds);
+}
+
+void BuildStatistics::add(Kind kind,const QCString &category,const QCString &name,TimePoint start,size_t size)
+{
+  if (!isEnabled()) return;
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+  std::lock_guard<std::mutex> lock(p->mutex);
+  switch (kind)
+  {
+    case Kind::InputFile: p->inputFiles.push_back(Item{category,name,seconds,size}); break;
+    case Kind::Compound:  p->compounds.push_back(Item{category,name,seconds,size});  break;
+    case Kind::DotGraph:  p->dotGraphs.push_back(Item{category,name,seconds,size});  break;
+  }
+}
+
+void BuildStatistics::write(int idealLookupCacheSize)
+{
+  if (!isEnabled()) return;
+  QCString fileName = Config_getString(STATISTICS_FILE);
+  std::ofstream t = Portable::openOutputStream(fileName);
+  if (!t.is_open())
+  {
+    err("Could not open file {} for writing\n",fileName);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(p->mutex);
+  sortBySeconds(p->inputFiles);
+  sortBySeconds(p->compounds);
+  sortBySeconds(p->dotGraphs);
+  if (p->dotGraphs.size()>maxDotGraphs) p->dotGraphs.resize(maxDotGraphs);
+
+  t << std::fixed << std::setprecision(6);
+  t << "{\n";
+  t << "  \"version\": " << jsonString(getFullVersion()) << ",\n";
+  t << "  \"threads\": " << Config_getInt(NUM_PROC_THREADS) << ",\n";
+  t << "  \"elapsedSeconds\": " << Debug::elapsedTime() << ",\n";
+  t << "  \"peakMemoryBytes\": " << Portable::peakMemoryUsage() << ",\n";
+
+  t << "  \"phases\": [\n";
+  for (size_t i=0; i<p->phases.size(); i++)
+  {
+    const auto &[name,seconds] = p->phases[i];
+    t << "    { \"name\": " << jsonString(name.stripWhiteSpace()) << ", \"seconds\": " << seconds << " }"
+      << (i+1<p->phases.size() ? ",\n" : "\n");
+  }
+  t << "  ],\n";
+
+  t << "  \"inputFiles\": [\n";
+  for (size_t i=0; i<p->inputFiles.size(); i++)
+  {
+    const Item &item = p->inputFiles[i];
+    t << "    { \"file\": " << jsonString(item.name) << ", \"size\": " << item.size
+      << ", \"seconds\": " << item.seconds << " }" << (i+1<p->inputFiles.size() ? ",\n" : "\n");
+  }
+  t << "  ],\n";
+
+  t << "  \"compounds\": [\n";
+  for (size_t i=0; i<p->compounds.size(); i++)
+  {
+    const Item &item = p->compounds[i];
+    t << "    { \"kind\": " << jsonString(item.category) << ", \"name\": " << jsonString(item.name)
+      << ", \"seconds\": " << item.seconds << " }" << (i+1<p->compounds.size() ? ",\n" : "\n");
+  }
+  t << "  ],\n";
+
+  t << "  \"slowestDotGraphs\": [\n";
+  for (size_t i=0; i<p->dotGraphs.size(); i++)
+  {
+    const Item &item = p->dotGraphs[i];
+    t << "    { \"file\": " << jsonString(item.name) << ", \"seconds\": " << item.seconds << " }"
+      << (i+1<p->dotGraphs.size() ? ",\n" : "\n");
+  }
+  t << "  ],\n";
+
+  auto [findFileHits,findFileMisses] = findFileDefCacheHitsAndMisses();
+  t << "  \"caches\": {\n";
+  writeCacheStats(t,"typeLookupCache",*Doxygen::typeLookupCache);
+  writeCacheStats(t,"symbolLookupCache",*Doxygen::symbolLookupCache);
+  t << "    \"findFileDefCache\": { \"hits\": " << findFileHits << ", \"misses\": " << findFileMisses << " },\n";
+  t << "    \"idealLookupCacheSize\": " << idealLookupCacheSize << "\n";
+  t << "  },\n";
+
+  // the fixed size part of the symbols, with the rarely used fields allocated on demand
+  // (compactBytes) and as it would be with all fields stored inline (flatBytes)
+  t << "  \"memoryLayout\": {\n";
+  writeLayoutStats(t,"definitions",DefinitionImpl::lazyDataStats(),false);
+  writeLayoutStats(t,"members",memberDefLazyDataStats(),true);
+  t << "  },\n";
+
+  auto tools = Portable::getSysToolTimes();
+  t << "  \"externalTools\": [\n";
+  for (size_t i=0; i<tools.size(); i++)
+  {
+    const auto &tt = tools[i];
+    t << "    { \"tool\": " << jsonString(tt.tool) << ", \"calls\": " << tt.calls
+      << ", \"seconds\": " << tt.elapsed << ", \"maxSeconds\": " << tt.maxElapsed << " }"
+      << (i+1<tools.size() ? ",\n" : "\n");
+  }
+  t << "  ]\n";
+  t << "}\n";
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef BUILDSTATISTICS_H
+#define BUILDSTATISTICS_H
+
+#include <chrono>
+#include <memory>
+
+#include "qcstring.h"
+#include "construct.h"
+
+/** Singleton collecting the costs of a run for the report written to
+ *  \c STATISTICS_FILE. All methods are thread safe. Nothing is collected
+ *  when no statistics file is configured.
+ */
+class BuildStatistics
+{
+  public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    enum class Kind
+    {
+      InputFile, //!< parsing an input file, name is the file name
+      Compound,  //!< generating the documentation of a compound, category is its kind
+      DotGraph   //!< running dot, name is the dot file
+    };
+
+    static BuildStatistics &instance();
+    static bool isEnabled();
+
+    /** Records the duration of processing phase \a name. */
+    void addPhase(const QCString &name,double seconds);
+
+    /** Records an item of \a kind that took from \a start until now, with an optional \a size in bytes. */
+    void add(Kind kind,const QCString &category,const QCString &name,TimePoint start,size_t size=0);
+
+    /** Writes the report to the file set with \c STATISTICS_FILE.
+     *  @param idealLookupCacheSize the value for \c LOOKUP_CACHE_SIZE based on the cache misses
+     */
+    void write(int idealLookupCacheSize);
+
+  private:
+    BuildStatistics();
+   ~BuildStatistics();
+    NON_COPYABLE(BuildStatistics)
+
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
+/** Records the time between its construction and destruction in the BuildStatistics. */
+class BuildStatisticsTimer
+{
+  public:
+    BuildStatisticsTimer(BuildStatistics::Kind kind,const char *category,const QCString &name)
+      : m_enabled(BuildStatistics::isEnabled())
+    {
+      if (m_enabled)
+      {
+        m_kind     = kind;
+        m_category = category;
+        m_name     = name;
+        m_start    = std::chrono::steady_clock::now();
+      }
+    }
+   ~BuildStatisticsTimer()
+    {
+      if (m_enabled)
+      {
+        BuildStatistics::instance().add(m_kind,m_category,m_name,m_start,m_size);
+      }
+    }
+    NON_COPYABLE(BuildStatisticsTimer)
+
+    void setSize(size_t size) { m_size = size; }
+
+  private:
+    bool m_enabled;
+    BuildStatistics::Kind m_kind = BuildStatistics::Kind::InputFile;
+    const char *m_category = "";
+    QCString m_name;
+    size_t m_size = 0;
+    BuildStatistics::TimePoint m_start;
+};
+
+#endif
@@ -917,6 +917,25 @@ void ClangTUParser::writeSources(OutputCodeList &ol,const FileDef *fd)
   p->tooltipManager.writeTooltips(ol);
 }
 
+size_t ClangTUParser::memoryUsage() const
+{
+  size_t total = 0;
+  if (p->tu)
+  {
+    CXTUResourceUsage usage = clang_getCXTUResourceUsage(p->tu);
+    for (unsigned i=0;i<usage.numEntries;i++)
+    {
+      total += usage.entries[i].amount;
+    }
+    clang_disposeCXTUResourceUsage(usage);
+    for (const auto &src : p->sources)
+    {
+      total += src.length();
+    }
+  }
+  return total;
+}
+
 //--------------------------------------------------------------------------
 
 class ClangParser::Private
@@ -936,6 +955,16 @@ class ClangParser::Private
     }
 
     std::unique_ptr<clang::tooling::CompilationDatabase> db;
+
+    // translation units kept between parsing the input and generating the sources
+    std::mutex tuCacheMutex;
+    struct CachedTU
+    {
+      std::unique_ptr<ClangTUParser> tuParser;
+      size_t size;
+    };
+    std::unordered_map<const FileDef *,CachedTU> tuCache;
+    size_t tuCacheSize = 0;
 };
 
 const clang::tooling::CompilationDatabase *ClangParser::database() const
@@ -957,6 +986,40 @@ std::unique_ptr<ClangTUParser> ClangParser::createTUParser(const FileDef *fd) co
   return std::make_unique<ClangTUParser>(*this,fd);
 }
 
+void ClangParser::keepTUParser(const FileDef *fd,std::unique_ptr<ClangTUParser> tuParser) const
+{
+  if (!tuParser) return;
+  size_t budget = static_cast<size_t>(Config_getInt(CLANG_TU_CACHE_SIZE))*1024*1024;
+  if (budget==0) return; // reuse disabled
+  size_t size = tuParser->memoryUsage();
+  if (size==0) return; // not parsed successfully
+  std::lock_guard<std::mutex> lock(p->tuCacheMutex);
+  if (p->tuCacheSize+size<=budget && p->tuCache.find(fd)==p->tuCache.end())
+  {
+    p->tuCacheSize += size;
+    p->tuCache.emplace(fd,Private::CachedTU{std::move(tuParser),size});
+  }
+  // otherwise tuParser is destroyed here and the file will be parsed again when needed
+}
+
+std::unique_ptr<ClangTUParser> ClangParser::takeTUParser(const FileDef *fd) const
+{
+  std::lock_guard<std::mutex> lock(p->tuCacheMutex);
+  auto it = p->tuCache.find(fd);
+  if (it==p->tuCache.end()) return nullptr;
+  std::unique_ptr<ClangTUParser> tuParser = std::move(it->second.tuParser);
+  p->tuCacheSize -= it->second.size;
+  p->tuCache.erase(it);
+  return tuParser;
+}
+
+void ClangParser::clearTUParsers() const
+{
+  std::lock_guard<std::mutex> lock(p->tuCacheMutex);
+  p->tuCache.clear();
+  p->tuCacheSize = 0;
+}
+
 
 //--------------------------------------------------------------------------
 #else // use stubbed functionality in case libclang support is disabled.
@@ -986,6 +1049,11 @@ std::string ClangTUParser::lookup(uint32_t,const char *)
   return std::string();
 }
 
+size_t ClangTUParser::memoryUsage() const
+{
+  return 0;
+}
+
 class ClangParser::Private
 {
 };
@@ -1003,6 +1071,19 @@ std::unique_ptr<ClangTUParser> ClangParser::createTUParser(const FileDef *) cons
   return nullptr;
 }
 
+void ClangParser::keepTUParser(const FileDef *,std::unique_ptr<ClangTUParser>) const
+{
+}
+
+std::unique_ptr<ClangTUParser> ClangParser::takeTUParser(const FileDef *) const
+{
+  return nullptr;
+}
+
+void ClangParser::clearTUParsers() const
+{
+}
+
 #endif
 //--------------------------------------------------------------------------
 
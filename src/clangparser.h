@@ -52,6 +52,11 @@ class ClangTUParser
      */
     void writeSources(OutputCodeList &ol,const FileDef *fd);
 
+    /** Returns the approximate amount of memory in bytes used by the parsed translation unit,
+     *  or 0 if no translation unit was parsed.
+     */
+    size_t memoryUsage() const;
+
   private:
     void detectFunctionBody(const char *s);
     void writeLineNumber(OutputCodeList &ol,const FileDef *fd,uint32_t line,bool writeLineAnchor);
@@ -84,6 +89,20 @@ class ClangParser
     static ClangParser *instance();
     std::unique_ptr<ClangTUParser> createTUParser(const FileDef *fd) const;
 
+    /** Keeps the already parsed translation unit \a tuParser of file \a fd, so it
+     *  can be reused later via takeTUParser(). If keeping it would exceed the memory budget
+     *  set by CLANG_TU_CACHE_SIZE, the translation unit is discarded instead.
+     */
+    void keepTUParser(const FileDef *fd,std::unique_ptr<ClangTUParser> tuParser) const;
+
+    /** Returns the translation unit of file \a fd kept by keepTUParser(), or nullptr
+     *  if there is none. The returned object is already parsed.
+     */
+    std::unique_ptr<ClangTUParser> takeTUParser(const FileDef *fd) const;
+
+    /** Discards all translation units that are still kept */
+    void clearTUParsers() const;
+
   private:
     const clang::tooling::CompilationDatabase *database() const;
     class Private;
@@ -15,6 +15,8 @@
 
 #include <cstdio>
 #include <algorithm>
+#include <atomic>
+#include <unordered_map>
 
 #include "types.h"
 #include "classdef.h"
@@ -794,6 +796,113 @@ std::unique_ptr<ClassDef> createClassDefAlias(const Definition *newScope,const C
   return acd;
 }
 
+//----------------------------------------------------------------------
+// Inheritance closure index
+//
+// Once the class hierarchy is complete, the transitive set of base classes
+// of every class is computed once together with the shortest distance to
+// each of them. isBaseClass() and minClassDistance() are then answered with
+// a single lookup instead of a walk over the hierarchy. Any change to the
+// hierarchy after the index has been built invalidates it, in which case the
+// recursive walk is used again until the index is rebuilt.
+
+class InheritanceIndex
+{
+  public:
+    static InheritanceIndex &instance()
+    {
+      static InheritanceIndex theInstance;
+      return theInstance;
+    }
+    void build();
+    void invalidate() { m_valid = false; }
+    /** Returns the distance from \a cd to base class \a bcd (0 if \a bcd is not a base class)
+     *  or -1 if the index cannot answer the query.
+     */
+    int distance(const ClassDef *cd,const ClassDef *bcd,bool followInstances) const
+    {
+      if (!m_valid) return -1;
+      const auto &map = m_ancestors[followInstances ? 1 : 0];
+      auto it = map.find(cd);
+      if (it==map.end()) return -1;
+      auto dit = it->second.find(bcd);
+      return dit!=it->second.end() ? dit->second : 0;
+    }
+  private:
+    using DistanceMap = std::unordered_map<const ClassDef *,int>;
+    using AncestorMap = std::unordered_map<const ClassDef *,DistanceMap>;
+    enum class State { Busy, Done };
+    bool computeAncestors(const ClassDef *cd,bool followInstances,
+                          std::unordered_map<const ClassDef *,State> &state);
+    std::atomic<bool> m_valid = false;
+    AncestorMap m_ancestors[2];
+};
+
+bool InheritanceIndex::computeAncestors(const ClassDef *cd,bool followInstances,
+                                        std::unordered_map<const ClassDef *,State> &state)
+{
+  auto it = state.find(cd);
+  if (it!=state.end())
+  {
+    return it->second==State::Done; // Busy means a recursive class relation
+  }
+  state.emplace(cd,State::Busy);
+  DistanceMap distances;
+  for (const auto &bclass : cd->baseClasses())
+  {
+    const ClassDef *ccd = bclass.classDef;
+    if (!followInstances && ccd->templateMaster())
+    {
+      ccd=ccd->templateMaster();
+    }
+    if (!computeAncestors(ccd,followInstances,state)) return false;
+    distances[ccd] = 1;
+    for (const auto &[acd,d] : m_ancestors[followInstances ? 1 : 0][ccd])
+    {
+      if (d+1>256) return false; // leave it to the recursive walk to report this
+      auto dit = distances.find(acd);
+      if (dit==distances.end() || d+1<dit->second)
+      {
+        distances[acd] = d+1;
+      }
+    }
+  }
+  m_ancestors[followInstances ? 1 : 0][cd] = std::move(distances);
+  state[cd] = State::Done;
+  return true;
+}
+
+void InheritanceIndex::build()
+{
+  if (m_valid) return;
+  bool ok = true;
+  for (int i=0; i<2 && ok; i++)
+  {
+    bool followInstances = i==1;
+    m_ancestors[i].clear();
+    std::unordered_map<const ClassDef *,State> state;
+    for (const auto &cd : *Doxygen::classLinkedMap)
+    {
+      if (!(ok=computeAncestors(cd.get(),followInstances,state))) break;
+    }
+    for (const auto &cd : *Doxygen::hiddenClassLinkedMap)
+    {
+      if (!ok || !(ok=computeAncestors(cd.get(),followInstances,state))) break;
+    }
+  }
+  if (!ok)
+  {
+    m_ancestors[0].clear();
+    m_ancestors[1].clear();
+  }
+  m_valid = ok;
+}
+
+void buildClassInheritanceIndex()
+{
+  InheritanceIndex::instance().build();
+}
+
 //-----------------------------------------------------------------------------
 
 // constructs a new class definition
@@ -997,6 +1106,7 @@ void ClassDefImpl::insertBaseClass(ClassDef *cd,const QCString &n,Protection p,
 {
   //printf("*** insert base class %s into %s\n",qPrint(cd->name()),qPrint(name()));
   m_inherits.emplace_back(cd,n,p,s,t);
+  InheritanceIndex::instance().invalidate();
   m_isSimple = FALSE;
 }
 
@@ -3675,6 +3785,11 @@ bool ClassDefImpl::hasDocumentation() const
 
 int ClassDefImpl::isBaseClass(const ClassDef *bcd, bool followInstances,const QCString &templSpec) const
 {
+  if (templSpec.isEmpty())
+  {
+    int d = InheritanceIndex::instance().distance(this,bcd,followInstances);
+    if (d>=0) return d;
+  }
   int distance=0;
   //printf("isBaseClass(cd=%s) looking for %s templSpec=%s\n",qPrint(name()),qPrint(bcd->name()),qPrint(templSpec));
   for (const auto &bclass : baseClasses())
@@ -4987,6 +5102,7 @@ const BaseClassList &ClassDefImpl::baseClasses() const
 void ClassDefImpl::updateBaseClasses(const BaseClassList &bcd)
 {
   m_inherits = bcd;
+  InheritanceIndex::instance().invalidate();
 }
 
 const BaseClassList &ClassDefImpl::subClasses() const
@@ -5182,6 +5298,7 @@ void ClassDefImpl::setTemplateMaster(const ClassDef *tm)
 {
   assert(tm!=this);
   m_templateMaster=tm;
+  InheritanceIndex::instance().invalidate();
 }
 
 void ClassDefImpl::makeTemplateArgument(bool b)
@@ -5548,6 +5665,11 @@ int minClassDistance(const ClassDef *cd,const ClassDef *bcd,int level)
     bcd=bcd->categoryOf();
   }
   if (cd==bcd) return level;
+  if (level==0)
+  {
+    int d = InheritanceIndex::instance().distance(cd,bcd,true);
+    if (d>=0) return d>0 ? d : maxInheritanceDepth;
+  }
   if (level==256)
   {
     warn_uncond("class {} seem to have a recursive inheritance relation!\n",cd->name());
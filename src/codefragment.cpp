@@ -13,7 +13,6 @@
  *
  */
 
-#include <mutex>
 #include <unordered_map>
 #include <map>
 
@@ -28,6 +27,7 @@
 #include "filedef.h"
 #include "portable.h"
 #include "message.h"
+#include "oncemap.h"
 
 struct CodeFragmentManager::Private
 {
@@ -47,11 +47,10 @@ struct CodeFragmentManager::Private
     OutputCodeList recorderCodeList;
     std::map<int,BlockMarker> blocks;
     std::map<std::string,const BlockMarker*> blocksById;
-    std::mutex mutex;
   };
 
-  std::unordered_map<std::string,std::unique_ptr<FragmentInfo> > fragments;
-  std::mutex mutex;
+  // each file is parsed and recorded once, after which its fragments can be replayed concurrently
+  OnceMap<std::string,FragmentInfo> fragments;
 };
 
 void CodeFragmentManager::Private::FragmentInfo::findBlockMarkers()
@@ -249,24 +248,10 @@ void CodeFragmentManager::parseCodeFragment(OutputCodeList & codeOutList,
   AUTO_TRACE("CodeFragmentManager::parseCodeFragment({},blockId={},scopeName={},showLineNumber={},trimLeft={},stripCodeComments={}",
       fileName, blockId, scopeName, showLineNumbers, trimLeft, stripCodeComments);
   std::string fragmentKey=fileName.str()+":"+scopeName.str();
-  std::unordered_map< std::string,std::unique_ptr<Private::FragmentInfo> >::iterator it;
-  bool inserted = false;
-  {
-    // create new entry if it is not yet in the map
-    std::lock_guard lock(p->mutex);
-    it = p->fragments.find(fragmentKey);
-    if (it == p->fragments.end())
-    {
-      it = p->fragments.emplace(fragmentKey, std::make_unique<Private::FragmentInfo>()).first;
-      inserted = true;
-      AUTO_TRACE_ADD("new fragment");
-    }
-  }
-  // only lock the one item we are working with
-  auto &codeFragment = it->second;
-  std::lock_guard lock(codeFragment->mutex);
-  if (inserted) // new entry, need to parse the file and record the output and cache it
+  const auto &codeFragment = p->fragments.get(fragmentKey,[&](Private::FragmentInfo &newFragment)
   {
+    // new entry, need to parse the file and record the output and cache it
+    AUTO_TRACE_ADD("new fragment");
     SrcLangExt langExt = getLanguageFromFileName(fileName);
     FileInfo cfi( fileName.str() );
     auto fd = createFileDef( cfi.dirPath(), cfi.fileName() );
@@ -277,26 +262,26 @@ void CodeFragmentManager::parseCodeFragment(OutputCodeList & codeOutList,
         Doxygen::parseSourcesNeeded &&                // we need to parse (filtered) sources for cross-references
         !filterSourceFiles &&                         // but user wants to show sources as-is
         !getFileFilter(fileName,TRUE).isEmpty();     // and there is a filter used while parsing
-    codeFragment->fileContents = readTextFileByName(fileName);
-    //printf("fileContents=[%s]\n",qPrint(codeFragment->fileContents));
+    newFragment.fileContents = readTextFileByName(fileName);
+    //printf("fileContents=[%s]\n",qPrint(newFragment.fileContents));
     if (needs2PassParsing)
     {
       OutputCodeList devNullList;
       devNullList.add<DevNullCodeGenerator>();
       intf->parseCode(devNullList,
                       scopeName,
-                      codeFragment->fileContents,
+                      newFragment.fileContents,
                       langExt,
                       stripCodeComments, // actually not important here
                       CodeParserOptions()
                       );
     }
-    codeFragment->findBlockMarkers();
-    if (codeFragment->fileContents.length()>0) // parse the normal version
+    newFragment.findBlockMarkers();
+    if (newFragment.fileContents.length()>0) // parse the normal version
     {
-      intf->parseCode(codeFragment->recorderCodeList,
+      intf->parseCode(newFragment.recorderCodeList,
           scopeName,
-          codeFragment->fileContents,
+          newFragment.fileContents,
           langExt,            // lang
           false,              // strip code comments (overruled before replaying)
           CodeParserOptions()
@@ -305,18 +290,18 @@ void CodeFragmentManager::parseCodeFragment(OutputCodeList & codeOutList,
           .setCollectXRefs(false)
           );
     }
-  }
+  });
   // use the recorded OutputCodeList from the cache to output a pre-recorded fragment
-  auto blockKv = codeFragment->blocksById.find(blockId.str());
-  if (blockKv != codeFragment->blocksById.end())
+  auto blockKv = codeFragment.blocksById.find(blockId.str());
+  if (blockKv != codeFragment.blocksById.end())
   {
     const auto &marker = blockKv->second;
     int startLine = marker->lines[0];
     int endLine   = marker->lines[1];
     int indent    = marker->indent;
     AUTO_TRACE_ADD("replay(start={},end={},indent={}) fileContentsTrimLeft.empty()={}",
-        startLine,endLine,indent,codeFragment->fileContentsTrimLeft.isEmpty());
-    auto recorder = codeFragment->recorderCodeList.get<OutputCodeRecorder>(OutputType::Recorder);
+        startLine,endLine,indent,codeFragment.fileContentsTrimLeft.isEmpty());
+    auto recorder = codeFragment.recorderCodeList.get<OutputCodeRecorder>(OutputType::Recorder);
     recorder->replay(codeOutList,
                     startLine+1,
                     endLine,
@@ -49,6 +49,7 @@ static std::map< std::string, Debug::DebugMask > s_labels =
   { "sections",           Debug::Sections           },
   { "stderr",             Debug::Stderr             },
   { "layout",             Debug::Layout             },
+  { "profile",            Debug::Profile            },
   { "lex",                Debug::Lex                },
   { "lex:code",           Debug::Lex_code           },
   { "lex:commentcnv",     Debug::Lex_commentcnv     },
@@ -82,7 +83,7 @@ void Debug::print_(DebugMask mask, int prio, fmt::string_view fmt, fmt::format_a
 {
   if ((curMask&mask) && prio<=curPrio)
   {
-    fmt::print(g_debugFile,"{}",fmt::vformat(fmt,args));
+    msg_debug(g_debugFile,fmt::vformat(fmt,args));
   }
 }
 
@@ -14,7 +14,9 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <limits>
 #include <unordered_map>
 #include <string>
 #include <optional>
@@ -51,6 +53,8 @@
 #include "utf8.h"
 #include "indexlist.h"
 #include "fileinfo.h"
+#include "lazydata.h"
+#include "oncemap.h"
 
 //-----------------------------------------------------------------------------------------
 
@@ -61,12 +65,22 @@ class DefinitionImpl::Private
     void init(const QCString &df, const QCString &n);
     void setDefFileName(const QCString &df);
 
+    /** Source code cross references, only present for symbols that are referenced or
+     *  that reference other symbols in the source code.
+     */
+    struct SourceRefs
+    {
+      std::unordered_map<std::string,MemberDef *> sourceRefByDict;
+      std::unordered_map<std::string,MemberDef *> sourceRefsDict;
+      MemberVector referencesMembers;    // cache for getReferencesMembers()
+      MemberVector referencedByMembers;  // cache for getReferencedByMembers()
+    };
+
     Definition *def = nullptr;
 
-    SectionRefs sectionRefs;
+    LazyData<SectionRefs> sectionRefs;
+    LazyData<SourceRefs> sourceRefs;
 
-    std::unordered_map<std::string,MemberDef *> sourceRefByDict;
-    std::unordered_map<std::string,MemberDef *> sourceRefsDict;
     RefItemVector xrefListItems;
     GroupList partOfGroups;
 
@@ -104,8 +118,8 @@ class DefinitionImpl::Private
     int defLine;
     int defColumn;
 
-    MemberVector referencesMembers;    // cache for getReferencesMembers()
-    MemberVector referencedByMembers;  // cache for getReferencedByMembers()
+    bool frozen = false;               // qualifiedName is final, see freeze()
+    bool referencesFrozen = false;     // reference caches are final, see freezeReferences()
 };
 
 
@@ -135,8 +149,7 @@ void DefinitionImpl::Private::init(const QCString &df, const QCString &n)
   details.reset();
   body.reset();
   inbodyDocs.reset();
-  sourceRefByDict.clear();
-  sourceRefsDict.clear();
+  sourceRefs.reset();
   outerScope      = Doxygen::globalScope;
   hidden          = FALSE;
   isArtificial    = FALSE;
@@ -234,12 +247,16 @@ static void removeFromMap(const QCString &name,Definition *d)
   Doxygen::symbolMap->remove(name,d);
 }
 
+//! number of DefinitionImpl objects that are alive, see DefinitionImpl::lazyDataStats()
+static std::atomic<size_t> g_numDefinitions { 0 };
+
 DefinitionImpl::DefinitionImpl(Definition *def,
                        const QCString &df,int dl,int dc,
                        const QCString &name,const char *b,
                        const char *d,bool isSymbol)
   : p(std::make_unique<Private>())
 {
+  g_numDefinitions++;
   setName(name);
   p->def = def;
   p->defLine = dl;
@@ -258,6 +275,9 @@ DefinitionImpl::DefinitionImpl(Definition *def,
 DefinitionImpl::DefinitionImpl(const DefinitionImpl &d)
   : p(std::make_unique<Private>(*d.p))
 {
+  g_numDefinitions++;
+  p->frozen = false;
+  p->referencesFrozen = false;
   if (p->isSymbol) addToMap(p->name,p->def);
 }
 
@@ -266,21 +286,40 @@ DefinitionImpl &DefinitionImpl::operator=(const DefinitionImpl &other)
   if (this!=&other)
   {
     p = std::make_unique<Private>(*other.p);
+    p->frozen = false;
+    p->referencesFrozen = false;
   }
   return *this;
 }
 
 DefinitionImpl::~DefinitionImpl()
 {
+  g_numDefinitions--;
   if (p->isSymbol)
   {
     removeFromMap(p->symbolName,p->def);
   }
 }
 
+LazyDataStats DefinitionImpl::lazyDataStats()
+{
+  size_t numSectionRefs = LazyData<SectionRefs>::numCreated();
+  size_t numSourceRefs  = LazyData<Private::SourceRefs>::numCreated();
+  LazyDataStats stats;
+  stats.objects      = g_numDefinitions;
+  stats.withData     = numSectionRefs+numSourceRefs;
+  stats.compactBytes = stats.objects*sizeof(Private) +
+                       numSectionRefs*sizeof(SectionRefs) + numSourceRefs*sizeof(Private::SourceRefs);
+  stats.flatBytes    = stats.objects*(sizeof(Private) -
+                       sizeof(LazyData<SectionRefs>) - sizeof(LazyData<Private::SourceRefs>) +
+                       sizeof(SectionRefs) + sizeof(Private::SourceRefs));
+  return stats;
+}
+
 void DefinitionImpl::setName(const QCString &name)
 {
-  if (name.isEmpty()) return;
+  if (name.isEmpty() || !_checkNotFrozen("rename")) return;
+  _invalidateQualifiedName();
   p->name = name;
   p->isAnonymous = p->name.isEmpty() ||
                         p->name.at(0)=='@' ||
@@ -317,9 +356,9 @@ void DefinitionImpl::addSectionsToDefinition(const std::vector<const SectionInfo
     {
       gsi = sm.add(*si);
     }
-    if (p->sectionRefs.find(gsi->label())==nullptr)
+    if (p->sectionRefs.get().find(gsi->label())==nullptr)
     {
-      p->sectionRefs.add(gsi);
+      p->sectionRefs.edit().add(gsi);
     }
     gsi->setDefinition(p->def);
   }
@@ -328,8 +367,8 @@ void DefinitionImpl::addSectionsToDefinition(const std::vector<const SectionInfo
 bool DefinitionImpl::hasSections() const
 {
   //printf("DefinitionImpl::hasSections(%s) #sections=%zu\n",qPrint(name()), p->sectionRefs.size());
-  if (p->sectionRefs.empty()) return FALSE;
-  for (const SectionInfo *si : p->sectionRefs)
+  if (p->sectionRefs.get().empty()) return FALSE;
+  for (const SectionInfo *si : p->sectionRefs.get())
   {
     if (si->type().isSection())
     {
@@ -341,10 +380,10 @@ bool DefinitionImpl::hasSections() const
 
 void DefinitionImpl::writeDocAnchorsToTagFile(TextStream &tagFile) const
 {
-  if (!p->sectionRefs.empty())
+  if (!p->sectionRefs.get().empty())
   {
     //printf("%s: writeDocAnchorsToTagFile(%d)\n",qPrint(name()),p->sectionRef.size());
-    for (const SectionInfo *si : p->sectionRefs)
+    for (const SectionInfo *si : p->sectionRefs.get())
     {
       if (!si->generated() && si->ref().isEmpty() && !AnchorGenerator::instance().isGenerated(si->label().str()))
       {
@@ -535,12 +574,46 @@ void DefinitionImpl::setInbodyDocumentation(const QCString &d,const QCString &in
 class FilterCache
 {
   private:
+    /** Byte offset of the start of each line of a file, plus the end of the file.
+     *  Stored in 32 bit unless the file is 4GB or larger.
+     */
+    class LineOffsets
+    {
+      public:
+        void compile(const std::string &str)
+        {
+          if (str.size()<=std::numeric_limits<uint32_t>::max()) compile(str,m_small);
+          else                                                  compile(str,m_large);
+        }
+        size_t operator[](size_t index) const { return m_large.empty() ? m_small[index] : m_large[index]; }
+        size_t size() const { return m_large.empty() ? m_small.size() : m_large.size(); }
+      private:
+        template<class Vec>
+        static void compile(const std::string &str,Vec &offsets)
+        {
+          // line 1 (index 0) is at offset 0
+          offsets.push_back(0);
+          const char *p=str.data();
+          while (*p)
+          {
+            char c=0;
+            while ((c=*p)!='\n' && c!=0) p++; // search until end of the line
+            if (c!=0) p++;
+            offsets.push_back(static_cast<typename Vec::value_type>(p-str.data()));
+          }
+          offsets.shrink_to_fit();
+        }
+        std::vector<uint32_t> m_small;
+        std::vector<size_t>   m_large;
+    };
+
     struct FilterCacheItem
     {
-      size_t filePos;
-      size_t fileSize;
+      bool        valid = false; // false if the filter could not be run
+      size_t      filePos = 0;   // offset of the filter output in the filter database
+      size_t      fileSize = 0;
+      LineOffsets lineOffsets;
     };
-    using LineOffsets = std::vector<size_t>;
 
   public:
     static FilterCache &instance();
@@ -548,7 +621,7 @@ class FilterCache
     //! collects the part of file \a fileName starting at \a startLine and ending at \a endLine into
     //! buffer \a str. Applies filtering if FILTER_SOURCE_FILES is enabled and the file extension
     //! matches a filter. Caches file information so that subsequent extraction of blocks from
-    //! the same file can be performed efficiently
+    //! the same file can be performed efficiently. Different files are processed in parallel.
     bool getFileContents(const QCString &fileName,size_t startLine,size_t endLine, std::string &str)
     {
       bool filterSourceFiles = Config_getBool(FILTER_SOURCE_FILES);
@@ -561,81 +634,57 @@ class FilterCache
     bool getFileContentsPipe(const QCString &fileName,const QCString &filter,
                              size_t startLine,size_t endLine,std::string &str)
     {
-      std::unique_lock<std::mutex> lock(m_mutex);
-      auto it = m_cache.find(fileName.str());
-      if (it!=m_cache.end()) // cache hit: reuse stored result
+      bool isNew = false;
+      const FilterCacheItem &item = m_filtered.get(fileName.str(),[&](FilterCacheItem &newItem)
       {
-        lock.unlock();
-        auto item = it->second;
-        //printf("getFileContents(%s): cache hit\n",qPrint(fileName));
-        // file already processed, get the results after filtering from the tmp file
-        Debug::print(Debug::FilterOutput,0,"Reusing filter result for {} from {} at offset={} size={}\n",
-               fileName,Doxygen::filterDBFileName,item.filePos,item.fileSize);
-
-        auto it_off = m_lineOffsets.find(fileName.str());
-        assert(it_off!=m_lineOffsets.end());
-        auto [ startLineOffset, fragmentSize] = getFragmentLocation(it_off->second,startLine,endLine);
-        //printf("%s: existing file [%zu-%zu]->[%zu-%zu] size=%zu\n",
-        //    qPrint(fileName),startLine,endLine,startLineOffset,endLineOffset,fragmentSize);
-        readFragmentFromFile(str, Doxygen::filterDBFileName.data(),
-                             item.filePos+startLineOffset, fragmentSize);
-        return true;
-      }
-      else // cache miss: filter active but file not previously processed
-      {
-        //printf("getFileContents(%s): cache miss\n",qPrint(fileName));
-        // filter file
+        // first request for this file: filter it and append the result to the database file
+        isNew = true;
         QCString cmd=filter+" \""+fileName+"\"";
-        Debug::print(Debug::ExtCmd,0,"Executing popen(`{}`)\n",cmd);
-        FILE *f = Portable::popen(cmd,"r");
-        if (f==nullptr)
+        if (Portable::runCommand(cmd,str)==-1)
         {
-          // handle error
-          err("Error opening filter pipe command '{}'\n",cmd);
-          return false;
+          err("Error running filter command '{}'\n",cmd);
+          return;
         }
-        FILE *bf = Portable::fopen(Doxygen::filterDBFileName,"a+b");
-        FilterCacheItem item;
-        item.filePos = m_endPos;
-        if (bf==nullptr)
         {
-          // handle error
-          err("Error opening filter database file {}\n",Doxygen::filterDBFileName);
-          Portable::pclose(f);
-          return false;
-        }
-        // append the filtered output to the database file
-        size_t size=0;
-        while (!feof(f))
-        {
-          const int blockSize = 4096;
-          char buf[blockSize];
-          size_t bytesRead = fread(buf,1,blockSize,f);
-          size_t bytesWritten = fwrite(buf,1,bytesRead,bf);
-          if (bytesRead!=bytesWritten)
+          // only appending to the database file is serialized
+          std::lock_guard<std::mutex> lock(m_dbMutex);
+          FILE *bf = Portable::fopen(Doxygen::filterDBFileName,"a+b");
+          if (bf==nullptr)
+          {
+            err("Error opening filter database file {}\n",Doxygen::filterDBFileName);
+            return;
+          }
+          size_t bytesWritten = fwrite(str.data(),1,str.size(),bf);
+          fclose(bf);
+          if (bytesWritten!=str.size())
           {
-            // handle error
             err("Failed to write to filter database {}. Wrote {} out of {} bytes\n",
-                Doxygen::filterDBFileName,bytesWritten,bytesRead);
-            Portable::pclose(f);
-            fclose(bf);
-            return false;
+                Doxygen::filterDBFileName,bytesWritten,str.size());
+            return;
           }
-          size+=bytesWritten;
-          str+=std::string_view(buf,bytesWritten);
+          newItem.filePos = m_endPos;
+          m_endPos += bytesWritten;
         }
-        item.fileSize = size;
-        // add location entry to the dictionary
-        m_cache.emplace(fileName.str(),item);
+        newItem.fileSize = str.size();
+        newItem.lineOffsets.compile(str);
+        newItem.valid = true;
         Debug::print(Debug::FilterOutput,0,"Storing new filter result for {} in {} at offset={} size={}\n",
-               fileName,Doxygen::filterDBFileName,item.filePos,item.fileSize);
-        // update end of file position
-        m_endPos += size;
-        Portable::pclose(f);
-        fclose(bf);
+               fileName,Doxygen::filterDBFileName,newItem.filePos,newItem.fileSize);
+      });
+      if (!item.valid) return false;
 
-        // shrink buffer to [startLine..endLine] part
-        shrinkBuffer(str,fileName,startLine,endLine);
+      auto [ startLineOffset, fragmentSize] = getFragmentLocation(item.lineOffsets,startLine,endLine);
+      if (isNew) // str holds the complete filter output, shrink it to [startLine..endLine] part
+      {
+        str.erase(0,startLineOffset);
+        str.resize(fragmentSize);
+      }
+      else // file already processed, get the results after filtering from the database file
+      {
+        Debug::print(Debug::FilterOutput,0,"Reusing filter result for {} from {} at offset={} size={}\n",
+               fileName,Doxygen::filterDBFileName,item.filePos,item.fileSize);
+        readFragmentFromFile(str, Doxygen::filterDBFileName.data(),
+                             item.filePos+startLineOffset, fragmentSize);
       }
       return true;
     }
@@ -644,44 +693,28 @@ class FilterCache
     //! into buffer \a str
     bool getFileContentsDisk(const QCString &fileName,size_t startLine,size_t endLine,std::string &str)
     {
-      std::unique_lock<std::mutex> lock(m_mutex);
-      // normal file
-      //printf("getFileContents(%s): no filter\n",qPrint(fileName));
-      auto it = m_lineOffsets.find(fileName.str());
-      if (it == m_lineOffsets.end()) // new file
+      bool isNew = false;
+      const LineOffsets &lineOffsets = m_lineOffsets.get(fileName.str(),[&](LineOffsets &newOffsets)
       {
-        // read file completely into str buffer
+        // first request for this file: read it completely into str buffer and index its lines
+        isNew = true;
         readFragmentFromFile(str,fileName,0);
-        // shrink buffer to [startLine..endLine] part
-        shrinkBuffer(str,fileName,startLine,endLine);
+        newOffsets.compile(str);
+      });
+
+      auto [ startLineOffset, fragmentSize] = getFragmentLocation(lineOffsets,startLine,endLine);
+      if (isNew) // shrink buffer to [startLine..endLine] part
+      {
+        str.erase(0,startLineOffset);
+        str.resize(fragmentSize);
       }
       else // file already processed before
       {
-        lock.unlock();
-        auto [ startLineOffset, fragmentSize] = getFragmentLocation(it->second,startLine,endLine);
-        //printf("%s: existing file [%zu-%zu] -> start=%zu size=%zu\n",
-        //    qPrint(fileName),startLine,endLine,startLineOffset,fragmentSize);
         readFragmentFromFile(str,fileName,startLineOffset,fragmentSize);
       }
       return true;
     }
 
-    //! computes the starting offset for each line for file \a fileName, whose contents should
-    //! already be stored in buffer \a str.
-    void compileLineOffsets(const QCString &fileName,const std::string &str)
-    {
-      // line 1 (index 0) is at offset 0
-      auto it = m_lineOffsets.emplace(fileName.data(),LineOffsets{0}).first;
-      const char *p=str.data();
-      while (*p)
-      {
-        char c=0;
-        while ((c=*p)!='\n' && c!=0) p++; // search until end of the line
-        if (c!=0) p++;
-        it->second.push_back(p-str.data());
-      }
-    }
-
     //! Returns the byte offset and size within a file of a fragment given the array of
     //! line offsets and the start and end line of the fragment.
     auto getFragmentLocation(const LineOffsets &lineOffsets,
@@ -696,22 +729,6 @@ class FilterCache
       return std::tie(startLineOffset,fragmentSize);
     }
 
-    //! Shrinks buffer \a str which should hold the contents of \a fileName to the
-    //! fragment starting a line \a startLine and ending at line \a endLine
-    void shrinkBuffer(std::string &str,const QCString &fileName,size_t startLine,size_t endLine)
-    {
-      // compute offsets from start for each line
-      compileLineOffsets(fileName,str);
-      auto it = m_lineOffsets.find(fileName.str());
-      assert(it!=m_lineOffsets.end());
-      const LineOffsets &lineOffsets = it->second;
-      auto [ startLineOffset, fragmentSize] = getFragmentLocation(lineOffsets,startLine,endLine);
-      //printf("%s: new file [%zu-%zu]->[%zu-%zu] size=%zu\n",
-      //    qPrint(fileName),startLine,endLine,startLineOffset,endLineOffset,fragmentSize);
-      str.erase(0,startLineOffset);
-      str.resize(fragmentSize);
-    }
-
     //! Reads the fragment start at byte offset \a startOffset of file \a fileName into buffer \a str.
     //! Result will be a null terminated. If size==0 the whole file will be read and startOffset is ignored.
     //! If size>0, size bytes will be read.
@@ -724,11 +741,11 @@ class FilterCache
       ifs.read(str.data(), size);
     }
 
-    FilterCache() : m_endPos(0) { }
-    std::unordered_map<std::string,FilterCacheItem> m_cache;
-    std::unordered_map<std::string,LineOffsets> m_lineOffsets;
-    std::mutex m_mutex;
-    size_t m_endPos;
+    FilterCache() = default;
+    OnceMap<std::string,FilterCacheItem> m_filtered;
+    OnceMap<std::string,LineOffsets>     m_lineOffsets;
+    std::mutex m_dbMutex;
+    size_t m_endPos = 0;
 };
 
 FilterCache &FilterCache::instance()
@@ -1159,22 +1176,22 @@ void DefinitionImpl::_writeSourceRefList(OutputList &ol,const QCString &scopeNam
 
 void DefinitionImpl::writeSourceReffedBy(OutputList &ol,const QCString &scopeName) const
 {
-  _writeSourceRefList(ol,scopeName,theTranslator->trReferencedBy(),p->sourceRefByDict,FALSE);
+  _writeSourceRefList(ol,scopeName,theTranslator->trReferencedBy(),p->sourceRefs.get().sourceRefByDict,FALSE);
 }
 
 void DefinitionImpl::writeSourceRefs(OutputList &ol,const QCString &scopeName) const
 {
-  _writeSourceRefList(ol,scopeName,theTranslator->trReferences(),p->sourceRefsDict,TRUE);
+  _writeSourceRefList(ol,scopeName,theTranslator->trReferences(),p->sourceRefs.get().sourceRefsDict,TRUE);
 }
 
 bool DefinitionImpl::hasSourceReffedBy() const
 {
-  return !p->sourceRefByDict.empty();
+  return !p->sourceRefs.get().sourceRefByDict.empty();
 }
 
 bool DefinitionImpl::hasSourceRefs() const
 {
-  return !p->sourceRefsDict.empty();
+  return !p->sourceRefs.get().sourceRefsDict.empty();
 }
 
 bool DefinitionImpl::hasDocumentation() const
@@ -1205,7 +1222,7 @@ void DefinitionImpl::addSourceReferencedBy(MemberDef *md,const QCString &sourceR
 {
   if (md)
   {
-    p->sourceRefByDict.emplace(sourceRefName.str(),md);
+    p->sourceRefs.edit().sourceRefByDict.emplace(sourceRefName.str(),md);
   }
 }
 
@@ -1213,7 +1230,7 @@ void DefinitionImpl::addSourceReferences(MemberDef *md,const QCString &sourceRef
 {
   if (md)
   {
-    p->sourceRefsDict.emplace(sourceRefName.str(),md);
+    p->sourceRefs.edit().sourceRefsDict.emplace(sourceRefName.str(),md);
   }
 }
 
@@ -1231,6 +1248,10 @@ static std::recursive_mutex g_qualifiedNameMutex;
 
 QCString DefinitionImpl::qualifiedName() const
 {
+  if (p->frozen) // name cannot change anymore, so no need to lock
+  {
+    return p->qualifiedName;
+  }
   std::lock_guard<std::recursive_mutex> lock(g_qualifiedNameMutex);
   if (!p->qualifiedName.isEmpty())
   {
@@ -1265,8 +1286,39 @@ QCString DefinitionImpl::qualifiedName() const
   return p->qualifiedName;
 }
 
+//! flushes the cached scope name, the definition may not have been frozen yet
+void DefinitionImpl::_invalidateQualifiedName()
+{
+  std::lock_guard<std::recursive_mutex> lock(g_qualifiedNameMutex);
+  p->qualifiedName.clear();
+}
+
+/*! Returns FALSE and reports an error if the definition has been frozen already.
+ *  After freeze() the qualified name is read without a lock by the output threads,
+ *  so the definition cannot be renamed or moved anymore.
+ */
+bool DefinitionImpl::_checkNotFrozen(const char *action) const
+{
+  if (p->frozen)
+  {
+    err("Internal inconsistency: attempt to {} '{}' after its symbols have been frozen\n",action,p->qualifiedName);
+    return false;
+  }
+  return true;
+}
+
+void DefinitionImpl::freeze()
+{
+  if (!p->frozen)
+  {
+    p->qualifiedName = qualifiedName();
+    p->frozen = true;
+  }
+}
+
 void DefinitionImpl::setOuterScope(Definition *d)
 {
+  if (!_checkNotFrozen("move")) return;
   std::lock_guard<std::recursive_mutex> lock(g_qualifiedNameMutex);
   //printf("%s::setOuterScope(%s)\n",qPrint(name()),d?qPrint(d->name()):"<none>");
   Definition *outerScope = p->outerScope;
@@ -1279,7 +1331,7 @@ void DefinitionImpl::setOuterScope(Definition *d)
   }
   if (!found)
   {
-    p->qualifiedName.clear(); // flush cached scope name
+    _invalidateQualifiedName();
     p->outerScope = d;
   }
   p->hidden = p->hidden || d->isHidden();
@@ -1460,13 +1512,13 @@ void DefinitionImpl::writeNavigationPath(OutputList &ol) const
 void DefinitionImpl::writeToc(OutputList &ol, const LocalToc &localToc) const
 {
   // first check if we have anything to show or if the outline is already shown on the outline panel
-  if (p->sectionRefs.empty() || (Config_getBool(GENERATE_TREEVIEW) && Config_getBool(PAGE_OUTLINE_PANEL))) return;
+  if (p->sectionRefs.get().empty() || (Config_getBool(GENERATE_TREEVIEW) && Config_getBool(PAGE_OUTLINE_PANEL))) return;
   // generate the embedded toc
   //ol.writeLocalToc(p->sectionRefs,localToc);
 
   auto generateTocEntries = [this,&ol]()
   {
-    for (const SectionInfo *si : p->sectionRefs)
+    for (const SectionInfo *si : p->sectionRefs.get())
     {
       if (si->type().isSection())
       {
@@ -1523,7 +1575,7 @@ void DefinitionImpl::writeToc(OutputList &ol, const LocalToc &localToc) const
 
 const SectionRefs &DefinitionImpl::getSectionRefs() const
 {
-  return p->sectionRefs;
+  return p->sectionRefs.get();
 }
 
 QCString DefinitionImpl::symbolName() const
@@ -1740,22 +1792,38 @@ static std::mutex g_memberReferenceMutex;
 
 const MemberVector &DefinitionImpl::getReferencesMembers() const
 {
+  if (p->referencesFrozen) return p->sourceRefs.get().referencesMembers;
   std::lock_guard<std::mutex> lock(g_memberReferenceMutex);
-  if (p->referencesMembers.empty() && !p->sourceRefsDict.empty())
+  if (p->sourceRefs.get().referencesMembers.empty() && !p->sourceRefs.get().sourceRefsDict.empty())
   {
-    p->referencesMembers = refMapToVector(p->sourceRefsDict);
+    // the references exist, so this does not allocate
+    auto &refs = p->sourceRefs.edit();
+    refs.referencesMembers = refMapToVector(refs.sourceRefsDict);
   }
-  return p->referencesMembers;
+  return p->sourceRefs.get().referencesMembers;
 }
 
 const MemberVector &DefinitionImpl::getReferencedByMembers() const
 {
+  if (p->referencesFrozen) return p->sourceRefs.get().referencedByMembers;
   std::lock_guard<std::mutex> lock(g_memberReferenceMutex);
-  if (p->referencedByMembers.empty() && !p->sourceRefByDict.empty())
+  if (p->sourceRefs.get().referencedByMembers.empty() && !p->sourceRefs.get().sourceRefByDict.empty())
+  {
+    // the references exist, so this does not allocate
+    auto &refs = p->sourceRefs.edit();
+    refs.referencedByMembers = refMapToVector(refs.sourceRefByDict);
+  }
+  return p->sourceRefs.get().referencedByMembers;
+}
+
+void DefinitionImpl::freezeReferences()
+{
+  if (!p->referencesFrozen)
   {
-    p->referencedByMembers = refMapToVector(p->sourceRefByDict);
+    getReferencesMembers();
+    getReferencedByMembers();
+    p->referencesFrozen = true;
   }
-  return p->referencedByMembers;
 }
 
 void DefinitionImpl::mergeReferences(const Definition *other)
@@ -1763,12 +1831,13 @@ void DefinitionImpl::mergeReferences(const Definition *other)
   const DefinitionImpl *defImpl = other->toDefinitionImpl_();
   if (defImpl)
   {
-    for (const auto &kv : defImpl->p->sourceRefsDict)
+    for (const auto &kv : defImpl->p->sourceRefs.get().sourceRefsDict)
     {
-      auto it = p->sourceRefsDict.find(kv.first);
-      if (it != p->sourceRefsDict.end())
+      const auto &dict = p->sourceRefs.get().sourceRefsDict;
+      auto it = dict.find(kv.first);
+      if (it != dict.end())
       {
-        p->sourceRefsDict.insert(kv);
+        p->sourceRefs.edit().sourceRefsDict.insert(kv);
       }
     }
   }
@@ -1779,12 +1848,13 @@ void DefinitionImpl::mergeReferencedBy(const Definition *other)
   const DefinitionImpl *defImpl = other->toDefinitionImpl_();
   if (defImpl)
   {
-    for (const auto &kv : defImpl->p->sourceRefByDict)
+    for (const auto &kv : defImpl->p->sourceRefs.get().sourceRefByDict)
     {
-      auto it = p->sourceRefByDict.find(kv.first);
-      if (it != p->sourceRefByDict.end())
+      const auto &dict = p->sourceRefs.get().sourceRefByDict;
+      auto it = dict.find(kv.first);
+      if (it != dict.end())
       {
-        p->sourceRefByDict.emplace(kv.first,kv.second);
+        p->sourceRefs.edit().sourceRefByDict.emplace(kv.first,kv.second);
       }
     }
   }
@@ -1818,6 +1888,8 @@ void DefinitionImpl::setExported(bool b)
 
 void DefinitionImpl::setLocalName(const QCString &name)
 {
+  if (!_checkNotFrozen("rename")) return;
+  _invalidateQualifiedName();
   p->localName=name;
 }
 
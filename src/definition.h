@@ -369,6 +369,18 @@ class DefinitionMutable
     virtual void mergeReferencedBy(const Definition *other) = 0;
     virtual void computeTooltip() = 0;
 
+    /*! Computes the properties that are otherwise lazily evaluated and cached,
+     *  after which they are read without locking. To be called once the symbol
+     *  graph is complete and from a single thread. A frozen definition can no
+     *  longer be renamed or moved to another scope.
+     */
+    virtual void freeze() = 0;
+
+    /*! Same as freeze() for the cross references, which are complete only after
+     *  all sources have been parsed.
+     */
+    virtual void freezeReferences() = 0;
+
     //-----------------------------------------------------------------------------------
     // --- writing output ----
     //-----------------------------------------------------------------------------------
@@ -24,6 +24,8 @@
 
 #include "definition.h"
 
+struct LazyDataStats;
+
 class DefinitionImpl
 {
   public:
@@ -125,9 +127,13 @@ class DefinitionImpl
     void setLocalName(const QCString &name);
     void writeToc(OutputList &ol, const LocalToc &lt) const;
     void computeTooltip();
+    void freeze();
+    void freezeReferences();
     void _setSymbolName(const QCString &name);
     QCString _symbolName() const;
 
+    /** Returns the memory used by the private data of the definitions that are alive, for the build statistics */
+    static LazyDataStats lazyDataStats();
 
   private:
 
@@ -138,6 +144,8 @@ class DefinitionImpl
     void _setDocumentation(const QCString &d,const QCString &docFile,int docLine,bool stripWhiteSpace,bool atTop);
     void _setInbodyDocumentation(const QCString &d,const QCString &docFile,int docLine);
     bool _docsAlreadyAdded(const QCString &doc,QCString &sigList);
+    void _invalidateQualifiedName();
+    bool _checkNotFrozen(const char *action) const;
 
     // PIMPL idiom
     class Private;
@@ -288,6 +296,10 @@ class DefinitionMixin : public Base
     { m_impl.writeToc(ol,lt); }
     void computeTooltip() override
     { m_impl.computeTooltip(); }
+    void freeze() override
+    { m_impl.freeze(); }
+    void freezeReferences() override
+    { m_impl.freezeReferences(); }
     void _setSymbolName(const QCString &name) override
     { m_impl._setSymbolName(name); }
     QCString _symbolName() const override
@@ -19,6 +19,7 @@
 #include "message.h"
 #include "util.h"
 #include "dir.h"
+#include "fileinfo.h"
 
 
 static const int maxCmdLine = 40960;
@@ -31,11 +32,15 @@ void writeDiaGraphFromFile(const QCString &inFile,const QCString &outDir,
   absOutFile+=Portable::pathSeparator();
   absOutFile+=outFile;
 
-  // chdir to the output dir, so dot can find the font file.
-  std::string oldDir = Dir::currentDirPath();
-  // go to the html output directory (i.e. path)
-  Dir::setCurrent(outDir.str());
-  //printf("Going to dir %s\n",Dir::currentDirPath().c_str());
+  // a relative input file is relative to the output directory. Use absolute paths
+  // instead of changing the working directory, since charts for different pages
+  // can be generated concurrently.
+  QCString absInFile = inFile;
+  if (!Portable::isAbsolutePath(inFile))
+  {
+    absInFile = outDir+Portable::pathSeparator()+inFile;
+  }
+
   QCString diaExe = Config_getString(DIA_PATH)+"dia"+Portable::commandExtension();
   QCString diaArgs;
   QCString extension;
@@ -52,36 +57,44 @@ void writeDiaGraphFromFile(const QCString &inFile,const QCString &outDir,
   }
 
   diaArgs+=" -e \"";
-  diaArgs+=outFile;
+  diaArgs+=absOutFile;
   diaArgs+=extension+"\"";
 
   diaArgs+=" \"";
-  diaArgs+=inFile;
+  diaArgs+=absInFile;
   diaArgs+="\"";
 
+  // skip running dia when the diagram and the settings used to render it did not
+  // change since the previous run and the result is still there (like for dot graphs)
+  bool convertToPdf = format==DiaOutputFormat::EPS && Config_getBool(USE_PDFLATEX);
+  QCString resultName = absOutFile+(convertToPdf ? QCString(".pdf") : extension);
+  QCString sig = computeMd5Signature(fileToString(absInFile)+"\n"+diaExe+" "+diaArgs+(convertToPdf?"\npdf":""));
+  if (sameMd5Signature(absOutFile,sig) && FileInfo(resultName.str()).exists())
+  {
+    return;
+  }
+
   //printf("*** running: %s %s outDir:%s %s\n",qPrint(diaExe),qPrint(diaArgs),outDir,outFile);
   if (Portable::system(diaExe,diaArgs,FALSE)!=0)
   {
     err_full(srcFile,srcLine,"Problems running {}. Check your installation or look typos in you dia file {}",
         diaExe,inFile);
-    goto error;
+    return;
   }
-  if ( (format==DiaOutputFormat::EPS) && (Config_getBool(USE_PDFLATEX)) )
+  if (convertToPdf)
   {
     QCString epstopdfArgs(maxCmdLine, QCString::ExplicitSize);
     epstopdfArgs.sprintf("\"%s.eps\" --outfile=\"%s.pdf\"",
-                         qPrint(outFile),qPrint(outFile));
+                         qPrint(absOutFile),qPrint(absOutFile));
     if (Portable::system("epstopdf",epstopdfArgs)!=0)
     {
       err("Problems running epstopdf. Check your TeX installation!\n");
+      return;
     }
     else
     {
-      Dir().remove(outFile.str()+".eps");
+      Dir().remove(absOutFile.str()+".eps");
     }
   }
-
-error:
-  Dir::setCurrent(oldDir);
+  writeMd5Signature(absOutFile,sig);
 }
-
@@ -1378,15 +1378,16 @@ void ClassDiagram::writeImage(TextStream &t,const QCString &path,
                     (maxXPos*labelHorSpacing)/gridWidth;
   uint32_t imageHeight = rows*cellHeight+(rows-1)*labelVertSpacing;
 
-  Image image(imageWidth,imageHeight);
+  auto image = std::make_unique<Image>(imageWidth,imageHeight);
 
-  p->base.drawBoxes(t,&image,TRUE,TRUE,baseRows,superRows,cellWidth,cellHeight,relPath,generateMap);
-  p->super.drawBoxes(t,&image,FALSE,TRUE,baseRows,superRows,cellWidth,cellHeight,relPath,generateMap);
-  p->base.drawConnectors(t,&image,TRUE,TRUE,baseRows,superRows,cellWidth,cellHeight);
-  p->super.drawConnectors(t,&image,FALSE,TRUE,baseRows,superRows,cellWidth,cellHeight);
+  p->base.drawBoxes(t,image.get(),TRUE,TRUE,baseRows,superRows,cellWidth,cellHeight,relPath,generateMap);
+  p->super.drawBoxes(t,image.get(),FALSE,TRUE,baseRows,superRows,cellWidth,cellHeight,relPath,generateMap);
+  p->base.drawConnectors(t,image.get(),TRUE,TRUE,baseRows,superRows,cellWidth,cellHeight);
+  p->super.drawConnectors(t,image.get(),FALSE,TRUE,baseRows,superRows,cellWidth,cellHeight);
 
 #define IMAGE_EXT ".png"
-  image.save(QCString(path)+"/"+fileName+IMAGE_EXT);
+  // the PNG encoding is done in the background, see ImageManager::waitForCompletion()
+  ImageManager::instance().save(std::move(image),QCString(path)+"/"+fileName+IMAGE_EXT);
   Doxygen::indexList->addImageFile(QCString(fileName)+IMAGE_EXT);
 }
 
@@ -29,6 +29,7 @@
 #include "htmlattrib.h"
 #include "htmlentity.h"
 #include "growvector.h"
+#include "arena.h"
 #include "section.h"
 #include "construct.h"
 #include "doctokenizer.h"
@@ -115,8 +116,13 @@ class DocNode
     DocNodeVariant *m_thisVariant = nullptr;
 };
 
-struct DocNodeList : public GrowVector<DocNodeVariant>
+struct DocNodeList : public GrowVector<DocNodeVariant,ArenaAllocator<DocNodeVariant>>
 {
+  /** Creates an empty list. While a documentation block is being parsed, the list
+   *  allocates its elements from the arena of the resulting DocNodeAST.
+   */
+  DocNodeList() : GrowVector(ArenaAllocator<DocNodeVariant>(Arena::current())) {}
+
   /** Append a new DocNodeVariant to the list by constructing it with type T and
    *  parameters Args.
    */
@@ -153,7 +159,7 @@ class DocWord : public DocNode
 {
   public:
     DocWord(DocParser *parser,DocNodeVariant *parent,const QCString &word);
-    QCString word() const { return m_word; }
+    const QCString &word() const { return m_word; }
 
   private:
     QCString  m_word;
@@ -167,12 +173,12 @@ class DocLinkedWord : public DocNode
     DocLinkedWord(DocParser *parser,DocNodeVariant *parent,const QCString &word,
                   const QCString &ref,const QCString &file,
                   const QCString &anchor,const QCString &tooltip);
-    QCString word() const       { return m_word; }
-    QCString file() const       { return m_file; }
-    QCString relPath() const    { return m_relPath; }
-    QCString ref() const        { return m_ref; }
-    QCString anchor() const     { return m_anchor; }
-    QCString tooltip() const    { return m_tooltip; }
+    const QCString &word() const    { return m_word; }
+    const QCString &file() const    { return m_file; }
+    const QCString &relPath() const { return m_relPath; }
+    const QCString &ref() const     { return m_ref; }
+    const QCString &anchor() const  { return m_anchor; }
+    const QCString &tooltip() const { return m_tooltip; }
 
   private:
     QCString  m_word;
@@ -1468,7 +1474,7 @@ class DocNodeAST : public IDocNodeAST
     // Note that r can only be a rvalue, not a general forwarding reference.
     // The compiler will error on lvalues because DotNodeVariant doesn't have a copy constructor
     template<class DocNode>
-    DocNodeAST(DocNode &&r) : root(std::move(r))
+    DocNodeAST(DocNode &&r,std::unique_ptr<Arena> a=nullptr) : arena(std::move(a)), root(std::move(r))
     {
       std::get_if<DocNode>(&root)->setThisVariant(&root);
     }
@@ -1488,6 +1494,7 @@ class DocNodeAST : public IDocNodeAST
       }
       return false;
     }
+    std::unique_ptr<Arena> arena; //!< memory of the nodes in the tree, must outlive root
     DocNodeVariant root;
 };
 
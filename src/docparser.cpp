@@ -2031,8 +2031,11 @@ IDocNodeASTPtr validatingParseDoc(IDocParser &parserIntf,
   parser->tokenizer.init(inpStr.data(),parser->context.fileName,
                          parser->context.markdownSupport,parser->context.insideHtmlLink);
 
-  // build abstract syntax tree
-  auto ast = std::make_unique<DocNodeAST>(DocRoot(parser,md!=nullptr,options.singleLine()));
+  // build abstract syntax tree, allocating the children of its nodes from an arena
+  // that is released together with the tree
+  auto arena = std::make_unique<Arena>();
+  Arena::Scope arenaScope(arena.get());
+  auto ast = std::make_unique<DocNodeAST>(DocRoot(parser,md!=nullptr,options.singleLine()),std::move(arena));
   std::get<DocRoot>(ast->root).parse();
 
   if (Debug::isFlagSet(Debug::PrintTree))
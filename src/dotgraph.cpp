@@ -36,36 +36,6 @@
 //QCString DotGraph::DOT_FONTNAME; // will be initialized in initDot
 //int DotGraph::DOT_FONTSIZE;      // will be initialized in initDot
 
-/*! Checks if a file "baseName".md5 exists. If so the contents
-*  are compared with \a md5. If equal FALSE is returned.
-*  The .md5 is created or updated after successful creation of the output file.
-*/
-static bool sameMd5Signature(const QCString &baseName,
-                             const QCString &md5)
-{
-  bool same = false;
-  char md5stored[33];
-  md5stored[0]=0;
-  std::ifstream f = Portable::openInputStream(baseName+".md5",true);
-  if (f.is_open())
-  {
-    // read checksum
-    f.read(md5stored,32);
-    md5stored[32]='\0';
-    // compare checksum
-    if (!f.fail() && md5==md5stored)
-    {
-      same = true;
-    }
-    //printf("sameSignature(%s,%s==%s)=%d\n",qPrint(baseName),md5stored,qPrint(md5),same);
-  }
-  else
-  {
-    //printf("sameSignature(%s) not found\n",qPrint(baseName));
-  }
-  return same;
-}
-
 static bool deliverablesPresent(const QCString &file1,const QCString &file2)
 {
   bool file1Ok = true;
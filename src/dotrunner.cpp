@@ -52,6 +52,7 @@
 #include "config.h"
 #include "dir.h"
 #include "doxygen.h"
+#include "buildstatistics.h"
 
 // the graphicx LaTeX has a limitation of maximum size of 16384
 // To be on the save side we take it a little bit smaller i.e. 150 inch * 72 dpi
@@ -289,6 +290,7 @@ QCString getBaseNameOfOutput(const QCString &output)
 
 bool DotRunner::run()
 {
+  BuildStatisticsTimer statistics(BuildStatistics::Kind::DotGraph,"dot",m_file);
   int exitCode=0;
 
   QCString dotArgs;
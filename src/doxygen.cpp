@@ -106,9 +106,13 @@
 #include "fileinfo.h"
 #include "dir.h"
 #include "conceptdef.h"
+#include "image.h"
+#include "asyncfilewriter.h"
 #include "trace.h"
 #include "moduledef.h"
 #include "stringutil.h"
+#include "profiler.h"
+#include "buildstatistics.h"
 #include "singlecomment.h"
 
 #include <sqlite3.h>
@@ -240,6 +244,11 @@ class Statistics
       std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
       stats.back().elapsed = static_cast<double>(std::chrono::duration_cast<
                                 std::chrono::microseconds>(endTime - startTime).count())/1000000.0;
+      if (Profiler::isEnabled())
+      {
+        Profiler::addSpan("phase",QCString(stats.back().name).stripWhiteSpace().str(),startTime,endTime);
+      }
+      BuildStatistics::instance().addPhase(stats.back().name,stats.back().elapsed);
       warn_flush();
     }
     void print()
@@ -8536,6 +8545,17 @@ static void generateFileSources()
 #if USE_LIBCLANG
     if (Doxygen::clangAssistedParsing)
     {
+      // reuse the translation unit parsed while reading the input if it is still available
+      auto getClangTUParser = [](const FileDef *fd)
+      {
+        auto clangParser = ClangParser::instance()->takeTUParser(fd);
+        if (!clangParser)
+        {
+          clangParser = ClangParser::instance()->createTUParser(fd);
+          clangParser->parse();
+        }
+        return clangParser;
+      };
       StringUnorderedSet processedFiles;
 
       // create a dictionary with files to process
@@ -8559,8 +8579,7 @@ static void generateFileSources()
               )
              )
           {
-            auto clangParser = ClangParser::instance()->createTUParser(fd.get());
-            clangParser->parse();
+            auto clangParser = getClangTUParser(fd.get());
             processSourceFile(fd.get(),*g_outputList,clangParser.get());
 
             for (auto incFile : clangParser->filesInSameTU())
@@ -8592,8 +8611,7 @@ static void generateFileSources()
           {
             if (fd->getLanguage()==SrcLangExt::Cpp) // C/C++ file, use clang parser
             {
-              auto clangParser = ClangParser::instance()->createTUParser(fd.get());
-              clangParser->parse();
+              auto clangParser = getClangTUParser(fd.get());
               processSourceFile(fd.get(),*g_outputList,clangParser.get());
             }
             else // non C/C++ file, use built-in parser
@@ -8603,6 +8621,8 @@ static void generateFileSources()
           }
         }
       }
+      // release translation units that were kept but not used
+      ClangParser::instance()->clearTUParsers();
     }
     else
 #endif
@@ -8706,6 +8726,7 @@ static void generateFileDocs()
             auto ctx = std::make_shared<DocContext>(fd.get(),*g_outputList);
             auto processFile = [ctx]() {
               msg("Generating docs for file {}...\n",ctx->fd->docName());
+              BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"file",ctx->fd->absFilePath());
               ctx->fd->writeDocumentation(ctx->ol);
               return ctx;
             };
@@ -8728,6 +8749,7 @@ static void generateFileDocs()
           if (doc)
           {
             msg("Generating docs for file {}...\n",fd->docName());
+            BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"file",fd->absFilePath());
             fd->writeDocumentation(*g_outputList);
           }
         }
@@ -8960,6 +8982,44 @@ static void computeTooltipTexts()
 
 //----------------------------------------------------------------------------
 
+/** Computes the lazily cached properties of all symbols, so the output generators
+ *  running in parallel can read them without taking a lock.
+ */
+static void freezeSymbols()
+{
+  for (const auto &[name,symList] : *Doxygen::symbolMap)
+  {
+    for (const auto &def : symList)
+    {
+      DefinitionMutable *dm = toDefinitionMutable(def);
+      if (dm)
+      {
+        dm->freeze();
+      }
+    }
+  }
+}
+
+/** Same as freezeSymbols() for the source cross references, which are only complete
+ *  once all source files have been parsed.
+ */
+static void freezeSymbolReferences()
+{
+  for (const auto &[name,symList] : *Doxygen::symbolMap)
+  {
+    for (const auto &def : symList)
+    {
+      DefinitionMutable *dm = toDefinitionMutable(def);
+      if (dm)
+      {
+        dm->freezeReferences();
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
 static void setAnonymousEnumType()
 {
   for (const auto &cd : *Doxygen::classLinkedMap)
@@ -9047,6 +9107,7 @@ static void generateDocsForClassList(const std::vector<ClassDefMutable*> &classL
           if (!ctx->cd->isHidden() && !ctx->cd->isEmbeddedInOuterScope() &&
               ctx->cd->isLinkableInProject() && !ctx->cd->isImplicitTemplateInstance())
           {
+            BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"class",ctx->cd->name());
             ctx->cd->writeDocumentation(ctx->ol);
             ctx->cd->writeMemberList(ctx->ol);
           }
@@ -9079,7 +9140,7 @@ static void generateDocsForClassList(const std::vector<ClassDefMutable*> &classL
               cd->isLinkableInProject() && !cd->isImplicitTemplateInstance())
         {
           msg("Generating docs for compound {}...\n",cd->displayName());
-
+          BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"class",cd->name());
           cd->writeDocumentation(*g_outputList);
           cd->writeMemberList(*g_outputList);
         }
@@ -9153,6 +9214,7 @@ static void generateConceptDocs()
        )
     {
       msg("Generating docs for concept {}...\n",cd->displayName());
+      BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"concept",cd->name());
       cd->writeDocumentation(*g_outputList);
     }
   }
@@ -9891,6 +9953,7 @@ static void generatePageDocs()
     if (!pd->getGroupDef() && !pd->isReference())
     {
       msg("Generating docs for page {}...\n",pd->name());
+      BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"page",pd->name());
       pd->writeDocumentation(*g_outputList);
     }
   }
@@ -9948,6 +10011,15 @@ void printNavTree(Entry *root,int indent)
 }
 
 
+//----------------------------------------------------------------------------
+// releases the parts of the Entry tree that the remaining passes do not need
+
+static void releaseEntries(Entry *root,const char *lastPass,const std::function<bool(const Entry *)> &isNeeded)
+{
+  size_t released = root->releaseSubEntries(isNeeded);
+  Debug::print(Debug::Entries,0,"Released {} entries after {}\n",released,lastPass);
+}
+
 //----------------------------------------------------------------------------
 // prints the Sections tree (for debugging)
 
@@ -10014,6 +10086,7 @@ static void generateGroupDocs()
   {
     if (!gd->isReference())
     {
+      BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"group",gd->name());
       gd->writeDocumentation(*g_outputList);
     }
   }
@@ -10053,6 +10126,7 @@ static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
              )
           {
             msg("Generating docs for compound {}...\n",ctx->cdm->displayName());
+            BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"class",ctx->cdm->name());
             ctx->cdm->writeDocumentation(ctx->ol);
             ctx->cdm->writeMemberList(ctx->ol);
           }
@@ -10084,7 +10158,7 @@ static void generateNamespaceClassDocs(const ClassLinkedRefMap &classList)
            )
         {
           msg("Generating docs for compound {}...\n",cd->displayName());
-
+          BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"class",cd->name());
           cdm->writeDocumentation(*g_outputList);
           cdm->writeMemberList(*g_outputList);
         }
@@ -10103,6 +10177,7 @@ static void generateNamespaceConceptDocs(const ConceptLinkedRefMap &conceptList)
     if ( cdm && cd->isLinkableInProject() && !cd->isHidden())
     {
       msg("Generating docs for concept {}...\n",cd->name());
+      BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"concept",cd->name());
       cdm->writeDocumentation(*g_outputList);
     }
   }
@@ -10123,6 +10198,7 @@ static void generateNamespaceDocs()
       if (ndm)
       {
         msg("Generating docs for namespace {}\n",nd->displayName());
+        BuildStatisticsTimer statistics(BuildStatistics::Kind::Compound,"namespace",nd->name());
         ndm->writeDocumentation(*g_outputList);
       }
     }
@@ -10160,27 +10236,21 @@ static void runQHelpGenerator()
   if (Debug::isFlagSet(Debug::Qhp)) // produce info for debugging
   {
     // run qhelpgenerator -v and extract the Qt version used
-    QCString cmd=qhgLocation+ " -v 2>&1";
-    Debug::print(Debug::ExtCmd,0,"Executing popen(`{}`)\n",cmd);
-    FILE *f=Portable::popen(cmd,"r");
-    if (!f)
+    // (the output of both streams is shown, as with the former 2>&1 redirection)
+    std::string output, errors;
+    if (Portable::runCommand(qhgLocation+" -v",output,&errors)==-1)
     {
       err("could not execute {}\n",qhgLocation);
     }
     else
     {
-      const size_t bufSize = 1024;
-      char inBuf[bufSize+1];
-      size_t numRead=fread(inBuf,1,bufSize,f);
-      inBuf[numRead] = '\0';
-      Debug::print(Debug::Qhp,0,"{}",inBuf);
-      Portable::pclose(f);
+      output+=errors;
+      Debug::print(Debug::Qhp,0,"{}",output);
 
       int qtVersion=0;
       static const reg::Ex versionReg(R"(Qt (\d+)\.(\d+)\.(\d+))");
       reg::Match match;
-      std::string s = inBuf;
-      if (reg::search(s,match,versionReg))
+      if (reg::search(output,match,versionReg))
       {
         qtVersion = 10000*QCString(match[1].str()).toInt() +
                       100*QCString(match[2].str()).toInt() +
@@ -10190,22 +10260,13 @@ static void runQHelpGenerator()
       {
         // dump the output of qhelpgenerator -c file.qhp
         // Qt<6 or Qt>=6.2.5 or higher, see https://bugreports.qt.io/browse/QTBUG-101070
-        cmd=qhgLocation+ " -c " + Qhp::qhpFileName + " 2>&1";
-        Debug::print(Debug::ExtCmd,0,"Executing popen(`{}`)\n",cmd);
-        f=Portable::popen(cmd,"r");
-        if (!f)
+        if (Portable::runCommand(qhgLocation+" -c "+Qhp::qhpFileName,output,&errors)==-1)
         {
           err("could not execute {}\n",qhgLocation);
         }
         else
         {
-          std::string output;
-          while ((numRead=fread(inBuf,1,bufSize,f))>0)
-          {
-            inBuf[numRead] = '\0';
-            output += inBuf;
-          }
-          Portable::pclose(f);
+          output+=errors;
           Debug::print(Debug::Qhp,0,"{}",output);
         }
       }
@@ -10615,6 +10676,8 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
 {
   QCString fileName=fn;
   AUTO_TRACE("fileName={}",fileName);
+  ProfileScope profile("parse",fileName);
+  BuildStatisticsTimer statistics(BuildStatistics::Kind::InputFile,"",fileName);
   QCString extension;
   int ei = fileName.findRev('.');
   if (ei!=-1)
@@ -10627,6 +10690,7 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
   }
 
   FileInfo fi(fileName.str());
+  statistics.setSize(fi.size());
   std::string preBuf;
 
   if (Config_getBool(ENABLE_PREPROCESSING) &&
@@ -10657,6 +10721,7 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
 
   // convert multi-line C++ comments to C style comments
   convertCppComments(preBuf,convBuf,fileName.str());
+  std::string().swap(preBuf); // no longer needed, release it before parsing
 
   std::shared_ptr<Entry> fileRoot = std::make_shared<Entry>();
   // use language parse to parse the file
@@ -10671,6 +10736,17 @@ static std::shared_ptr<Entry> parseFile(OutlineParserInterface &parser,
 }
 
 //! parse the list of input files
+#if USE_LIBCLANG
+//! keep a parsed translation unit around if its file needs to be processed again for the sources
+static void keepClangTUParser(const FileDef *fd,std::unique_ptr<ClangTUParser> clangParser)
+{
+  if (fd->generateSourceFile() || Doxygen::parseSourcesNeeded)
+  {
+    ClangParser::instance()->keepTUParser(fd,std::move(clangParser));
+  }
+}
+#endif
+
 static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
 {
   AUTO_TRACE();
@@ -10736,6 +10812,7 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
               }
             }
           }
+          keepClangTUParser(fd_l,std::move(clangParser));
           return roots;
         };
         // dispatch the work and collect the future results
@@ -10770,6 +10847,7 @@ static void parseFilesMultiThreading(const std::shared_ptr<Entry> &root)
             auto clangParser = ClangParser::instance()->createTUParser(fd);
             auto fileRoot = parseFile(*parser.get(),fd,qs,clangParser.get(),true);
             roots.push_back(fileRoot);
+            keepClangTUParser(fd,std::move(clangParser));
           }
           else
           {
@@ -10870,6 +10948,7 @@ static void parseFilesSingleThreading(const std::shared_ptr<Entry> &root)
             }
           }
         }
+        keepClangTUParser(fd,std::move(clangParser));
       }
     }
     // process remaining files
@@ -10886,6 +10965,7 @@ static void parseFilesSingleThreading(const std::shared_ptr<Entry> &root)
           auto parser { getParserForFile(qs) };
           auto fileRoot = parseFile(*parser.get(),fd,qs,clangParser.get(),true);
           root->moveToSubEntryAndKeep(fileRoot);
+          keepClangTUParser(fd,std::move(clangParser));
         }
         else
         {
@@ -12648,6 +12728,10 @@ void parseInput()
 
   addSTLSupport(root);
 
+  // the input files and the files from the tag files are known now, so index them
+  // for fast lookups by findFileDef() during parsing and output generation
+  buildFileNameIndex(Doxygen::inputNameLinkedMap);
+
   g_s.begin("Parsing files\n");
   if (g_singleComment)
   {
@@ -12839,6 +12923,7 @@ void parseInput()
   }
   computeClassRelations();
   g_classEntries.clear();
+  buildClassInheritanceIndex();
   g_s.end();
 
   g_s.begin("Add enum values to enums...\n");
@@ -12856,6 +12941,13 @@ void parseInput()
   transferStaticInstanceInitializers();
   g_s.end();
 
+  // From here on only the page and group entries are needed (see buildPageList(),
+  // findMainPage(), findMainPageTagFiles(), computePageRelations() and findGroupScope()),
+  // so the rest of the Entry tree is released to reduce the peak memory usage.
+  printNavTree(root.get(),0);
+  releaseEntries(root.get(),"member documentation",[](const Entry *e)
+      { return e->section.isPageDoc() || e->section.isMainpageDoc() || e->section.isGroupDoc(); });
+
   // moved to after finding and copying documentation,
   // as this introduces new members see bug 722654
   g_s.begin("Creating members for template instances...\n");
@@ -12880,6 +12972,9 @@ void parseInput()
   findGroupScope(root.get());
   g_s.end();
 
+  // this was the last pass reading the Entry tree
+  root.reset();
+
   g_s.begin("Computing module relations...\n");
   auto &mm = ModuleManager::instance();
   mm.resolvePartitions();
@@ -12944,6 +13039,7 @@ void parseInput()
 
   g_s.begin("Computing member relations...\n");
   mergeCategories();
+  buildClassInheritanceIndex(); // categories may have added base classes
   computeMemberRelations();
   g_s.end();
 
@@ -13056,7 +13152,10 @@ void parseInput()
     }
   }
 
-  printNavTree(root.get(),0);
+  g_s.begin("Freezing symbols...\n");
+  freezeSymbols();
+  g_s.end();
+
   printSectionsTree();
 }
 
@@ -13215,6 +13314,7 @@ void generateOutput()
 
   g_s.begin("Generating file sources...\n");
   generateFileSources();
+  freezeSymbolReferences();
   g_s.end();
 
   g_s.begin("Generating file documentation...\n");
@@ -13321,6 +13421,11 @@ void generateOutput()
     g_s.end();
   }
 
+  // the steps below read back generated output files
+  g_s.begin("Waiting for output files to be written...\n");
+  AsyncFileWriter::instance().waitForCompletion();
+  g_s.end();
+
   if (generateRtf)
   {
     g_s.begin("Combining RTF output...\n");
@@ -13342,6 +13447,10 @@ void generateOutput()
     g_s.end();
   }
 
+  g_s.begin("Waiting for class diagram images to be written...\n");
+  ImageManager::instance().waitForCompletion();
+  g_s.end();
+
   if (generateHtml &&
       Config_getBool(GENERATE_HTMLHELP) &&
       !Config_getString(HHC_LOCATION).isEmpty())
@@ -13389,6 +13498,7 @@ void generateOutput()
          (static_cast<double>(Debug::elapsedTime())),
          Portable::getSysElapsedTime()/static_cast<double>(numThreads)
         );
+    Portable::printSysToolTimes();
     g_s.print();
 
     Debug::clearFlag(Debug::Time);
@@ -13400,6 +13510,11 @@ void generateOutput()
     msg("finished...\n");
   }
 
+  if (Profiler::isEnabled())
+  {
+    Profiler::writeTrace(Config_getString(OUTPUT_DIRECTORY)+"/trace.json");
+  }
+  BuildStatistics::instance().write(cacheParam);
 
   /**************************************************************************
    *                        Start cleaning up                               *
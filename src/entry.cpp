@@ -177,6 +177,19 @@ void Entry::removeSubEntry(const Entry *e)
   }
 }
 
+size_t Entry::releaseSubEntries(const std::function<bool(const Entry *)> &isNeeded)
+{
+  size_t released=0;
+  for (const auto &e : m_sublist)
+  {
+    released+=e->releaseSubEntries(isNeeded);
+  }
+  auto it = std::remove_if(m_sublist.begin(),m_sublist.end(),
+      [&isNeeded](const std::shared_ptr<Entry> &elem) { return elem->m_sublist.empty() && !isNeeded(elem.get()); });
+  released+=static_cast<size_t>(std::distance(it,m_sublist.end()));
+  m_sublist.erase(it,m_sublist.end());
+  return released;
+}
 
 void Entry::reset()
 {
@@ -159,6 +159,11 @@ class Entry
      */
     void removeSubEntry(const Entry *e);
 
+    /*! Removes all sub trees that do not contain an entry for which \a isNeeded
+     *  returns true. Returns the number of entries that were removed.
+     */
+    size_t releaseSubEntries(const std::function<bool(const Entry *)> &isNeeded);
+
     /*! Restore the state of this Entry to the default value it has
      *  at construction time.
      */
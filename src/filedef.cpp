@@ -1688,26 +1688,17 @@ void FileDefImpl::acquireFileVersion()
   {
     msg("Version of {} : ",m_filePath);
     QCString cmd = vercmd+" \""+m_filePath+"\"";
-    Debug::print(Debug::ExtCmd,0,"Executing popen(`{}`)\n",cmd);
-    FILE *f=Portable::popen(cmd,"r");
-    if (!f)
+    std::string output;
+    if (Portable::runCommand(cmd,output)==-1)
     {
       err("could not execute {}\n",vercmd);
       return;
     }
-    const int bufSize=1024;
-    char buf[bufSize];
-    int numRead = static_cast<int>(fread(buf,1,bufSize-1,f));
-    Portable::pclose(f);
-    if (numRead>0 && numRead<bufSize)
+    m_fileVersion=QCString(output).stripWhiteSpace();
+    if (!m_fileVersion.isEmpty())
     {
-      buf[numRead]='\0';
-      m_fileVersion=QCString(buf,numRead).stripWhiteSpace();
-      if (!m_fileVersion.isEmpty())
-      {
-        msg("{}\n",m_fileVersion);
-        return;
-      }
+      msg("{}\n",m_fileVersion);
+      return;
     }
     msg("no version available\n");
   }
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "linkedmap.h"
+#include "pathsuffixindex.h"
 #include "utf8.h"
 #include "util.h"
 
@@ -34,10 +35,17 @@ class FileName : public std::vector< std::unique_ptr<FileDef> >
     QCString fullName() const { return m_fName; }
     QCString path() const { return m_pathName; }
 
+    /** Sets the index of the paths of the files, see findFileDef() */
+    void setSuffixIndex(std::unique_ptr<PathSuffixIndex> index) { m_suffixIndex = std::move(index); }
+    /** Returns the index of the paths of the files, or nullptr if there is no up to date index */
+    const PathSuffixIndex *suffixIndex() const
+    { return m_suffixIndex && m_suffixIndex->size()==size() ? m_suffixIndex.get() : nullptr; }
+
   private:
     QCString m_name;
     QCString m_fName;
     QCString m_pathName;
+    std::unique_ptr<PathSuffixIndex> m_suffixIndex;
 };
 
 //! Custom combined key compare and hash functor that uses a lower case string in
@@ -71,6 +79,13 @@ class FileNameFn
 class FileNameLinkedMap : public LinkedMap<FileName,FileNameFn,FileNameFn,
                                            std::unordered_multimap<std::string,FileName*,FileNameFn,FileNameFn> >
 {
+  public:
+    /** Marks the map as complete: files will no longer be added, so lookups need no locking */
+    void setComplete() { m_complete = true; }
+    bool isComplete() const { return m_complete; }
+    void clear() { LinkedMap::clear(); m_complete = false; }
+  private:
+    bool m_complete = false;
 };
 
 #endif
@@ -39,12 +39,20 @@
 
 static int determineInkscapeVersion(const Dir &thisDir);
 
+/** Bounding box of a formula as determined by ghostscript's bbox device */
+struct FormulaBoundingBox
+{
+  int x1=0,y1=0,x2=0,y2=0;
+  double x1hi=0.0,y1hi=0.0,x2hi=0.0,y2hi=0.0;
+};
+
 struct FormulaManager::Private
 {
   LinkedMap<Formula>      formulas;
   std::map<int,Formula *> formulaIdMap;
   bool                    repositoriesValid = true;
   StringVector            tempFiles;
+  std::map<int,FormulaBoundingBox> boundingBoxes; // bounding boxes of the light images, per formula id
 };
 
 FormulaManager::FormulaManager() : p(std::make_unique<Private>())
@@ -248,7 +256,7 @@ static bool createDVIFile(const QCString &fileName)
   {
     //printf("Running latex...\n");
     qsnprintf(args,argsLen,"-interaction=batchmode %s >%s",qPrint(fileName),Portable::devNull());
-    if ((Portable::system(latexCmd,args)!=0) || (Portable::system(latexCmd,args)!=0))
+    if (Portable::system(latexCmd,args)!=0)
     {
       err("Problems running latex. Check your installation or look "
           "for typos in {0}.tex and check {0}.log!\n",fileName);
@@ -281,6 +289,76 @@ static bool createPostscriptFile(const QCString &fileName,const QCString &formBa
   return true;
 }
 
+/** Converts all pages of \a fileName.dvi with a single dvips run: once into
+ *  \a fileName.ps (used to determine the bounding boxes in one go) and once
+ *  split into one postscript file per page. The split pages are renamed
+ *  to the names used by generateFormula(), i.e. \a formBases[i]_tmp.ps
+ *  for page i+1. Returns a vector telling per page whether this succeeded.
+ */
+static BoolVector createPostscriptFiles(const QCString &fileName,const StringVector &formBases)
+{
+  BoolVector result(formBases.size(),false);
+  const size_t argsLen = 4096;
+  char args[argsLen];
+  qsnprintf(args,argsLen,"-q -D 600 -o %s.ps %s.dvi",qPrint(fileName),qPrint(fileName));
+  if (Portable::system("dvips",args)!=0)
+  {
+    err("Problems running dvips. Check your installation!\n");
+    return result;
+  }
+  // with -i and without -S dvips writes each page to a separate file,
+  // replacing the suffix of the output file by the page's sequence number.
+  qsnprintf(args,argsLen,"-q -D 600 -i -o %s_page.ps %s.dvi",qPrint(fileName),qPrint(fileName));
+  if (Portable::system("dvips",args)!=0)
+  {
+    err("Problems running dvips. Check your installation!\n");
+    return result;
+  }
+  Dir thisDir;
+  for (size_t i=0;i<formBases.size();i++)
+  {
+    QCString pageFile;
+    pageFile.sprintf("%s_page.%03d",qPrint(fileName),static_cast<int>(i+1));
+    if (thisDir.exists(pageFile.str()))
+    {
+      result[i] = thisDir.rename(pageFile.str(),formBases[i]+"_tmp.ps");
+    }
+  }
+  return result;
+}
+
+/** Determines the bounding boxes of all pages in \a fileName.ps with a
+ *  single ghostscript run. The box for page i+1 is stored under \a ids[i].
+ *  Returns false if not every page got a bounding box.
+ */
+static bool extractBoundingBoxes(const QCString &fileName,const IntVector &ids,
+                                 std::map<int,FormulaBoundingBox> &boxes)
+{
+  const size_t argsLen = 4096;
+  char args[argsLen];
+  qsnprintf(args,argsLen,"-q -dBATCH -dNOPAUSE -P- -dNOSAFER -sDEVICE=bbox %s.ps 2>%s.epsi",
+      qPrint(fileName),qPrint(fileName));
+  if (Portable::system(Portable::ghostScriptCommand(),args)!=0)
+  {
+    err("Problems running {}. Check your installation!\n",Portable::ghostScriptCommand());
+    return false;
+  }
+  // the bbox device writes a BoundingBox and HiResBoundingBox line per page
+  QCString eps = fileToString(fileName+".epsi");
+  size_t page=0;
+  int i=0;
+  while (page<ids.size() && (i=eps.find("%%BoundingBox:",i))!=-1)
+  {
+    FormulaBoundingBox bb;
+    sscanf(eps.data()+i,"%%%%BoundingBox:%d %d %d %d",&bb.x1,&bb.y1,&bb.x2,&bb.y2);
+    i = eps.find("%%HiResBoundingBox:",i);
+    if (i==-1) break;
+    sscanf(eps.data()+i,"%%%%HiResBoundingBox:%lf %lf %lf %lf",&bb.x1hi,&bb.y1hi,&bb.x2hi,&bb.y2hi);
+    boxes[ids[page++]] = bb;
+  }
+  return page==ids.size();
+}
+
 static bool createEPSbboxFile(const QCString &formBase)
 {
   const size_t argsLen = 4096;
@@ -470,32 +548,45 @@ static bool createPNG(const QCString &formBase,const QCString &outFile,double sc
   return true;
 }
 
+static QCString formulaBaseName(int pageNum,FormulaManager::Mode mode)
+{
+  QCString formBase;
+  formBase.sprintf("_form%d%s",pageNum,mode==FormulaManager::Mode::Light?"":"_dark");
+  return formBase;
+}
+
 static StringVector generateFormula(const Dir &thisDir,const QCString &formulaFileName,Formula *formula,int pageNum,int pageIndex,
-                                    FormulaManager::Format format,FormulaManager::HighDPI hd,FormulaManager::Mode mode)
+                                    FormulaManager::Format format,FormulaManager::HighDPI hd,FormulaManager::Mode mode,
+                                    bool hasPostscript,const FormulaBoundingBox *bbox)
 {
   StringVector tempFiles;
   QCString outputFile;
   outputFile.sprintf("form_%d%s.%s",pageNum, mode==FormulaManager::Mode::Light?"":"_dark", format==FormulaManager::Format::Vector?"svg":"png");
   msg("Generating image {} for formula\n",outputFile);
 
-  QCString formBase;
-  formBase.sprintf("_form%d%s",pageNum,mode==FormulaManager::Mode::Light?"":"_dark");
+  QCString formBase = formulaBaseName(pageNum,mode);
 
-  if (!createPostscriptFile(formulaFileName,formBase,pageIndex)) return tempFiles;
+  // the postscript file is normally already split off by createPostscriptFiles()
+  if (!hasPostscript && !createPostscriptFile(formulaFileName,formBase,pageIndex)) return tempFiles;
 
   int x1=0,y1=0,x2=0,y2=0;
   double x1hi=0.0,y1hi=0.0,x2hi=0.0,y2hi=0.0;
-  if (mode==FormulaManager::Mode::Light)
+  if (bbox) // bounding box already determined by extractBoundingBoxes()
+  {
+    x1=bbox->x1; y1=bbox->y1; x2=bbox->x2; y2=bbox->y2;
+    x1hi=bbox->x1hi; y1hi=bbox->y1hi; x2hi=bbox->x2hi; y2hi=bbox->y2hi;
+  }
+  else if (mode==FormulaManager::Mode::Light)
   {
     if (!createEPSbboxFile(formBase)) return tempFiles;
     // extract the bounding box info from the generated .epsi file
     if (!extractBoundingBox(formBase,&x1,&y1,&x2,&y2,&x1hi,&y1hi,&x2hi,&y2hi)) return tempFiles;
+    tempFiles.push_back(formBase.str()+"_tmp.epsi");
   }
   else // for dark images the bounding box is wrong (includes the black) so
        // use the bounding box of the light image instead.
   {
-    QCString formBaseLight;
-    formBaseLight.sprintf("_form%d",pageNum);
+    QCString formBaseLight = formulaBaseName(pageNum,FormulaManager::Mode::Light);
     if (!extractBoundingBox(formBaseLight,&x1,&y1,&x2,&y2,&x1hi,&y1hi,&x2hi,&y2hi)) return tempFiles;
   }
 
@@ -543,10 +634,6 @@ static StringVector generateFormula(const Dir &thisDir,const QCString &formulaFi
 
   // remove intermediate image files
   tempFiles.push_back(formBase.str()+"_tmp.ps");
-  if (mode==FormulaManager::Mode::Light)
-  {
-    tempFiles.push_back(formBase.str()+"_tmp.epsi");
-  }
   return tempFiles;
 }
 
@@ -560,6 +647,27 @@ void FormulaManager::createFormulasTexFile(Dir &thisDir,Format format,HighDPI hd
   {
     if (!createDVIFile(formulaFileName)) return;
 
+    // split the pages and determine their bounding boxes with a fixed number of
+    // tool invocations, instead of running dvips and ghostscript for every formula.
+    StringVector formBases;
+    for (int pageNum : formulasToGenerate)
+    {
+      formBases.push_back(formulaBaseName(pageNum,mode).str());
+    }
+    BoolVector hasPostscript = createPostscriptFiles(formulaFileName,formBases);
+    if (mode==Mode::Light &&
+        !extractBoundingBoxes(formulaFileName,formulasToGenerate,p->boundingBoxes))
+    {
+      // fall back to determining the bounding boxes per formula
+      p->boundingBoxes.clear();
+    }
+
+    auto getBoundingBox = [this](int pageNum) -> const FormulaBoundingBox *
+    {
+      auto it = p->boundingBoxes.find(pageNum);
+      return it!=p->boundingBoxes.end() ? &it->second : nullptr;
+    };
+
     auto getFormula = [this](int pageNum) -> Formula *
     {
       auto it = p->formulaIdMap.find(pageNum);
@@ -580,9 +688,11 @@ void FormulaManager::createFormulasTexFile(Dir &thisDir,Format format,HighDPI hd
       {
         // create images for each formula.
         auto formula = getFormula(pageNum);
+        bool hasPs = hasPostscript[pageIndex-1];
+        auto bbox = getBoundingBox(pageNum);
         auto processFormula = [=]() -> StringVector
         {
-          return generateFormula(thisDir,formulaFileName,formula,pageNum,pageIndex,format,hd,mode);
+          return generateFormula(thisDir,formulaFileName,formula,pageNum,pageIndex,format,hd,mode,hasPs,bbox);
         };
         results.emplace_back(threadPool.queue(processFormula));
         pageIndex++;
@@ -599,7 +709,8 @@ void FormulaManager::createFormulasTexFile(Dir &thisDir,Format format,HighDPI hd
       {
         // create images for each formula.
         auto formula = getFormula(pageNum);
-        StringVector tf = generateFormula(thisDir,formulaFileName,formula,pageNum,pageIndex,format,hd,mode);
+        StringVector tf = generateFormula(thisDir,formulaFileName,formula,pageNum,pageIndex,format,hd,mode,
+                                          hasPostscript[pageIndex-1],getBoundingBox(pageNum));
         p->tempFiles.insert(p->tempFiles.end(),tf.begin(),tf.end()); // append tf to p->tempFiles
 
         pageIndex++;
@@ -607,6 +718,8 @@ void FormulaManager::createFormulasTexFile(Dir &thisDir,Format format,HighDPI hd
     }
     // remove intermediate files produced by latex
     p->tempFiles.push_back(formulaFileName.str()+".dvi");
+    p->tempFiles.push_back(formulaFileName.str()+".ps");
+    p->tempFiles.push_back(formulaFileName.str()+".epsi");
     p->tempFiles.push_back(formulaFileName.str()+".log");
     p->tempFiles.push_back(formulaFileName.str()+".aux");
   }
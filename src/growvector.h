@@ -34,22 +34,24 @@
  *  separately and provides random access to its members.
  *
  *  It is implemented as a vector of chunks where each chunk is a fixed capacity vector of T.
+ *  Since a chunk never grows beyond its initial capacity, its elements stay at the same
+ *  address when the vector of chunks is reallocated. Both the chunks and the vector of chunks
+ *  are allocated using \a Allocator.
  */
-template<class T>
+template<class T,class Allocator=std::allocator<T>>
 class GrowVector
 {
   private:
     static const size_t chunkBits = 4; // a chunk holds 2^bits elements
     static const size_t chunkSize = 1 << chunkBits;
     static const size_t chunkMask = chunkSize-1;
-    struct Chunk
-    {
-      Chunk() { data.reserve(chunkSize); }
-      std::vector<T> data;
-    };
-    using ChunkPtr = std::unique_ptr<Chunk>;
+    using Chunk          = std::vector<T,Allocator>;
+    using ChunkAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
 
   public:
+    /// creates an empty vector that allocates its memory using \a alloc
+    explicit GrowVector(const Allocator &alloc = Allocator()) : m_chunks(ChunkAllocator(alloc)) {}
+
     /// @brief bidirectional iterator
     template<class C,class I>
     class Iterator
@@ -93,14 +95,14 @@ class GrowVector
     size_t size() const
     {
       return m_chunks.empty() ? 0 : (m_chunks.size()-1)*chunkSize +
-                                     m_chunks.back()->data.size();
+                                     m_chunks.back().size();
     }
 
     /// adds an element to the end
     void push_back(T &&t)
     {
       make_room();
-      m_chunks.back()->data.push_back(std::move(t));
+      m_chunks.back().push_back(std::move(t));
     }
 
     /// constructs an element in-place at the end
@@ -108,33 +110,33 @@ class GrowVector
     void emplace_back(Args&&...args)
     {
       make_room();
-      m_chunks.back()->data.emplace_back(std::forward<Args>(args)...);
+      m_chunks.back().emplace_back(std::forward<Args>(args)...);
     }
 
     /// removes the last element
     void pop_back()
     {
-      m_chunks.back()->data.pop_back();
-      if (m_chunks.back()->data.size()==0) // remove chunk if empty
+      m_chunks.back().pop_back();
+      if (m_chunks.back().empty()) // remove chunk if empty
       {
         m_chunks.pop_back();
       }
     }
 
     /// access specified element
-          T &at(size_t i)       { return m_chunks.at(i>>chunkBits)->data.at(i&chunkMask); }
+          T &at(size_t i)       { return m_chunks.at(i>>chunkBits).at(i&chunkMask); }
     /// access specified element
-    const T &at(size_t i) const { return m_chunks.at(i>>chunkBits)->data.at(i&chunkMask); }
+    const T &at(size_t i) const { return m_chunks.at(i>>chunkBits).at(i&chunkMask); }
 
     /// access the first element
-          T &front()            { return m_chunks.front()->data.front(); }
+          T &front()            { return m_chunks.front().front(); }
     /// access the first element
-    const T &front() const      { return m_chunks.front()->data.front(); }
+    const T &front() const      { return m_chunks.front().front(); }
 
     /// access the last element
-          T &back()             { return m_chunks.back()->data.back(); }
+          T &back()             { return m_chunks.back().back(); }
     /// access the last element
-    const T &back() const       { return m_chunks.back()->data.back(); }
+    const T &back() const       { return m_chunks.back().back(); }
 
     /// checks whether the container is empty
     bool empty() const          { return m_chunks.empty(); }
@@ -146,12 +148,13 @@ class GrowVector
     void make_room()
     {
       if (m_chunks.empty() ||
-          m_chunks.back()->data.size()==chunkSize) // add new chuck if needed
+          m_chunks.back().size()==chunkSize) // add new chuck if needed
       {
-        m_chunks.push_back(std::make_unique<Chunk>());
+        m_chunks.emplace_back(Allocator(m_chunks.get_allocator()));
+        m_chunks.back().reserve(chunkSize);
       }
     }
-    std::vector<ChunkPtr> m_chunks;
+    std::vector<Chunk,ChunkAllocator> m_chunks;
 };
 
 #endif
@@ -56,6 +56,7 @@
 #include "portable.h"
 #include "outputlist.h"
 #include "stringutil.h"
+#include "profiler.h"
 
 //#define DBG_HTML(x) x;
 #define DBG_HTML(x)
@@ -1530,7 +1531,7 @@ void HtmlGenerator::writeFooterFile(TextStream &t)
   t << ResourceMgr::instance().getAsString("footer.html");
 }
 
-static std::mutex g_indexLock;
+static ProfiledMutex g_indexLock("g_indexLock");
 
 void HtmlGenerator::startFile(const QCString &name,bool isSource,const QCString &,
                               const QCString &title,int /*id*/, int /*hierarchyLevel*/)
@@ -1545,7 +1546,7 @@ void HtmlGenerator::startFile(const QCString &name,bool isSource,const QCString
   m_codeGen->setFileName(fileName);
   m_codeGen->setRelativePath(m_relPath);
   {
-    std::lock_guard<std::mutex> lock(g_indexLock);
+    std::lock_guard<ProfiledMutex> lock(g_indexLock);
     Doxygen::indexList->addIndexFile(fileName);
   }
 
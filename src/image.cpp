@@ -15,13 +15,25 @@
 
 #include <vector>
 #include <cmath>
+#include <future>
+#include <mutex>
 
 #include "image.h"
 #include "lodepng.h"
 #include "config.h"
+#include "threadpool.h"
 
 typedef unsigned char  Byte;
 
+/** Configures \a encoder to use the hash chain based LZ77 search, which
+ *  is much faster than the default exhaustive search at a similar compression ratio.
+ */
+static void setFastCompression(LodePNG_Encoder *encoder)
+{
+  encoder->settings.zlibsettings.windowSize     = 32768;
+  encoder->settings.zlibsettings.maxChainLength = 32;
+}
+
 /** Helper struct representing a RGBA color */
 struct Color
 {
@@ -349,6 +361,7 @@ bool Image::save(const QCString &fileName)
   size_t bufferSize = 0;
   LodePNG_Encoder encoder;
   LodePNG_Encoder_init(&encoder);
+  setFastCompression(&encoder);
   for (const auto &col : p->palette)
   {
     LodePNG_InfoColor_addPalette(&encoder.infoPng.color,
@@ -463,6 +476,7 @@ bool ColoredImage::save(const QCString &fileName)
   size_t bufferSize = 0;
   LodePNG_Encoder encoder;
   LodePNG_Encoder_init(&encoder);
+  setFastCompression(&encoder);
   encoder.infoPng.color.colorType = p->hasAlpha ? 6 : 2; // 2=RGB 24 bit, 6=RGBA 32 bit
   encoder.infoRaw.color.colorType = 6; // 6=RGBA 32 bit
   LodePNG_encode(&encoder, &buffer, &bufferSize, &p->data[0], p->width, p->height);
@@ -473,3 +487,51 @@ bool ColoredImage::save(const QCString &fileName)
 }
 
 
+
+//----------------------------------------------------------------
+
+struct ImageManager::Private
+{
+  std::mutex mutex;
+  std::unique_ptr<ThreadPool> workers;
+  std::vector< std::future<void> > results;
+};
+
+ImageManager &ImageManager::instance()
+{
+  static ImageManager theInstance;
+  return theInstance;
+}
+
+ImageManager::ImageManager() : p(std::make_unique<Private>())
+{
+}
+
+ImageManager::~ImageManager() = default;
+
+void ImageManager::save(std::unique_ptr<Image> image,const QCString &fileName)
+{
+  std::lock_guard<std::mutex> lock(p->mutex);
+  if (!p->workers)
+  {
+    std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+    if (numThreads<1) numThreads=1;
+    p->workers = std::make_unique<ThreadPool>(numThreads);
+  }
+  // the task owns the image, so it stays alive until it has been written
+  std::shared_ptr<Image> img = std::move(image);
+  p->results.emplace_back(p->workers->queue([img,fileName]() { img->save(fileName); }));
+}
+
+void ImageManager::waitForCompletion()
+{
+  std::vector< std::future<void> > results;
+  {
+    std::lock_guard<std::mutex> lock(p->mutex);
+    std::swap(results,p->results);
+  }
+  for (auto &f : results)
+  {
+    f.get();
+  }
+}
@@ -69,4 +69,28 @@ class ColoredImage
     std::unique_ptr<Private> p;
 };
 
+/** Singleton that encodes and writes images on background threads, so that
+ *  page generation can continue while the PNG data is compressed.
+ */
+class ImageManager
+{
+  public:
+    static ImageManager &instance();
+
+    /** Queues \a image to be saved as \a fileName. Ownership of the image is
+     *  transferred to the manager.
+     */
+    void save(std::unique_ptr<Image> image,const QCString &fileName);
+
+    /** Blocks until all queued images have been written to disk. */
+    void waitForCompletion();
+
+  private:
+    ImageManager();
+   ~ImageManager();
+    NON_COPYABLE(ImageManager)
+    struct Private;
+    std::unique_ptr<Private> p;
+};
+
 #endif
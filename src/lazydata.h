@@ -0,0 +1,110 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef LAZYDATA_H
+#define LAZYDATA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/** @brief Holder for data that most objects of a class do not have.
+ *
+ *  The data is only allocated when it is modified for the first time, so the
+ *  owning object pays for a single pointer as long as the data is empty.
+ *  Reading data that was never created returns a shared default constructed
+ *  object. Copying the holder copies the data.
+ *
+ *  Creating the data is not thread safe, so it should only be modified from one
+ *  thread at a time, like the objects owning it.
+ */
+template<class T>
+class LazyData
+{
+  public:
+    LazyData() = default;
+   ~LazyData() { reset(); }
+    LazyData(const LazyData &other) { *this = other; }
+    LazyData &operator=(const LazyData &other)
+    {
+      if (this!=&other)
+      {
+        if (other.m_data) edit() = *other.m_data; else reset();
+      }
+      return *this;
+    }
+    LazyData(LazyData &&other) noexcept : m_data(std::move(other.m_data)) {}
+    LazyData &operator=(LazyData &&other) noexcept
+    {
+      if (this!=&other)
+      {
+        reset();
+        m_data = std::move(other.m_data);
+      }
+      return *this;
+    }
+
+    /** Returns the data, or an empty object if the data was never created. */
+    const T &get() const
+    {
+      static const T empty;
+      return m_data ? *m_data : empty;
+    }
+
+    /** Returns the data for modification, creating it if needed. */
+    T &edit()
+    {
+      if (!m_data)
+      {
+        m_data = std::make_unique<T>();
+        s_numCreated++;
+      }
+      return *m_data;
+    }
+
+    /** Returns TRUE if the data was created. */
+    bool isCreated() const { return m_data!=nullptr; }
+
+    /** Releases the data. */
+    void reset()
+    {
+      if (m_data)
+      {
+        m_data.reset();
+        s_numCreated--;
+      }
+    }
+
+    /** Returns the number of objects of type T that are currently allocated by a LazyData holder. */
+    static size_t numCreated() { return s_numCreated; }
+
+  private:
+    std::unique_ptr<T> m_data;
+    static inline std::atomic<size_t> s_numCreated { 0 };
+};
+
+/** Memory used by the fixed size part of the objects of a class that keeps its
+ *  rarely used fields in LazyData holders, compared to storing all fields in the
+ *  object itself. Heap memory owned by the fields, like string contents, is not included.
+ */
+struct LazyDataStats
+{
+  size_t objects = 0;      //!< number of objects currently alive
+  size_t withData = 0;     //!< number of side structures currently allocated
+  size_t compactBytes = 0; //!< bytes used by the objects and their side structures
+  size_t flatBytes = 0;    //!< bytes that would be used if the side structures were part of the objects
+};
+
+#endif
@@ -32,6 +32,7 @@
 #include "datetime.h"
 #include "portable.h"
 #include "outputlist.h"
+#include "asyncfilewriter.h"
 
 static QCString getExtension()
 {
@@ -535,16 +536,11 @@ void ManGenerator::startDoxyAnchor(const QCString &,const QCString &manName,
     //       name,qPrint(baseName),qPrint(buildFileName(baseName)));
 
     // - remove dangerous characters and append suffix, then add dir prefix
+    // - the link goes through the same writer as the pages, so it never replaces a page
+    //   with the same name, even if that page is still queued
     QCString fileName=dir()+"/"+buildFileName( baseName );
-    FileInfo fi(fileName.str());
-    if (!fi.exists())
-    {
-      std::ofstream linkStream = Portable::openOutputStream(fileName);
-      if (linkStream.is_open())
-      {
-        linkStream << ".so " << getSubdir() << "/" << buildFileName( manName ) << "\n";
-      }
-    }
+    AsyncFileWriter::instance().writeIfAbsent(fileName,
+        ".so "+getSubdir().str()+"/"+buildFileName( manName ).str()+"\n");
 }
 
 void ManGenerator::addLabel(const QCString &,const QCString &)
@@ -16,6 +16,7 @@
 
 #include <stdio.h>
 #include <assert.h>
+#include <atomic>
 #include <mutex>
 
 #include "md5.h"
@@ -47,9 +48,13 @@
 #include "definitionimpl.h"
 #include "regex.h"
 #include "trace.h"
+#include "lazydata.h"
 
 //-----------------------------------------------------------------------------
 
+//! number of MemberDefImpl objects that are alive, see memberDefLazyDataStats()
+static std::atomic<size_t> g_numMemberDefs { 0 };
+
 class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
 {
   public:
@@ -58,7 +63,7 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
               const QCString &excp,Protection prot,Specifier virt,bool stat,
               Relationship related,MemberType t,const ArgumentList &tal,
               const ArgumentList &al,const QCString &metaData);
-   ~MemberDefImpl() override = default;
+   ~MemberDefImpl() override { g_numMemberDefs--; }
     NON_COPYABLE(MemberDefImpl)
 
     DefType definitionType() const override        { return TypeMember; }
@@ -357,6 +362,8 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     void setModuleDef(ModuleDef *mod) override;
     int redefineCount() const override;
     void setRedefineCount(int) override;
+    void freeze() override;
+    void freezeReferences() override;
 
   private:
     void _computeLinkableInProject();
@@ -390,9 +397,48 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
               const ArgumentList &al,const QCString &meta
              );
 
-    uint8_t m_isLinkableCached;    // 0 = not cached, 1=FALSE, 2=TRUE
-    uint8_t m_isConstructorCached; // 0 = not cached, 1=FALSE, 2=TRUE
-    uint8_t m_isDestructorCached;  // 1 = not cached, 1=FALSE, 2=TRUE
+    /** Data that most members do not have, allocated when it is set for the first time */
+    struct RareData
+    {
+      QCString bitfields;       // struct member bitfields
+      QCString read;            // property read accessor
+      QCString write;           // property write accessor
+      QCString exception;       // exceptions that can be thrown
+      QCString initializer;     // initializer
+      QCString extraTypeChars;  // extra type info found after the argument list
+      QCString enumBaseType;    // base type of the enum (C++11)
+      QCString requiresClause;  // requires clause (C++20)
+      QCString metaData;        // Slice metadata.
+      QCString accessorType;    // return type that tell how to get to this member
+      ClassDef *accessorClass = nullptr;  // class that this member accesses (for anonymous types)
+      ClassDef *relatedAlso = nullptr;    // points to class marked by relatedAlso
+
+      MemberVector enumFields;  // enumeration fields
+      ExampleList examples;     // a dictionary of all examples for quick access
+
+      ArgumentList tArgList;        // template argument list of function template
+      ArgumentList typeConstraints; // type constraints for template parameters
+      std::optional<ArgumentList> formalTemplateArguments;
+      ArgumentLists defTmpArgLists; // lists of template argument lists
+                                    // (for template functions in nested template classes)
+
+      // to store the output file base from tag files
+      QCString explicitOutputFileBase;
+
+      // to store extra qualifiers
+      StringVector qualifiers;
+
+      // objective-c
+      ClassDef *category = nullptr;
+      const MemberDef *categoryRelation = nullptr;
+    };
+    friend LazyDataStats memberDefLazyDataStats();
+
+    // sets a string of the rare data, without allocating it to store an empty string
+    void setRareString(QCString RareData::*field,const QCString &value)
+    {
+      if (!value.isEmpty() || m_rare.isCreated()) m_rare.edit().*field = value;
+    }
 
     ClassDef     *m_classDef = nullptr; // member of or related to
     FileDef      *m_fileDef  = nullptr; // member of file definition
@@ -400,58 +446,35 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     ModuleDef    *m_moduleDef = nullptr;
 
     const MemberDef  *m_enumScope = nullptr;    // the enclosing scope, if this is an enum field
-    bool        m_livesInsideEnum = false;
     const MemberDef  *m_annEnumType = nullptr;  // the anonymous enum that is the type of this member
-    MemberVector m_enumFields;              // enumeration fields
 
     MemberDef  *m_redefines = nullptr;    // the members that this member redefines
     MemberVector m_redefinedBy;             // the list of members that redefine this one
 
     MemberDef  *m_memDef = nullptr;       // member definition for this declaration
     MemberDef  *m_memDec = nullptr;       // member declaration for this definition
-    ClassDef   *m_relatedAlso = nullptr;  // points to class marked by relatedAlso
-
-    ExampleList m_examples;     // a dictionary of all examples for quick access
+    MemberDef  *m_annMemb = nullptr;
 
     QCString m_type;            // return actual type
-    QCString m_accessorType;    // return type that tell how to get to this member
-    ClassDef *m_accessorClass = nullptr;  // class that this member accesses (for anonymous types)
     QCString m_args;            // function arguments/variable array specifiers
     QCString m_def;             // member definition in code (fully qualified name)
     QCString m_anc;             // HTML anchor name
-    Specifier m_virt = Specifier::Normal;  // normal/virtual/pure virtual
-    Protection m_prot = Protection::Public; // protection type [Public/Protected/Private]
     QCString m_decl;            // member declaration in class
 
-    QCString m_bitfields;       // struct member bitfields
-    QCString m_read;            // property read accessor
-    QCString m_write;           // property write accessor
-    QCString m_exception;       // exceptions that can be thrown
-    QCString m_initializer;     // initializer
-    QCString m_extraTypeChars;  // extra type info found after the argument list
-    QCString m_enumBaseType;    // base type of the enum (C++11)
-    QCString m_requiresClause;  // requires clause (C++20)
-    int m_initLines = 0;            // number of lines in the initializer
-
     TypeSpecifier m_memSpec;          // The specifiers present for this member
     VhdlSpecifier m_vhdlSpec;
     MemberType m_mtype = MemberType::Define; // returns the kind of member
+    Specifier m_virt = Specifier::Normal;  // normal/virtual/pure virtual
+    Protection m_prot = Protection::Public; // protection type [Public/Protected/Private]
+    Relationship m_related = Relationship::Member;    // relationship of this to the class
+    int m_initLines = 0;            // number of lines in the initializer
     int m_maxInitLines = 0;         // when the initializer will be displayed
     int m_userInitLines = 0;        // result of explicit \hideinitializer or \showinitializer
-    MemberDef  *m_annMemb = nullptr;
 
     ArgumentList m_defArgList;    // argument list of this member definition
     ArgumentList m_declArgList;   // argument list of this member declaration
 
-    ArgumentList m_tArgList;      // template argument list of function template
-    ArgumentList m_typeConstraints; // type constraints for template parameters
     const MemberDef *m_templateMaster = nullptr;
-    std::optional<ArgumentList> m_formalTemplateArguments;
-    ArgumentLists m_defTmpArgLists; // lists of template argument lists
-                                         // (for template functions in nested template classes)
-
-    QCString m_metaData;        // Slice metadata.
-
     mutable ClassDef *m_cachedAnonymousType = nullptr; // if the member has an anonymous compound
                                    // as its type then this is computed by
                                    // getClassDefOfAnonymousType() and
@@ -467,7 +490,6 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     int m_groupStartLine = 0;       // line  "      "      "     "     "
     MemberDef *m_groupMember = nullptr;
 
-    bool m_isTypedefValCached = false;
     const ClassDef *m_cachedTypedefValue = nullptr;
     QCString m_cachedTypedefTemplSpec;
     QCString m_cachedResolvedType;
@@ -475,46 +497,49 @@ class MemberDefImpl : public DefinitionMixin<MemberDefMutable>
     // documentation inheritance
     const MemberDef *m_docProvider = nullptr;
 
-    // to store the output file base from tag files
-    QCString m_explicitOutputFileBase;
+    QCString m_declFileName;
+    int m_declLine = -1;
+    int m_declColumn = -1;
+    int m_numberOfFlowKW = 0;
+    int m_redefineCount = 0;
+
+    LazyData<RareData> m_rare;
 
-    // to store extra qualifiers
-    StringVector m_qualifiers;
+    uint8_t m_isLinkableCached;    // 0 = not cached, 1=FALSE, 2=TRUE
+    uint8_t m_isConstructorCached; // 0 = not cached, 1=FALSE, 2=TRUE
+    uint8_t m_isDestructorCached;  // 1 = not cached, 1=FALSE, 2=TRUE
 
-    // objective-c
-    bool m_implOnly = false; // function found in implementation but not
-                           // in the interface
+    // flags that can be set while generating output, or that are read without a lock while
+    // another thread sets them, must not share a memory location, so they are not bit fields
+    bool m_isTypedefValCached = false;
     mutable bool m_hasDocumentedParams = false;      // guard to show only the first warning, acts as cache
     mutable bool m_hasDocumentedReturnType = false;  // guard to show only the first warning, acts as cache
-    bool m_isDMember = false;
-    Relationship m_related = Relationship::Member;    // relationship of this to the class
-    bool m_stat = false;                // is it a static function?
-    bool m_proto = false;               // is it a prototype?
-    bool m_docEnumValues = false;       // is an enum with documented enum values.
-
-    bool m_annScope = false;    // member is part of an anonymous scope
     mutable bool m_hasDetailedDescriptionCached = false;
     mutable bool m_detailedDescriptionCachedValue = false;
-                                      // const member.
-    bool m_hasCallGraph = false;
-    bool m_hasCallerGraph = false;
-    bool m_hasReferencedByRelation = false;
-    bool m_hasReferencesRelation = false;
-    bool m_hasInlineSource = false;
-    bool m_hasEnumValues = false;
-    bool m_explExt = false;             // member was explicitly declared external
-    bool m_tspec = false;               // member is a template specialization
-    bool m_groupHasDocs = false;        // true if the entry that caused the grouping was documented
-    bool m_docsForDefinition = false;   // TRUE => documentation block is put before
-                                      //         definition.
-                                      // FALSE => block is put before declaration.
-    ClassDef *m_category = nullptr;
-    const MemberDef *m_categoryRelation = nullptr;
-    QCString m_declFileName;
-    int m_declLine = -1;
-    int m_declColumn = -1;
-    int m_numberOfFlowKW = 0;
-    int m_redefineCount = 0;
+    bool m_frozen = false;            // m_cachedAnonymousType is final, see freeze()
+    bool m_referencesFrozen = false;  // m_detailedDescriptionCachedValue is final, see freezeReferences()
+
+    // flags that are only set while building the symbol tables, initialized in init()
+    bool m_livesInsideEnum : 1;
+    bool m_implOnly : 1;                // objective-c: function found in implementation but not
+                                        // in the interface
+    bool m_isDMember : 1;
+    bool m_stat : 1;                    // is it a static function?
+    bool m_proto : 1;                   // is it a prototype?
+    bool m_docEnumValues : 1;           // is an enum with documented enum values.
+    bool m_annScope : 1;                // member is part of an anonymous scope
+    bool m_hasCallGraph : 1;
+    bool m_hasCallerGraph : 1;
+    bool m_hasReferencedByRelation : 1;
+    bool m_hasReferencesRelation : 1;
+    bool m_hasInlineSource : 1;
+    bool m_hasEnumValues : 1;
+    bool m_explExt : 1;                 // member was explicitly declared external
+    bool m_tspec : 1;                   // member is a template specialization
+    bool m_groupHasDocs : 1;            // true if the entry that caused the grouping was documented
+    bool m_docsForDefinition : 1;       // TRUE => documentation block is put before
+                                        //         definition.
+                                        // FALSE => block is put before declaration.
 };
 
 std::unique_ptr<MemberDef> createMemberDef(const QCString &defFileName,int defLine,int defColumn,
@@ -527,6 +552,17 @@ std::unique_ptr<MemberDef> createMemberDef(const QCString &defFileName,int defLi
                            stat,related,t,tal,al,metaData);
 }
 
+LazyDataStats memberDefLazyDataStats()
+{
+  using RareData = MemberDefImpl::RareData;
+  LazyDataStats stats;
+  stats.objects      = g_numMemberDefs;
+  stats.withData     = LazyData<RareData>::numCreated();
+  stats.compactBytes = stats.objects*sizeof(MemberDefImpl) + stats.withData*sizeof(RareData);
+  stats.flatBytes    = stats.objects*(sizeof(MemberDefImpl)-sizeof(LazyData<RareData>)+sizeof(RareData));
+  return stats;
+}
+
 //-----------------------------------------------------------------------------
 
 class MemberDefAliasImpl : public DefinitionAliasMixin<MemberDef>
@@ -1334,8 +1370,6 @@ void MemberDefImpl::init(Definition *d,
   m_fileDef=nullptr;
   m_moduleDef=nullptr;
   m_redefines=nullptr;
-  m_relatedAlso=nullptr;
-  m_accessorClass=nullptr;
   m_nspace=nullptr;
   m_memDef=nullptr;
   m_memDec=nullptr;
@@ -1343,6 +1377,7 @@ void MemberDefImpl::init(Definition *d,
   m_grpId=-1;
   m_enumScope=nullptr;
   m_livesInsideEnum=FALSE;
+  m_groupHasDocs=FALSE;
   m_hasCallGraph            = Config_getBool(CALL_GRAPH);
   m_hasCallerGraph          = Config_getBool(CALLER_GRAPH);
   m_hasReferencedByRelation = Config_getBool(REFERENCED_BY_RELATION);
@@ -1366,7 +1401,7 @@ void MemberDefImpl::init(Definition *d,
   m_related=r;
   m_stat=s;
   m_mtype=mt;
-  m_exception=e;
+  if (!e.isEmpty()) m_rare.edit().exception=e;
   m_proto=FALSE;
   m_annScope=FALSE;
   m_memSpec=TypeSpecifier();
@@ -1381,18 +1416,20 @@ void MemberDefImpl::init(Definition *d,
   m_userInitLines=-1;
   m_docEnumValues=FALSE;
   // copy function template arguments (if any)
-  m_tArgList = tal;
+  if (!tal.empty()) m_rare.edit().tArgList = tal;
   //printf("new member al=%p\n",al);
   // copy function definition arguments (if any)
   m_defArgList = al;
   // convert function declaration arguments (if any)
   if (!m_args.isEmpty())
   {
-    m_declArgList = *stringToArgumentList(d->getLanguage(),m_args,&m_extraTypeChars);
+    QCString extraTypeChars;
+    m_declArgList = *stringToArgumentList(d->getLanguage(),m_args,&extraTypeChars);
+    if (!extraTypeChars.isEmpty()) m_rare.edit().extraTypeChars = extraTypeChars;
     //printf("setDeclArgList %s to %s const=%d\n",qPrint(args),
     //    qPrint(argListToString(declArgList)),declArgList->constSpecifier);
   }
-  m_metaData = meta;
+  if (!meta.isEmpty()) m_rare.edit().metaData = meta;
   m_templateMaster = nullptr;
   m_docsForDefinition = TRUE;
   m_isTypedefValCached = FALSE;
@@ -1441,6 +1478,7 @@ MemberDefImpl::MemberDefImpl(const QCString &df,int dl,int dc,
 {
   //printf("MemberDefImpl::MemberDef(%s)\n",qPrint(na));
   init(this,t,a,e,p,v,s,r,mt,tal,al,meta);
+  g_numMemberDefs++;
   m_isLinkableCached    = 0;
   m_isConstructorCached = 0;
   m_isDestructorCached  = 0;
@@ -1449,12 +1487,12 @@ MemberDefImpl::MemberDefImpl(const QCString &df,int dl,int dc,
 std::unique_ptr<MemberDef> MemberDefImpl::deepCopy() const
 {
   std::unique_ptr<MemberDefImpl> result(new MemberDefImpl(
-        getDefFileName(),getDefLine(),getDefColumn(),m_type,localName(),m_args,m_exception,
-        m_prot,m_virt,m_stat,m_related,m_mtype,m_tArgList,m_defArgList,m_metaData));
+        getDefFileName(),getDefLine(),getDefColumn(),m_type,localName(),m_args,m_rare.get().exception,
+        m_prot,m_virt,m_stat,m_related,m_mtype,m_rare.get().tArgList,m_defArgList,m_rare.get().metaData));
   // first copy base members
   result->DefinitionMixin<MemberDefMutable>::operator=(*this);
   // then copy other members
-  result->m_typeConstraints                = m_typeConstraints                ;
+  result->m_rare                           = m_rare                           ;
   result->m_declArgList                    = m_declArgList                    ;
   result->m_classDef                       = m_classDef                       ;
   result->m_fileDef                        = m_fileDef                        ;
@@ -1463,26 +1501,13 @@ std::unique_ptr<MemberDef> MemberDefImpl::deepCopy() const
   result->m_enumScope                      = m_enumScope                      ;
   result->m_livesInsideEnum                = m_livesInsideEnum                ;
   result->m_annEnumType                    = m_annEnumType                    ;
-  result->m_enumFields                     = m_enumFields                     ;
   result->m_redefines                      = m_redefines                      ;
   result->m_redefinedBy                    = m_redefinedBy                    ;
   result->m_memDef                         = m_memDef                         ;
   result->m_memDec                         = m_memDec                         ;
-  result->m_relatedAlso                    = m_relatedAlso                    ;
-  result->m_examples                       = m_examples                       ;
-  result->m_accessorType                   = m_accessorType                   ;
-  result->m_accessorClass                  = m_accessorClass                  ;
   result->m_def                            = m_def                            ;
   result->m_anc                            = m_anc                            ;
   result->m_decl                           = m_decl                           ;
-  result->m_bitfields                      = m_bitfields                      ;
-  result->m_read                           = m_read                           ;
-  result->m_write                          = m_write                          ;
-  result->m_exception                      = m_exception                      ;
-  result->m_initializer                    = m_initializer                    ;
-  result->m_extraTypeChars                 = m_extraTypeChars                 ;
-  result->m_enumBaseType                   = m_enumBaseType                   ;
-  result->m_requiresClause                 = m_requiresClause                 ;
   result->m_initLines                      = m_initLines                      ;
   result->m_memSpec                        = m_memSpec                        ;
   result->m_vhdlSpec                       = m_vhdlSpec                       ;
@@ -1491,11 +1516,7 @@ std::unique_ptr<MemberDef> MemberDefImpl::deepCopy() const
   result->m_annMemb                        = m_annMemb                        ;
   result->m_defArgList                     = m_defArgList                     ;
   result->m_declArgList                    = m_declArgList                    ;
-  result->m_tArgList                       = m_tArgList                       ;
-  result->m_typeConstraints                = m_typeConstraints                ;
   result->m_templateMaster                 = m_templateMaster                 ;
-  result->m_formalTemplateArguments        = m_formalTemplateArguments        ;
-  result->m_defTmpArgLists                 = m_defTmpArgLists                 ;
   result->m_cachedAnonymousType            = m_cachedAnonymousType            ;
   result->m_sectionMap                     = m_sectionMap                     ;
   result->m_groupAlias                     = m_groupAlias                     ;
@@ -1511,8 +1532,6 @@ std::unique_ptr<MemberDef> MemberDefImpl::deepCopy() const
   result->m_cachedTypedefTemplSpec         = m_cachedTypedefTemplSpec         ;
   result->m_cachedResolvedType             = m_cachedResolvedType             ;
   result->m_docProvider                    = m_docProvider                    ;
-  result->m_explicitOutputFileBase         = m_explicitOutputFileBase         ;
-  result->m_qualifiers                     = m_qualifiers                     ;
   result->m_implOnly                       = m_implOnly                       ;
   result->m_hasDocumentedParams            = m_hasDocumentedParams            ;
   result->m_hasDocumentedReturnType        = m_hasDocumentedReturnType        ;
@@ -1532,13 +1551,11 @@ std::unique_ptr<MemberDef> MemberDefImpl::deepCopy() const
   result->m_tspec                          = m_tspec                          ;
   result->m_groupHasDocs                   = m_groupHasDocs                   ;
   result->m_docsForDefinition              = m_docsForDefinition              ;
-  result->m_category                       = m_category                       ;
-  result->m_categoryRelation               = m_categoryRelation               ;
   result->m_declFileName                   = m_declFileName                   ;
   result->m_declLine                       = m_declLine                       ;
   result->m_declColumn                     = m_declColumn                     ;
   result->m_numberOfFlowKW                 = m_numberOfFlowKW                 ;
-  result->setDefinitionTemplateParameterLists(m_defTmpArgLists);
+  result->setDefinitionTemplateParameterLists(m_rare.get().defTmpArgLists);
 
   result->m_isLinkableCached    = 0;
   result->m_isConstructorCached = 0;
@@ -1622,18 +1639,18 @@ bool MemberDefImpl::isReimplementedBy(const ClassDef *cd) const
 
 void MemberDefImpl::insertEnumField(MemberDef *md)
 {
-  m_enumFields.push_back(md);
+  m_rare.edit().enumFields.push_back(md);
 }
 
 bool MemberDefImpl::addExample(const QCString &anchor,const QCString &nameStr, const QCString &file)
 {
   //printf("%s::addExample(%s,%s,%s)\n",qPrint(name()),anchor,nameStr,file);
-  return m_examples.inSort(Example(anchor,nameStr,file));
+  return m_rare.edit().examples.inSort(Example(anchor,nameStr,file));
 }
 
 bool MemberDefImpl::hasExamples() const
 {
-  return !m_examples.empty();
+  return !m_rare.get().examples.empty();
 }
 
 QCString MemberDefImpl::sourceRefName() const
@@ -1670,9 +1687,9 @@ QCString MemberDefImpl::getOutputFileBase() const
   const ClassDef *classDef = getClassDef();
   const ModuleDef *moduleDef = getModuleDef();
   const GroupDef *groupDef = getGroupDef();
-  if (!m_explicitOutputFileBase.isEmpty())
+  if (!m_rare.get().explicitOutputFileBase.isEmpty())
   {
-    return m_explicitOutputFileBase;
+    return m_rare.get().explicitOutputFileBase;
   }
   else if (templateMaster())
   {
@@ -1915,7 +1932,7 @@ bool MemberDefImpl::isLinkable() const
 
 void MemberDefImpl::setDefinitionTemplateParameterLists(const ArgumentLists &lists)
 {
-  m_defTmpArgLists = lists;
+  if (!lists.empty() || m_rare.isCreated()) m_rare.edit().defTmpArgLists = lists;
 }
 
 void MemberDefImpl::writeLink(OutputList &ol,
@@ -1978,6 +1995,7 @@ static std::mutex g_cachedAnonymousTypeMutex;
  */
 ClassDef *MemberDefImpl::getClassDefOfAnonymousType() const
 {
+  if (m_frozen) return m_cachedAnonymousType;
   std::lock_guard<std::mutex> lock(g_cachedAnonymousTypeMutex);
   //printf("%s:getClassDefOfAnonymousType() cache=%s\n",qPrint(name()),
   //                   m_cachedAnonymousType?qPrint(m_cachedAnonymousType->name()):"<empty>");
@@ -2025,6 +2043,26 @@ ClassDef *MemberDefImpl::getClassDefOfAnonymousType() const
   return annoClassDef;
 }
 
+void MemberDefImpl::freeze()
+{
+  DefinitionMixin::freeze();
+  if (!m_frozen)
+  {
+    getClassDefOfAnonymousType();
+    m_frozen = true;
+  }
+}
+
+void MemberDefImpl::freezeReferences()
+{
+  DefinitionMixin::freezeReferences();
+  if (!m_referencesFrozen)
+  {
+    hasDetailedDescription();
+    m_referencesFrozen = true;
+  }
+}
+
 /*! This methods returns TRUE iff the brief section (also known as
  *  declaration section) is visible in the documentation.
  */
@@ -2189,7 +2227,7 @@ void MemberDefImpl::_writeTemplatePrefix(OutputList &ol, const Definition *def,
     if (it!=al.end()) ol.docify(", ");
   }
   ol.docify("> ");
-  if (writeReqClause && !m_requiresClause.isEmpty())
+  if (writeReqClause && !m_rare.get().requiresClause.isEmpty())
   {
     ol.lineBreak();
     ol.docify("requires ");
@@ -2197,7 +2235,7 @@ void MemberDefImpl::_writeTemplatePrefix(OutputList &ol, const Definition *def,
         def,                     // scope
         getFileDef(),            // fileScope
         this,                    // self
-        m_requiresClause,  // text
+        m_rare.get().requiresClause,  // text
         FALSE                    // autoBreak
         );
   }
@@ -2214,7 +2252,7 @@ static QCString combineArgsAndException(QCString args,QCString exception)
 
 bool MemberDefImpl::_isAnonymousBitField() const
 {
-  return !m_bitfields.isEmpty() && name().startsWith("__pad"); // anonymous bitfield
+  return !m_rare.get().bitfields.isEmpty() && name().startsWith("__pad"); // anonymous bitfield
 }
 
 void MemberDefImpl::writeDeclaration(OutputList &ol,
@@ -2261,7 +2299,7 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
   // start a new member declaration
   bool isAnonType = annoClassDef || m_annMemb || m_annEnumType;
   OutputGenerator::MemberItemType anonType = isAnonType ? OutputGenerator::MemberItemType::AnonymousStart :
-                              !m_tArgList.empty() ? OutputGenerator::MemberItemType::Templated      :
+                              !m_rare.get().tArgList.empty() ? OutputGenerator::MemberItemType::Templated      :
                                                           OutputGenerator::MemberItemType::Normal;
   ol.startMemberItem(annoClassDef ? QCString() : anchor(), anonType, inheritId);
 
@@ -2303,10 +2341,10 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
   }
 
   // *** write template lists
-  if (m_tArgList.hasParameters() && getLanguage()==SrcLangExt::Cpp)
+  if (m_rare.get().tArgList.hasParameters() && getLanguage()==SrcLangExt::Cpp)
   {
     if (!isAnonType) ol.startMemberTemplateParams();
-    _writeTemplatePrefix(ol,d,m_tArgList);
+    _writeTemplatePrefix(ol,d,m_rare.get().tArgList);
     if (!isAnonType) ol.endMemberTemplateParams(anchor(),inheritId);
   }
 
@@ -2429,7 +2467,7 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
   }
   else
   {
-    ol.insertMemberAlign(m_tArgList.hasParameters());
+    ol.insertMemberAlign(m_rare.get().tArgList.hasParameters());
   }
 
   // *** write name
@@ -2506,9 +2544,9 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
   }
 
   // *** write bitfields
-  if (!m_bitfields.isEmpty()) // add bitfields
+  if (!m_rare.get().bitfields.isEmpty()) // add bitfields
   {
-    linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_bitfields);
+    linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_rare.get().bitfields);
   }
   else if (hasOneLineInitializer()
       //!init.isEmpty() && initLines==0 && // one line initializer
@@ -2518,18 +2556,18 @@ void MemberDefImpl::writeDeclaration(OutputList &ol,
     if (isTypeAlias()) // using statement
     {
       ol.writeString(" = ");
-      linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_initializer.simplifyWhiteSpace());
+      linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_rare.get().initializer.simplifyWhiteSpace());
     }
     else if (!isDefine())
     {
       //ol.writeString(" = ");
       ol.writeString(" ");
-      linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_initializer.simplifyWhiteSpace());
+      linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_rare.get().initializer.simplifyWhiteSpace());
     }
     else
     {
       ol.writeNonBreakableSpace(3);
-      linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_initializer);
+      linkifyText(TextGeneratorOLImpl(ol),d,getBodyDef(),this,m_rare.get().initializer);
     }
   }
 
@@ -2668,6 +2706,7 @@ static std::mutex g_hasDetailedDescriptionMutex;
 
 bool MemberDefImpl::hasDetailedDescription() const
 {
+  if (m_referencesFrozen) return m_detailedDescriptionCachedValue;
   std::lock_guard<std::mutex> lock(g_hasDetailedDescriptionMutex);
   //printf(">hasDetailedDescription(cached=%d)\n",m_hasDetailedDescriptionCached);
   if (!m_hasDetailedDescriptionCached)
@@ -2707,9 +2746,9 @@ bool MemberDefImpl::hasDetailedDescription() const
             m_defArgList.hasDocumentation()) ||
            (m_templateMaster ?
             m_templateMaster->templateArguments().hasTemplateDocumentation() :
-            m_tArgList.hasTemplateDocumentation()) ||
+            m_rare.get().tArgList.hasTemplateDocumentation()) ||
            // user-specified qualifiers
-           !m_qualifiers.empty();
+           !m_rare.get().qualifiers.empty();
 
     // generate function                  guard
     // ==================                 =======
@@ -2718,7 +2757,7 @@ bool MemberDefImpl::hasDetailedDescription() const
     // _writeReimplements              -> _isReimplements()
     // _writeReimplementedBy           -> _countReimplementedBy()>0
     // _writeExamples                  -> hasExamples()
-    // _writeTypeConstraints           -> m_typeConstraints.hasParameters()
+    // _writeTypeConstraints           -> m_rare.get().typeConstraints.hasParameters()
     // writeSourceDef                  -> !getSourceFileBase().isEmpty();
     // writeInlineCode                 -> hasInlineSource() && hasSources()
     // writeSourceRefs                 -> hasReferencesRelation() && hasSourceRefs()
@@ -2735,7 +2774,7 @@ bool MemberDefImpl::hasDetailedDescription() const
            // examples
            hasExamples() ||
            // type constraints
-           m_typeConstraints.hasParameters() ||
+           m_rare.get().typeConstraints.hasParameters() ||
            // has source definition
            !getSourceFileBase().isEmpty() ||
            // has inline sources
@@ -2923,7 +2962,7 @@ StringVector MemberDefImpl::getLabels(const Definition *container) const
     sl.emplace_back("implementation");
   }
 
-  for (const auto &sx : m_qualifiers)
+  for (const auto &sx : m_rare.get().qualifiers)
   {
     bool alreadyAdded = std::find(sl.begin(), sl.end(), sx) != sl.end();
     if (!alreadyAdded)
@@ -3135,8 +3174,8 @@ void MemberDefImpl::_writeCategoryRelation(OutputList &ol) const
   {
     //printf("%s: category %s relation %s class=%s categoryOf=%s\n",
     //    qPrint(name()),
-    //    m_category ? qPrint(m_category->name()) : "<none>",
-    //    m_categoryRelation ? qPrint(m_categoryRelation->name()) : "<none>",
+    //    m_rare.get().category ? qPrint(m_rare.get().category->name()) : "<none>",
+    //    m_rare.get().categoryRelation ? qPrint(m_rare.get().categoryRelation->name()) : "<none>",
     //    qPrint(m_classDef->name()),
     //    m_classDef->categoryOf() ? qPrint(m_classDef->categoryOf()->name()) : "<none>"
     //    );
@@ -3146,14 +3185,14 @@ void MemberDefImpl::_writeCategoryRelation(OutputList &ol) const
     QCString anc;
     QCString name;
     int i=-1;
-    if (m_categoryRelation && m_categoryRelation->isLinkable())
+    if (m_rare.get().categoryRelation && m_rare.get().categoryRelation->isLinkable())
     {
-      if (m_category)
+      if (m_rare.get().category)
       {
         // this member is in a normal class and implements method categoryRelation from category
         // so link to method 'categoryRelation' with 'provided by category 'category' text.
         text = theTranslator->trProvidedByCategory();
-        name = m_category->displayName();
+        name = m_rare.get().category->displayName();
       }
       else if (getClassDef()->categoryOf())
       {
@@ -3165,7 +3204,7 @@ void MemberDefImpl::_writeCategoryRelation(OutputList &ol) const
       i=text.find("@0");
       if (i!=-1)
       {
-        const MemberDef *md = m_categoryRelation;
+        const MemberDef *md = m_rare.get().categoryRelation;
         ref  = md->getReference();
         file = md->getOutputFileBase();
         anc  = md->anchor();
@@ -3189,7 +3228,7 @@ void MemberDefImpl::_writeExamples(OutputList &ol) const
   {
     ol.startExamples();
     ol.startDescForItem();
-    writeExamples(ol,m_examples);
+    writeExamples(ol,m_rare.get().examples);
     ol.endDescForItem();
     ol.endExamples();
   }
@@ -3197,9 +3236,9 @@ void MemberDefImpl::_writeExamples(OutputList &ol) const
 
 void MemberDefImpl::_writeTypeConstraints(OutputList &ol) const
 {
-  if (m_typeConstraints.hasParameters())
+  if (m_rare.get().typeConstraints.hasParameters())
   {
-    writeTypeConstraints(ol,this,m_typeConstraints);
+    writeTypeConstraints(ol,this,m_rare.get().typeConstraints);
   }
 }
 
@@ -3316,9 +3355,9 @@ QCString MemberDefImpl::displayDefinition() const
     if (isAnonymous())
     {
       ldef = title = "anonymous enum";
-      if (!m_enumBaseType.isEmpty())
+      if (!m_rare.get().enumBaseType.isEmpty())
       {
-        ldef+=" : "+m_enumBaseType;
+        ldef+=" : "+m_rare.get().enumBaseType;
       }
     }
     else
@@ -3454,7 +3493,7 @@ void MemberDefImpl::_writeMultiLineInitializer(OutputList &ol,const QCString &sc
     intf->resetCodeParserState();
     auto &codeOL = ol.codeGenerators();
     codeOL.startCodeFragment("DoxyCode");
-    intf->parseCode(codeOL,scopeName,m_initializer,srcLangExt,Config_getBool(STRIP_CODE_COMMENTS),
+    intf->parseCode(codeOL,scopeName,m_rare.get().initializer,srcLangExt,Config_getBool(STRIP_CODE_COMMENTS),
                     CodeParserOptions()
                     .setFileDef(getFileDef())
                     .setInlineFragment(true)
@@ -3529,9 +3568,9 @@ void MemberDefImpl::writeDocumentation(const MemberList *ml,
     if (title.at(0)=='@')
     {
       ldef = title = "anonymous enum";
-      if (!m_enumBaseType.isEmpty())
+      if (!m_rare.get().enumBaseType.isEmpty())
       {
-        ldef+=" : "+m_enumBaseType;
+        ldef+=" : "+m_rare.get().enumBaseType;
       }
     }
     else
@@ -3636,19 +3675,19 @@ void MemberDefImpl::writeDocumentation(const MemberList *ml,
     ol.startMemberDoc(ciname,name(),memAnchor,title,memCount,memTotal,showInline);
     ol.addLabel(cfname, memAnchor);
 
-    if (!m_metaData.isEmpty() && getLanguage()==SrcLangExt::Slice)
+    if (!m_rare.get().metaData.isEmpty() && getLanguage()==SrcLangExt::Slice)
     {
       ol.startMemberDocPrefixItem();
-      ol.docify(m_metaData);
+      ol.docify(m_rare.get().metaData);
       ol.endMemberDocPrefixItem();
     }
 
     const ClassDef *cd=getClassDef();
     const NamespaceDef *nd=getNamespaceDef();
-    if (!m_defTmpArgLists.empty() && lang==SrcLangExt::Cpp)
+    if (!m_rare.get().defTmpArgLists.empty() && lang==SrcLangExt::Cpp)
       // definition has explicit template parameter declarations
     {
-      for (const ArgumentList &tal : m_defTmpArgLists)
+      for (const ArgumentList &tal : m_rare.get().defTmpArgLists)
       {
         if (!tal.empty())
         {
@@ -3673,10 +3712,10 @@ void MemberDefImpl::writeDocumentation(const MemberList *ml,
           }
         }
       }
-      if (m_tArgList.hasParameters() && lang==SrcLangExt::Cpp) // function template prefix
+      if (m_rare.get().tArgList.hasParameters() && lang==SrcLangExt::Cpp) // function template prefix
       {
         ol.startMemberDocPrefixItem();
-        _writeTemplatePrefix(ol,scopedContainer,m_tArgList);
+        _writeTemplatePrefix(ol,scopedContainer,m_rare.get().tArgList);
         ol.endMemberDocPrefixItem();
       }
     }
@@ -3769,19 +3808,19 @@ void MemberDefImpl::writeDocumentation(const MemberList *ml,
       if (isTypeAlias())
       {
         ol.docify(" = ");
-        QCString init = m_initializer.simplifyWhiteSpace();
+        QCString init = m_rare.get().initializer.simplifyWhiteSpace();
         linkifyText(TextGeneratorOLImpl(ol),scopedContainer,getBodyDef(),this,init);
       }
       else if (!isDefine())
       {
         ol.docify(" ");
-        QCString init = m_initializer.simplifyWhiteSpace();
+        QCString init = m_rare.get().initializer.simplifyWhiteSpace();
         linkifyText(TextGeneratorOLImpl(ol),scopedContainer,getBodyDef(),this,init);
       }
       else
       {
         ol.writeNonBreakableSpace(3);
-        linkifyText(TextGeneratorOLImpl(ol),scopedContainer,getBodyDef(),this,m_initializer);
+        linkifyText(TextGeneratorOLImpl(ol),scopedContainer,getBodyDef(),this,m_rare.get().initializer);
       }
     }
     if (!excpString().isEmpty()) // add exception list
@@ -3932,7 +3971,7 @@ void MemberDefImpl::writeDocumentation(const MemberList *ml,
 
   const ArgumentList &docTemplateArgList = m_templateMaster ?
                                    m_templateMaster->templateArguments() :
-                                   m_tArgList;
+                                   m_rare.get().tArgList;
   ol.generateDoc(docFile(),
                  docLine(),
                  scopedContainer,
@@ -3984,7 +4023,7 @@ static QCString simplifyTypeForTable(const QCString &s)
 
 QCString MemberDefImpl::fieldType() const
 {
-  QCString type = m_accessorType;
+  QCString type = m_rare.get().accessorType;
   if (type.isEmpty())
   {
     type = m_type;
@@ -4008,7 +4047,7 @@ void MemberDefImpl::writeMemberDocSimple(OutputList &ol, const Definition *conta
     doxyName="__unnamed__";
   }
 
-  ClassDef *cd = m_accessorClass;
+  ClassDef *cd = m_rare.get().accessorClass;
   //printf("===> %s::anonymous: %s\n",qPrint(name()),cd?qPrint(cd->name()):"<none>");
 
   if (container && container->definitionType()==Definition::TypeClass &&
@@ -4062,14 +4101,14 @@ void MemberDefImpl::writeMemberDocSimple(OutputList &ol, const Definition *conta
   {
     linkifyText(TextGeneratorOLImpl(ol),getOuterScope(),getBodyDef(),this,argsString());
   }
-  if (!m_bitfields.isEmpty()) // add bitfields
+  if (!m_rare.get().bitfields.isEmpty()) // add bitfields
   {
-    linkifyText(TextGeneratorOLImpl(ol),getOuterScope(),getBodyDef(),this,m_bitfields);
+    linkifyText(TextGeneratorOLImpl(ol),getOuterScope(),getBodyDef(),this,m_rare.get().bitfields);
   }
   if (hasOneLineInitializer() && !isDefine())
   {
     ol.writeString(" ");
-    linkifyText(TextGeneratorOLImpl(ol),getOuterScope(),getBodyDef(),this,m_initializer.simplifyWhiteSpace());
+    linkifyText(TextGeneratorOLImpl(ol),getOuterScope(),getBodyDef(),this,m_rare.get().initializer.simplifyWhiteSpace());
   }
   ol.endInlineMemberName();
 
@@ -4371,7 +4410,7 @@ bool MemberDefImpl::hasDocumentation() const
 {
   return DefinitionMixin::hasDocumentation() ||
          (m_mtype==MemberType::Enumeration && m_docEnumValues) ||  // has enum values
-         (m_defArgList.hasDocumentation()|| m_tArgList.hasTemplateDocumentation());   // has doc (template) arguments
+         (m_defArgList.hasDocumentation()|| m_rare.get().tArgList.hasTemplateDocumentation());   // has doc (template) arguments
 }
 
 
@@ -4395,7 +4434,7 @@ void MemberDefImpl::setAnchor()
   if (!m_args.isEmpty()) memAnchor+=m_args;
   if (m_memSpec.isAlias()) // this is for backward compatibility
   {
-    memAnchor.prepend(" = "+m_initializer);
+    memAnchor.prepend(" = "+m_rare.get().initializer);
   }
   memAnchor.prepend(definition()); // actually the method name is now included
             // twice, which is silly, but we keep it this way for backward
@@ -4405,16 +4444,16 @@ void MemberDefImpl::setAnchor()
   // include number of template arguments as well,
   // to distinguish between two template
   // specializations that only differ in the template parameters.
-  if (m_tArgList.hasParameters())
+  if (m_rare.get().tArgList.hasParameters())
   {
     char buf[20];
-    qsnprintf(buf,20,"%d:",static_cast<int>(m_tArgList.size()));
+    qsnprintf(buf,20,"%d:",static_cast<int>(m_rare.get().tArgList.size()));
     buf[19]='\0';
     memAnchor.prepend(buf);
   }
-  if (!m_requiresClause.isEmpty())
+  if (!m_rare.get().requiresClause.isEmpty())
   {
-    memAnchor+=" "+m_requiresClause;
+    memAnchor+=" "+m_rare.get().requiresClause;
   }
   if (m_redefineCount>0)
   {
@@ -4502,7 +4541,7 @@ std::unique_ptr<MemberDef> MemberDefImpl::createTemplateInstanceMember(
                        substituteTemplateArgumentsInString(m_type,formalArgs,actualArgs.get()),
                        methodName,
                        substituteTemplateArgumentsInString(m_args,formalArgs,actualArgs.get()),
-                       m_exception, m_prot,
+                       m_rare.get().exception, m_prot,
                        m_virt, m_stat, m_related, m_mtype,
                        ArgumentList(), ArgumentList(), ""
                    );
@@ -4521,10 +4560,10 @@ std::unique_ptr<MemberDef> MemberDefImpl::createTemplateInstanceMember(
 bool MemberDefImpl::hasOneLineInitializer() const
 {
   //printf("%s: init=%s, initLines=%d maxInitLines=%d userInitLines=%d\n",
-  //    qPrint(name()),qPrint(m_initializer),m_initLines,
+  //    qPrint(name()),qPrint(m_rare.get().initializer),m_initLines,
   //    m_maxInitLines,m_userInitLines);
   bool isFuncLikeMacro = m_mtype==MemberType::Define && m_defArgList.hasParameters();
-  return !m_initializer.isEmpty() && m_initLines==0 && // one line initializer
+  return !m_rare.get().initializer.isEmpty() && m_initLines==0 && // one line initializer
          !isFuncLikeMacro &&
          ((m_maxInitLines>0 && m_userInitLines==-1) || m_userInitLines>0); // enabled by default or explicitly
 }
@@ -4534,7 +4573,7 @@ bool MemberDefImpl::hasMultiLineInitializer() const
   //printf("initLines=%d userInitLines=%d maxInitLines=%d\n",
   //    initLines,userInitLines,maxInitLines);
   bool isFuncLikeMacro = m_mtype==MemberType::Define && m_defArgList.hasParameters();
-  return (m_initLines>0 || (!m_initializer.isEmpty() && isFuncLikeMacro)) &&
+  return (m_initLines>0 || (!m_rare.get().initializer.isEmpty() && isFuncLikeMacro)) &&
          ((m_initLines<m_maxInitLines && m_userInitLines==-1) // implicitly enabled
           || m_initLines<m_userInitLines // explicitly enabled
          );
@@ -4543,13 +4582,13 @@ bool MemberDefImpl::hasMultiLineInitializer() const
 void MemberDefImpl::setInitializer(const QCString &initializer)
 {
   size_t indent=0;
-  m_initializer=detab(initializer,indent);
-  int l=static_cast<int>(m_initializer.length());
+  QCString init=detab(initializer,indent);
+  int l=static_cast<int>(init.length());
   int p=l-1;
-  while (p>=0 && isspace(static_cast<uint8_t>(m_initializer.at(p)))) p--;
-  m_initializer=m_initializer.left(p+1);
-  m_initLines=m_initializer.contains('\n');
-  //printf("%s::setInitializer(%s)\n",qPrint(name()),qPrint(m_initializer));
+  while (p>=0 && isspace(static_cast<uint8_t>(init.at(p)))) p--;
+  setRareString(&RareData::initializer,init.left(p+1));
+  m_initLines=m_rare.get().initializer.contains('\n');
+  //printf("%s::setInitializer(%s)\n",qPrint(name()),qPrint(m_rare.get().initializer));
 }
 
 void MemberDefImpl::addListReference(Definition *)
@@ -4688,7 +4727,7 @@ void MemberDefImpl::writeTagFile(TextStream &tagFile,bool useQualifiedName,bool
   tagFile << "      <arglist>" << convertToXML(argsString()) << "</arglist>\n";
   if (isStrong())
   {
-    for (const auto &fmd : m_enumFields)
+    for (const auto &fmd : m_rare.get().enumFields)
     {
       if (!fmd->isReference())
       {
@@ -4803,7 +4842,7 @@ void MemberDefImpl::writeEnumDeclaration(OutputList &typeDecl,
   int enumMemCount=0;
 
   uint32_t numVisibleEnumValues=0;
-  for (const auto &fmd : m_enumFields)
+  for (const auto &fmd : m_rare.get().enumFields)
   {
     if (fmd->isBriefSectionVisible()) numVisibleEnumValues++;
   }
@@ -4830,11 +4869,11 @@ void MemberDefImpl::writeEnumDeclaration(OutputList &typeDecl,
     }
     typeDecl.writeChar(' ');
   }
-  if (!m_enumBaseType.isEmpty())
+  if (!m_rare.get().enumBaseType.isEmpty())
   {
     typeDecl.writeChar(':');
     typeDecl.writeChar(' ');
-    typeDecl.docify(m_enumBaseType);
+    typeDecl.docify(m_rare.get().enumBaseType);
     typeDecl.writeChar(' ');
   }
 
@@ -4843,8 +4882,8 @@ void MemberDefImpl::writeEnumDeclaration(OutputList &typeDecl,
   {
     typeDecl.docify("{ ");
 
-    auto it = m_enumFields.begin();
-    if (it!=m_enumFields.end())
+    auto it = m_rare.get().enumFields.begin();
+    if (it!=m_rare.get().enumFields.end())
     {
       const MemberDef *fmd=*it;
       bool fmdVisible = fmd->isBriefSectionVisible();
@@ -4894,7 +4933,7 @@ void MemberDefImpl::writeEnumDeclaration(OutputList &typeDecl,
 
         bool prevVisible = fmdVisible;
         ++it;
-        if (it!=m_enumFields.end())
+        if (it!=m_rare.get().enumFields.end())
         {
           fmd=*it;
         }
@@ -4934,7 +4973,7 @@ void MemberDefImpl::moveDeclArgumentList(std::unique_ptr<ArgumentList> al)
 
 void MemberDefImpl::setTypeConstraints(const ArgumentList &al)
 {
-  m_typeConstraints = al;
+  if (!al.empty() || m_rare.isCreated()) m_rare.edit().typeConstraints = al;
 }
 
 void MemberDefImpl::setType(const QCString &t)
@@ -4944,13 +4983,17 @@ void MemberDefImpl::setType(const QCString &t)
 
 void MemberDefImpl::setAccessorType(ClassDef *cd,const QCString &t)
 {
-  m_accessorClass = cd;
-  m_accessorType = t;
+  if (cd || !t.isEmpty() || m_rare.isCreated())
+  {
+    RareData &rare = m_rare.edit();
+    rare.accessorClass = cd;
+    rare.accessorType = t;
+  }
 }
 
 ClassDef *MemberDefImpl::accessorClass() const
 {
-  return m_accessorClass;
+  return m_rare.get().accessorClass;
 }
 
 void MemberDefImpl::findSectionsInDocumentation()
@@ -5043,7 +5086,7 @@ void MemberDefImpl::setTagInfo(const TagInfo *ti)
     //printf("%s: Setting tag name=%s anchor=%s\n",qPrint(name()),qPrint(ti->tagName),qPrint(ti->anchor));
     m_anc=ti->anchor;
     setReference(ti->tagName);
-    m_explicitOutputFileBase = stripExtension(ti->fileName);
+    setRareString(&RareData::explicitOutputFileBase,stripExtension(ti->fileName));
   }
 }
 
@@ -5076,7 +5119,7 @@ QCString MemberDefImpl::definition() const
 
 QCString MemberDefImpl::extraTypeChars() const
 {
-  return m_extraTypeChars;
+  return m_rare.get().extraTypeChars;
 }
 
 QCString MemberDefImpl::typeString() const
@@ -5091,17 +5134,17 @@ QCString MemberDefImpl::argsString() const
 
 QCString MemberDefImpl::excpString() const
 {
-  return m_exception;
+  return m_rare.get().exception;
 }
 
 QCString MemberDefImpl::bitfieldString() const
 {
-  return m_bitfields;
+  return m_rare.get().bitfields;
 }
 
 const QCString &MemberDefImpl::initializer() const
 {
-  return m_initializer;
+  return m_rare.get().initializer;
 }
 
 int MemberDefImpl::initializerLines() const
@@ -5156,12 +5199,12 @@ NamespaceDef* MemberDefImpl::getNamespaceDef()
 
 QCString MemberDefImpl::getReadAccessor() const
 {
-  return m_read;
+  return m_rare.get().read;
 }
 
 QCString MemberDefImpl::getWriteAccessor() const
 {
-  return m_write;
+  return m_rare.get().write;
 }
 
 const GroupDef *MemberDefImpl::getGroupDef() const
@@ -5560,7 +5603,7 @@ bool MemberDefImpl::isCallable() const
 
 ClassDef *MemberDefImpl::relatedAlso() const
 {
-  return m_relatedAlso;
+  return m_rare.get().relatedAlso;
 }
 
 bool MemberDefImpl::hasDocumentedEnumValues() const
@@ -5615,12 +5658,12 @@ bool MemberDefImpl::isConstInit() const
 
 const MemberVector &MemberDefImpl::enumFieldList() const
 {
-  return m_enumFields;
+  return m_rare.get().enumFields;
 }
 
 const ExampleList &MemberDefImpl::getExamples() const
 {
-  return m_examples;
+  return m_rare.get().examples;
 }
 
 bool MemberDefImpl::isPrototype() const
@@ -5688,12 +5731,12 @@ void MemberDefImpl::resolveUnnamedParameters(const MemberDef *md)
 
 const ArgumentList &MemberDefImpl::templateArguments() const
 {
-  return m_tArgList;
+  return m_rare.get().tArgList;
 }
 
 const ArgumentLists &MemberDefImpl::definitionTemplateParameterLists() const
 {
-  return m_defTmpArgLists;
+  return m_rare.get().defTmpArgLists;
 }
 
 int MemberDefImpl::getMemberGroupId() const
@@ -5774,7 +5817,7 @@ const MemberDef *MemberDefImpl::templateMaster() const
 
 std::optional<ArgumentList> MemberDefImpl::formalTemplateArguments() const
 {
-  return m_formalTemplateArguments;
+  return m_rare.get().formalTemplateArguments;
 }
 
 bool MemberDefImpl::isTypedefValCached() const
@@ -5883,24 +5926,25 @@ void MemberDefImpl::mergeMemberSpecifiers(TypeSpecifier s)
 
 StringVector MemberDefImpl::getQualifiers() const
 {
-  return m_qualifiers;
+  return m_rare.get().qualifiers;
 }
 
 void MemberDefImpl::addQualifiers(const StringVector &qualifiers)
 {
   for (const auto &sx : qualifiers)
   {
-    bool alreadyAdded = std::find(m_qualifiers.begin(), m_qualifiers.end(), sx) != m_qualifiers.end();
+    const StringVector &current = m_rare.get().qualifiers;
+    bool alreadyAdded = std::find(current.begin(), current.end(), sx) != current.end();
     if (!alreadyAdded)
     {
-      m_qualifiers.push_back(sx);
+      m_rare.edit().qualifiers.push_back(sx);
     }
   }
 }
 
 void MemberDefImpl::setBitfields(const QCString &s)
 {
-  m_bitfields = QCString(s).simplifyWhiteSpace();
+  setRareString(&RareData::bitfields,QCString(s).simplifyWhiteSpace());
 }
 
 void MemberDefImpl::setMaxInitLines(int lines)
@@ -5913,12 +5957,12 @@ void MemberDefImpl::setMaxInitLines(int lines)
 
 void MemberDefImpl::setReadAccessor(const QCString &r)
 {
-  m_read=r;
+  setRareString(&RareData::read,r);
 }
 
 void MemberDefImpl::setWriteAccessor(const QCString &w)
 {
-  m_write=w;
+  setRareString(&RareData::write,w);
 }
 
 void MemberDefImpl::setTemplateSpecialization(bool b)
@@ -5950,7 +5994,7 @@ void MemberDefImpl::setArgsString(const QCString &as)
 
 void MemberDefImpl::setRelatedAlso(ClassDef *cd)
 {
-  m_relatedAlso=cd;
+  if (cd || m_rare.isCreated()) m_rare.edit().relatedAlso=cd;
 }
 
 void MemberDefImpl::setEnumClassScope(ClassDef *cd)
@@ -6036,7 +6080,7 @@ void MemberDefImpl::setTemplateMaster(const MemberDef *mt)
 
 void MemberDefImpl::setFormalTemplateArguments(const ArgumentList &al)
 {
-  m_formalTemplateArguments = al;
+  m_rare.edit().formalTemplateArguments = al;
 }
 
 void MemberDefImpl::setDocsForDefinition(bool b)
@@ -6066,42 +6110,42 @@ void MemberDefImpl::setMemberDeclaration(MemberDef *md)
 
 ClassDef *MemberDefImpl::category() const
 {
-  return m_category;
+  return m_rare.get().category;
 }
 
 void MemberDefImpl::setCategory(ClassDef *def)
 {
-  m_category = def;
+  if (def || m_rare.isCreated()) m_rare.edit().category = def;
 }
 
 const MemberDef *MemberDefImpl::categoryRelation() const
 {
-  return m_categoryRelation;
+  return m_rare.get().categoryRelation;
 }
 
 void MemberDefImpl::setCategoryRelation(const MemberDef *md)
 {
-  m_categoryRelation = md;
+  if (md || m_rare.isCreated()) m_rare.edit().categoryRelation = md;
 }
 
 void MemberDefImpl::setEnumBaseType(const QCString &type)
 {
-  m_enumBaseType = type;
+  setRareString(&RareData::enumBaseType,type);
 }
 
 QCString MemberDefImpl::enumBaseType() const
 {
-  return m_enumBaseType;
+  return m_rare.get().enumBaseType;
 }
 
 void MemberDefImpl::setRequiresClause(const QCString &req)
 {
-  m_requiresClause = req;
+  setRareString(&RareData::requiresClause,req);
 }
 
 QCString MemberDefImpl::requiresClause() const
 {
-  return m_requiresClause;
+  return m_rare.get().requiresClause;
 }
 
 void MemberDefImpl::cacheTypedefVal(const ClassDef*val, const QCString & templSpec, const QCString &resolvedType)
@@ -6375,7 +6419,7 @@ bool MemberDefImpl::hasUserDocumentation() const
 
 const ArgumentList &MemberDefImpl::typeConstraints() const
 {
-  return m_typeConstraints;
+  return m_rare.get().typeConstraints;
 }
 
 bool MemberDefImpl::isFriendToHide() const
@@ -38,6 +38,7 @@ class ExampleList;
 class OutputList;
 class GroupDef;
 struct TagInfo;
+struct LazyDataStats;
 class MemberDefMutable;
 class MemberGroupList;
 class MemberVector;
@@ -461,4 +462,7 @@ std::unique_ptr<MemberDef> createMemberDefAlias(const Definition *newScope,const
 void combineDeclarationAndDefinition(MemberDefMutable *mdec,MemberDefMutable *mdef);
 void addDocCrossReference(const MemberDef *src,const MemberDef *dst);
 
+/** Returns the memory used by the member definitions that are alive, for the build statistics */
+LazyDataStats memberDefLazyDataStats();
+
 #endif
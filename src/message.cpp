@@ -13,11 +13,16 @@
  *
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <atomic>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "config.h"
 #include "debug.h"
@@ -27,6 +32,7 @@
 #include "fileinfo.h"
 #include "dir.h"
 #include "md5.h"
+#include "profiler.h"
 
 // globals
 static QCString        g_warnFormat;
@@ -38,19 +44,296 @@ static WARN_AS_ERROR_t g_warnBehavior = WARN_AS_ERROR_t::NO;
 static QCString        g_warnlogFile;
 static bool            g_warnlogTemp = false;
 static std::atomic_bool g_warnStat = false;
-static std::mutex      g_mutex;
+static ProfiledMutex   g_mutex("message"); // guards writing the messages and g_warnHash
 static std::unordered_set<std::string> g_warnHash;
 
 //-----------------------------------------------------------------------------------------
 
-static bool checkWarnMessage(QCString result)
+namespace
+{
+
+std::string messageSignature(const std::string &text)
 {
   uint8_t md5_sig[16];
   char sigStr[33];
-  MD5Buffer(result.data(),result.length(),md5_sig);
+  MD5Buffer(text.data(),static_cast<unsigned int>(text.length()),md5_sig);
   MD5SigToString(md5_sig,sigStr);
+  return sigStr;
+}
+
+/** A formatted message waiting to be written */
+struct Message
+{
+  uint64_t    seq;        // order in which the messages were issued
+  bool        toWarnFile; // write to g_warnFile instead of stdout
+  std::string text;
+  bool        unique;     // only write the message if it was not written before
+  std::string uniqueText; // text used to detect that the message was written before, if different from text
+  QCString    file;       // location used to sort the warnings, see WARN_SORTED
+  int         line;
+  FILE       *out = nullptr; // write to this file instead, used for the debug output
+};
+
+/** @brief Writes the messages of all threads.
+ *
+ *  When running with multiple threads, each thread adds its messages to a queue
+ *  of its own, which is drained by a dedicated logger thread, so a thread issuing
+ *  a message only formats it and does not wait for other threads or for the output.
+ *  The messages are written in the order in which they were issued, also
+ *  across the batches written by the logger thread.
+ *  When the warnings should be sorted, they are kept until flushSorted() is called.
+ *
+ *  Without a logger thread, messages are written directly.
+ */
+class MessageSink
+{
+  public:
+    static MessageSink &instance()
+    {
+      static MessageSink theInstance;
+      return theInstance;
+    }
+
+    void start(bool threaded,bool sortWarnings)
+    {
+      std::lock_guard<ProfiledMutex> lock(g_mutex);
+      m_sortWarnings = sortWarnings;
+      if (threaded && !m_thread.joinable())
+      {
+        m_stop = false;
+        m_thread = std::thread([this]() { run(); });
+        m_threaded = true;
+      }
+    }
+
+    /** Writes the pending messages and ends the logger thread */
+    void stop()
+    {
+      std::lock_guard<std::mutex> stopLock(m_stopMutex);
+      if (m_thread.joinable())
+      {
+        {
+          std::lock_guard<std::mutex> lock(m_wakeMutex);
+          m_stop = true;
+        }
+        m_wakeup.notify_one();
+        if (m_thread.get_id()==std::this_thread::get_id())
+        {
+          m_thread.detach();
+        }
+        else
+        {
+          m_thread.join();
+        }
+      }
+      std::lock_guard<ProfiledMutex> lock(g_mutex);
+      m_threaded = false;
+      drain();
+    }
+
+    void add(Message &&m)
+    {
+      if (m_threaded)
+      {
+        ThreadQueue &q = threadQueue();
+        bool queued = false;
+        {
+          // m_threaded is checked again while holding the queue lock: stop() clears it
+          // before its final drain(), which takes the same lock, so a message is either
+          // queued before that drain or written directly below
+          std::lock_guard<std::mutex> lock(q.mutex);
+          if (m_threaded)
+          {
+            // numbered while holding the queue lock, so drain() never sees a message
+            // without also seeing all messages with a lower number
+            m.seq = m_seq++;
+            q.messages.push_back(std::move(m));
+            queued = true;
+          }
+        }
+        if (queued)
+        {
+          if (m_pending++==0) m_wakeup.notify_one();
+          return;
+        }
+      }
+      std::lock_guard<ProfiledMutex> lock(g_mutex);
+      write(m);
+    }
+
+    /** Writes all messages issued so far, except the warnings that are kept for sorting */
+    void flush()
+    {
+      std::lock_guard<ProfiledMutex> lock(g_mutex);
+      drain();
+      fflush(stdout);
+      if (g_warnFile) fflush(g_warnFile);
+    }
+
+    /** Writes the warnings that are kept for sorting */
+    void flushSorted()
+    {
+      std::lock_guard<ProfiledMutex> lock(g_mutex);
+      drain();
+      std::sort(m_sorted.begin(),m_sorted.end(),[](const Message &m1,const Message &m2)
+      {
+        int c = qstrcmp(m1.file,m2.file);
+        if (c!=0) return c<0;
+        if (m1.line!=m2.line) return m1.line<m2.line;
+        return m1.text<m2.text;
+      });
+      for (const Message &m : m_sorted)
+      {
+        if (g_warnFile) fwrite(m.text.data(),1,m.text.length(),g_warnFile);
+      }
+      m_sorted.clear();
+    }
+
+  private:
+    struct ThreadQueue
+    {
+      std::mutex mutex;
+      std::vector<Message> messages;
+    };
+
+    MessageSink() = default;
+   ~MessageSink() = default;
+    NON_COPYABLE(MessageSink)
 
-  return g_warnHash.insert(sigStr).second;
+    ThreadQueue &threadQueue()
+    {
+      // the queue is shared with m_queues, so the logger thread can still drain
+      // it after the thread that owns it has ended
+      thread_local std::shared_ptr<ThreadQueue> queue = [this]()
+      {
+        auto q = std::make_shared<ThreadQueue>();
+        std::lock_guard<std::mutex> lock(m_queuesMutex);
+        m_queues.push_back(q);
+        return q;
+      }();
+      return *queue;
+    }
+
+    void run()
+    {
+      std::unique_lock<std::mutex> lock(m_wakeMutex);
+      while (!m_stop)
+      {
+        // a wakeup lost between the check and the wait only delays the messages a little
+        m_wakeup.wait_for(lock,std::chrono::milliseconds(50),[this]() { return m_stop || m_pending>0; });
+        lock.unlock();
+        {
+          std::lock_guard<ProfiledMutex> drainLock(g_mutex);
+          drain();
+        }
+        lock.lock();
+      }
+    }
+
+    // g_mutex must be held
+    void drain()
+    {
+      m_pending = 0;
+      std::vector<Message> batch;
+      {
+        std::lock_guard<std::mutex> lock(m_queuesMutex);
+        // all queues are locked at the same time, so a message that is still being added
+        // on another thread gets a higher number than every message taken here
+        std::vector<bool> threadEnded;
+        std::vector< std::unique_lock<std::mutex> > queueLocks;
+        threadEnded.reserve(m_queues.size());
+        queueLocks.reserve(m_queues.size());
+        for (const auto &q : m_queues)
+        {
+          // a queue only referenced by m_queues belongs to a thread that has ended, so
+          // nothing can be added to it anymore; this must be checked before taking the messages
+          threadEnded.push_back(q.use_count()==1);
+          queueLocks.emplace_back(q->mutex);
+        }
+        for (const auto &q : m_queues)
+        {
+          std::move(q->messages.begin(),q->messages.end(),std::back_inserter(batch));
+          q->messages.clear();
+        }
+        queueLocks.clear();
+        size_t i=0;
+        for (auto it = m_queues.begin(); it!=m_queues.end(); ++i)
+        {
+          if (threadEnded[i])
+          {
+            it = m_queues.erase(it);
+          }
+          else
+          {
+            ++it;
+          }
+        }
+      }
+      std::sort(batch.begin(),batch.end(),[](const Message &m1,const Message &m2) { return m1.seq<m2.seq; });
+      for (const Message &m : batch)
+      {
+        write(m);
+      }
+    }
+
+    // g_mutex must be held
+    void write(const Message &m)
+    {
+      if (m.unique && !g_warnHash.insert(messageSignature(m.uniqueText.empty() ? m.text : m.uniqueText)).second) return; // duplicate
+      if (m.out)
+      {
+        fwrite(m.text.data(),1,m.text.length(),m.out);
+      }
+      else if (m.toWarnFile && m_sortWarnings)
+      {
+        m_sorted.push_back(m);
+      }
+      else if (m.toWarnFile)
+      {
+        if (g_warnFile) fwrite(m.text.data(),1,m.text.length(),g_warnFile);
+      }
+      else
+      {
+        fwrite(m.text.data(),1,m.text.length(),stdout);
+      }
+    }
+
+    std::atomic<uint64_t> m_seq { 0 };
+    std::atomic<size_t> m_pending { 0 };
+    std::atomic<bool> m_threaded { false };
+    bool m_sortWarnings = false;
+    bool m_stop = false;
+    std::mutex m_stopMutex;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeup;
+    std::mutex m_queuesMutex;
+    std::vector<std::shared_ptr<ThreadQueue>> m_queues;
+    std::vector<Message> m_sorted;
+    std::thread m_thread;
+};
+
+
+void addMessage(bool toWarnFile,const QCString &text,bool unique=false,const QCString &uniqueText=QCString(),
+                const QCString &file=QCString(),int line=0)
+{
+  MessageSink::instance().add(Message{ 0, toWarnFile, text.str(), unique, uniqueText.str(), file, line });
+}
+
+} // namespace
+
+//-----------------------------------------------------------------------------------------
+
+// g_mutex must be held
+static bool checkWarnMessage(const QCString &result)
+{
+  return g_warnHash.insert(messageSignature(result.str())).second;
+}
+
+// writes all pending messages, after this messages are written directly
+static void stopMessageSink()
+{
+  MessageSink::instance().stop();
+  MessageSink::instance().flushSorted();
 }
 
 static void format_warn(const QCString &file,int line,const QCString &text)
@@ -79,19 +362,21 @@ static void format_warn(const QCString &file,int line,const QCString &text)
   }
   msgText += '\n';
 
-  {
-    std::unique_lock<std::mutex> lock(g_mutex);
-    // print resulting message
-    if (checkWarnMessage(msgText)) fwrite(msgText.data(),1,msgText.length(),g_warnFile);
-  }
   if (g_warnBehavior == WARN_AS_ERROR_t::YES)
   {
+    stopMessageSink();
+    {
+      std::unique_lock<ProfiledMutex> lock(g_mutex);
+      // print resulting message
+      if (checkWarnMessage(msgText)) fwrite(msgText.data(),1,msgText.length(),g_warnFile);
+    }
     if (g_warnFile != stderr && !Config_getBool(QUIET))
     {
       msg("See '{}' for the reason of termination.\n",g_warnlogFile);
     }
     exit(1);
   }
+  addMessage(true,msgText,true,QCString(),file,line);
   g_warnStat = true;
 }
 
@@ -101,8 +386,9 @@ static void handle_warn_as_error()
 {
   if (g_warnBehavior == WARN_AS_ERROR_t::YES)
   {
+    stopMessageSink();
     {
-      std::unique_lock<std::mutex> lock(g_mutex);
+      std::unique_lock<ProfiledMutex> lock(g_mutex);
       QCString msgText = " (warning treated as error, aborting now)\n";
       fwrite(msgText.data(),1,msgText.length(),g_warnFile);
       if (g_warnFile != stderr && !Config_getBool(QUIET))
@@ -130,12 +416,13 @@ void msg_(fmt::string_view fmt, fmt::format_args args)
 {
   if (!Config_getBool(QUIET))
   {
-    std::unique_lock<std::mutex> lock(g_mutex);
+    QCString text;
     if (Debug::isFlagSet(Debug::Time))
     {
-      fmt::print("{:.3f} sec: ",(static_cast<double>(Debug::elapsedTime())));
+      text = fmt::format("{:.3f} sec: ",(static_cast<double>(Debug::elapsedTime())));
     }
-    fmt::print("{}",fmt::vformat(fmt,args));
+    text += fmt::vformat(fmt,args);
+    addMessage(false,text);
   }
 }
 
@@ -162,10 +449,8 @@ void warn_(WarningType type, const QCString &file, int line, fmt::string_view fm
 
 void warn_uncond_(fmt::string_view fmt, fmt::format_args args)
 {
-  {
-    std::unique_lock<std::mutex> lock(g_mutex);
-    if (checkWarnMessage(g_errorStr+fmt::vformat(fmt,args))) fmt::print(g_warnFile,"{}{}",g_warningStr,vformat(fmt,args));
-  }
+  QCString text = fmt::vformat(fmt,args);
+  addMessage(true,g_warningStr+text,true,g_errorStr+text);
   handle_warn_as_error();
 }
 
@@ -173,10 +458,8 @@ void warn_uncond_(fmt::string_view fmt, fmt::format_args args)
 
 void err_(fmt::string_view fmt, fmt::format_args args)
 {
-  {
-    std::unique_lock<std::mutex> lock(g_mutex);
-    if (checkWarnMessage(g_errorStr+fmt::vformat(fmt,args))) fmt::print(g_warnFile,"{}{}",g_errorStr,fmt::vformat(fmt,args));
-  }
+  QCString text = g_errorStr+fmt::vformat(fmt,args);
+  addMessage(true,text,true);
   handle_warn_as_error();
 }
 
@@ -191,8 +474,9 @@ void err_full_(const QCString &file, int line, fmt::string_view fmt, fmt::format
 
 void term_(fmt::string_view fmt, fmt::format_args args)
 {
+  stopMessageSink();
   {
-    std::unique_lock<std::mutex> lock(g_mutex);
+    std::unique_lock<ProfiledMutex> lock(g_mutex);
     if (checkWarnMessage(g_errorStr+fmt::vformat(fmt,args))) fmt::print(g_warnFile, "{}{}", g_errorStr, fmt::vformat(fmt,args));
     if (g_warnFile != stderr)
     {
@@ -226,9 +510,16 @@ QCString warn_line(const QCString &file,int line)
 
 //-----------------------------------------------------------------------------------------
 
+void msg_debug(FILE *file,const std::string &text)
+{
+  Message m{ 0, false, text, false, std::string(), QCString(), 0 };
+  m.out = file;
+  MessageSink::instance().add(std::move(m));
+}
+
 void warn_flush()
 {
-  fflush(g_warnFile);
+  MessageSink::instance().flush();
 }
 
 //-----------------------------------------------------------------------------------------
@@ -287,12 +578,21 @@ void initWarningFormat()
         g_warnFile = nullptr;
       }
   });
+
+  // with multiple threads, the messages are written by a logger thread, so threads issuing
+  // messages do not have to wait for each other
+  MessageSink::instance().start(Config_getInt(NUM_PROC_THREADS)!=1,
+                                Config_getBool(WARN_SORTED) && g_warnBehavior!=WARN_AS_ERROR_t::YES);
+  // registered after the handler that closes g_warnFile, so it runs before that one
+  std::atexit(stopMessageSink);
 }
 
 //-----------------------------------------------------------------------------------------
 
 void finishWarnExit()
 {
+  MessageSink::instance().flush();
+  MessageSink::instance().flushSorted();
   fflush(stdout);
   if (g_warnBehavior == WARN_AS_ERROR_t::FAIL_ON_WARNINGS_PRINT && g_warnlogFile != "-")
   {
@@ -16,6 +16,7 @@
 #ifndef MESSAGE_H
 #define MESSAGE_H
 
+#include <cstdio>
 #include <fmt/core.h>
 #include <fmt/compile.h>
 
@@ -37,6 +38,8 @@ void warn_uncond_(fmt::string_view fmt, fmt::format_args args);
 void err_(fmt::string_view fmt, fmt::format_args args);
 void err_full_(const QCString &file, int line, fmt::string_view fmt, fmt::format_args args);
 void term_(fmt::string_view fmt, fmt::format_args args);
+//! writes debug output \a text to \a file, in order with the other messages
+void msg_debug(FILE *file,const std::string &text);
 QCString warn_line(const QCString &file, int line);
 void initWarningFormat();
 void warn_flush();
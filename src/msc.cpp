@@ -24,6 +24,7 @@
 #include "util.h"
 #include "mscgen_api.h"
 #include "dir.h"
+#include "fileinfo.h"
 #include "textstream.h"
 #include "stringutil.h"
 
@@ -154,6 +155,16 @@ static bool do_mscgen_generate(const QCString& inFile,const QCString& outFile,ms
   return true;
 }
 
+static void addImageFileToIndex(QCString imgName)
+{
+  int i=std::max(imgName.findRev('/'),imgName.findRev('\\'));
+  if (i!=-1) // strip path
+  {
+    imgName=imgName.right(imgName.length()-i-1);
+  }
+  Doxygen::indexList->addImageFile(imgName);
+}
+
 void writeMscGraphFromFile(const QCString &inFile,const QCString &outDir,
                            const QCString &outFile,MscOutputFormat format,
                            const QCString &srcFile,int srcLine
@@ -182,12 +193,25 @@ void writeMscGraphFromFile(const QCString &inFile,const QCString &outDir,
     default:
       return;
   }
+
+  // skip running mscgen when the chart and the settings used to render it did not
+  // change since the previous run and the result is still there (like for dot graphs)
+  bool convertToPdf = format==MscOutputFormat::EPS && Config_getBool(USE_PDFLATEX);
+  QCString resultName = convertToPdf ? absOutFile+".pdf" : imgName;
+  QCString sig = computeMd5Signature(fileToString(inFile)+"\n"+imgName+"\n"+
+                                     Config_getString(MSCGEN_TOOL)+(convertToPdf?"\npdf":""));
+  if (sameMd5Signature(absOutFile,sig) && FileInfo(resultName.str()).exists())
+  {
+    addImageFileToIndex(imgName);
+    return;
+  }
+
   if (!do_mscgen_generate(inFile,imgName,msc_format,srcFile,srcLine))
   {
     return;
   }
 
-  if ( (format==MscOutputFormat::EPS) && (Config_getBool(USE_PDFLATEX)) )
+  if (convertToPdf)
   {
     QCString epstopdfArgs(maxCmdLine, QCString::ExplicitSize);
     epstopdfArgs.sprintf("\"%s.eps\" --outfile=\"%s.pdf\"",
@@ -201,14 +225,9 @@ void writeMscGraphFromFile(const QCString &inFile,const QCString &outDir,
       Dir().remove((absOutFile + ".eps").data());
     }
   }
+  writeMd5Signature(absOutFile,sig);
 
-  int i=std::max(imgName.findRev('/'),imgName.findRev('\\'));
-  if (i!=-1) // strip path
-  {
-    imgName=imgName.right(imgName.length()-i-1);
-  }
-  Doxygen::indexList->addImageFile(imgName);
-
+  addImageFileToIndex(imgName);
 }
 
 static QCString getMscImageMapFromFile(const QCString& inFile, const QCString& /* outDir */,
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef ONCEMAP_H
+#define ONCEMAP_H
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "construct.h"
+
+/** @brief Thread safe map whose values are computed once, on first use.
+ *
+ *  The map is split in a number of shards, each with its own lock, that is only
+ *  held while looking up or inserting an entry. The value of an entry is
+ *  initialized outside of that lock, so values for different keys are computed
+ *  in parallel. Threads asking for a value that is still being computed wait
+ *  for that computation only.
+ *
+ *  Entries are never removed, so references to values remain valid for the
+ *  lifetime of the map.
+ */
+template<class Key,class T,size_t NumShards=16,class Hash=std::hash<Key>>
+class OnceMap
+{
+  public:
+    OnceMap() = default;
+    NON_COPYABLE(OnceMap)
+
+    /** Returns the value for \a key. If it does not exist yet, a default
+     *  constructed value is created and passed to \a init by exactly one thread.
+     *  If \a init throws, the next caller will try to initialize the value again.
+     */
+    template<class Init>
+    T &get(const Key &key,Init &&init)
+    {
+      Entry &entry = find(key);
+      std::call_once(entry.once,[&]() { init(entry.value); });
+      return entry.value;
+    }
+
+    /** Removes all entries. Must not be called while other threads use the map. */
+    void clear()
+    {
+      for (auto &shard : m_shards)
+      {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.map.clear();
+      }
+    }
+
+  private:
+    struct Entry
+    {
+      std::once_flag once;
+      T value;
+    };
+    struct Shard
+    {
+      std::mutex mutex;
+      std::unordered_map<Key,std::unique_ptr<Entry>,Hash> map;
+    };
+
+    Entry &find(const Key &key)
+    {
+      Shard &shard = m_shards[Hash()(key)%NumShards];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto &entry = shard.map[key];
+      if (!entry) entry = std::make_unique<Entry>();
+      return *entry;
+    }
+
+    std::array<Shard,NumShards> m_shards;
+};
+
+#endif
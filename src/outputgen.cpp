@@ -23,6 +23,7 @@
 #include "outputgen.h"
 #include "message.h"
 #include "portable.h"
+#include "asyncfilewriter.h"
 
 OutputGenerator::OutputGenerator(const QCString &dir) : m_t(nullptr), m_dir(dir)
 {
@@ -33,20 +34,26 @@ void OutputGenerator::startPlainFile(const QCString &name)
 {
   //printf("startPlainFile(%s)\n",qPrint(name));
   m_fileName=m_dir+"/"+name;
-  m_file = Portable::fopen(m_fileName.data(),"wb");
-  if (m_file==nullptr)
-  {
-    term("Could not open file {} for writing\n",m_fileName);
-  }
-  m_t.setFile(m_file);
+  // the contents is buffered in m_t and written by the AsyncFileWriter in endPlainFile();
+  // m_t has no sink, so it must not be flushed in between, as that would discard the buffer
+  m_t.setStream(nullptr);
+  if (Profiler::isEnabled()) m_startTime = Profiler::Clock::now();
 }
 
 void OutputGenerator::endPlainFile()
 {
-  m_t.flush();
-  m_t.setStream(nullptr);
-  Portable::fclose(m_file);
+  QCString fileName = m_fileName;
+  AsyncFileWriter::instance().write(fileName,takePlainFile());
+}
+
+std::string OutputGenerator::takePlainFile()
+{
+  if (Profiler::isEnabled())
+  {
+    Profiler::addSpan("page",m_fileName.str(),m_startTime,Profiler::Clock::now());
+  }
   m_fileName.clear();
+  return m_t.take();
 }
 
 QCString OutputGenerator::dir() const
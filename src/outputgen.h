@@ -27,6 +27,7 @@
 #include "textstream.h"
 #include "docparser.h"
 #include "construct.h"
+#include "profiler.h"
 
 class ClassDiagram;
 class DotClassGraph;
@@ -112,12 +113,14 @@ class OutputGenerator
 
     void startPlainFile(const QCString &name);
     void endPlainFile();
+    //! ends the current file like endPlainFile(), but returns its contents instead of writing them
+    std::string takePlainFile();
   protected:
     TextStream m_t;
     QCString m_dir;
   private:
     QCString m_fileName;
-    FILE *m_file = nullptr;
+    Profiler::TimePoint m_startTime; // for profiling, set when the file is started
 };
 
 
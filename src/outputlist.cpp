@@ -230,7 +230,7 @@ void OutputCodeRecorder::startNewLine(int lineNr)
 
 void OutputCodeRecorder::codify(const QCString &s)
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->codify(s); },
                        m_insideSpecialComment
                       );
@@ -239,7 +239,7 @@ void OutputCodeRecorder::codify(const QCString &s)
 void OutputCodeRecorder::startSpecialComment()
 {
   m_insideSpecialComment=true;
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->startSpecialComment(); },
                        true
                       );
@@ -247,7 +247,7 @@ void OutputCodeRecorder::startSpecialComment()
 
 void OutputCodeRecorder::endSpecialComment()
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->endSpecialComment(); },
                        true
                       );
@@ -259,7 +259,7 @@ void OutputCodeRecorder::writeCodeLink(CodeSymbolType type,
                    const QCString &anchor,const QCString &name,
                    const QCString &tooltip)
 {
-  m_calls.emplace_back([](){ return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->writeCodeLink(type,ref,file,anchor,name,tooltip); },
                        m_insideSpecialComment
                       );
@@ -269,7 +269,7 @@ void OutputCodeRecorder::writeLineNumber(const QCString &ref,const QCString &fil
                      int lineNumber, bool writeLineAnchor)
 {
   startNewLine(lineNumber);
-  m_calls.emplace_back([&]() { return m_showLineNumbers; },
+  m_calls.emplace_back(true,
                        [=](OutputCodeList *ol) { ol->writeLineNumber(ref,file,anchor,lineNumber,writeLineAnchor); },
                        m_insideSpecialComment
                       );
@@ -278,7 +278,7 @@ void OutputCodeRecorder::writeLineNumber(const QCString &ref,const QCString &fil
 void OutputCodeRecorder::writeTooltip(const QCString &id, const DocLinkInfo &docInfo, const QCString &decl,
                   const QCString &desc, const SourceLinkInfo &defInfo, const SourceLinkInfo &declInfo)
 {
-  m_calls.emplace_back([](){ return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->writeTooltip(id,docInfo,decl,desc,defInfo,declInfo); },
                        m_insideSpecialComment
                       );
@@ -287,7 +287,7 @@ void OutputCodeRecorder::writeTooltip(const QCString &id, const DocLinkInfo &doc
 void OutputCodeRecorder::startCodeLine(int lineNr)
 {
   startNewLine(lineNr);
-  m_calls.emplace_back([](){ return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->startCodeLine(lineNr); },
                        m_insideSpecialComment
                       );
@@ -295,7 +295,7 @@ void OutputCodeRecorder::startCodeLine(int lineNr)
 
 void OutputCodeRecorder::endCodeLine()
 {
-  m_calls.emplace_back([](){ return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->endCodeLine(); },
                        m_insideSpecialComment
                       );
@@ -303,7 +303,7 @@ void OutputCodeRecorder::endCodeLine()
 
 void OutputCodeRecorder::startFontClass(const QCString &c)
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->startFontClass(c); },
                        m_insideSpecialComment
                       );
@@ -311,7 +311,7 @@ void OutputCodeRecorder::startFontClass(const QCString &c)
 
 void OutputCodeRecorder::endFontClass()
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol){ ol->endFontClass(); },
                        m_insideSpecialComment
                       );
@@ -319,7 +319,7 @@ void OutputCodeRecorder::endFontClass()
 
 void OutputCodeRecorder::writeCodeAnchor(const QCString &name)
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol){ ol->writeCodeAnchor(name); },
                        m_insideSpecialComment
                       );
@@ -335,7 +335,7 @@ void OutputCodeRecorder::endCodeFragment(const QCString &style)
 
 void OutputCodeRecorder::startFold(int lineNr,const QCString &startMarker,const QCString &endMarker)
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->startFold(lineNr,startMarker,endMarker); },
                        m_insideSpecialComment
                       );
@@ -343,14 +343,14 @@ void OutputCodeRecorder::startFold(int lineNr,const QCString &startMarker,const
 
 void OutputCodeRecorder::endFold()
 {
-  m_calls.emplace_back([]() { return true; },
+  m_calls.emplace_back(false,
                        [=](OutputCodeList *ol) { ol->endFold(); },
                        m_insideSpecialComment
                       );
 }
 
 void OutputCodeRecorder::replay(OutputCodeList &ol,int startLine,int endLine,bool showLineNumbers,bool
-    stripCodeComments,size_t stripIndentAmount)
+    stripCodeComments,size_t stripIndentAmount) const
 {
   size_t startIndex = startLine>0 && startLine<=(int)m_lineOffset.size() ? m_lineOffset[startLine-1] : 0;
   size_t endIndex   = endLine>0   && endLine  <=(int)m_lineOffset.size() ? m_lineOffset[  endLine-1] : m_calls.size();
@@ -359,7 +359,6 @@ void OutputCodeRecorder::replay(OutputCodeList &ol,int startLine,int endLine,boo
   // configure run time properties of the rendering
   ol.stripCodeComments(stripCodeComments);
   ol.setStripIndentAmount(stripIndentAmount);
-  m_showLineNumbers = showLineNumbers;
 
   bool insideSpecialComment = false;
   // in case the start of the special comment marker is outside of the fragment, start it here
@@ -372,7 +371,7 @@ void OutputCodeRecorder::replay(OutputCodeList &ol,int startLine,int endLine,boo
   // render the requested fragment of the pre-recorded output
   for (size_t i=startIndex; i<endIndex; i++)
   {
-    if (m_calls[i].condition())
+    if (showLineNumbers || !m_calls[i].isLineNumber)
     {
       insideSpecialComment = m_calls[i].insideSpecialComment;
       m_calls[i].function(&ol);
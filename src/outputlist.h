@@ -137,22 +137,21 @@ class OutputCodeRecorder : public OutputCodeIntf
     void startFold(int lineNr,const QCString &startMarker,const QCString &endMarker) override;
     void endFold() override;
 
-    void replay(OutputCodeList &ol,int startLine,int endLine,bool showLineNumbers,bool stripComment,size_t stripIndentAmount);
+    //! Replays the recorded calls. Several threads can replay the same recording at the same time.
+    void replay(OutputCodeList &ol,int startLine,int endLine,bool showLineNumbers,bool stripComment,size_t stripIndentAmount) const;
   private:
     void startNewLine(int lineNr);
     struct CallInfo
     {
-      using ConditionFunc = std::function<bool()>;
       using OutputFunc    = std::function<void(OutputCodeList*)>;
-      CallInfo(ConditionFunc &&c,OutputFunc &&f,bool ic)
-        : condition(std::move(c)), function(std::move(f)), insideSpecialComment(ic) {}
-      ConditionFunc  condition;
+      CallInfo(bool ln,OutputFunc &&f,bool ic)
+        : isLineNumber(ln), function(std::move(f)), insideSpecialComment(ic) {}
+      bool           isLineNumber = false; // only replayed when line numbers are shown
       OutputFunc     function;
       bool           insideSpecialComment = false;
     };
     std::vector<CallInfo> m_calls;
     std::vector<size_t>   m_lineOffset;
-    bool m_showLineNumbers = false;
     bool m_insideSpecialComment = false;
 };
 
@@ -216,6 +215,16 @@ class OutputCodeList
       return nullptr;
     }
 
+    template<class T>
+    const T *get(OutputType o) const
+    {
+      for (const auto &e : m_outputCodeList)
+      {
+        if (e.intf->type()==o) { return static_cast<const T*>(e.intf.get()); }
+      }
+      return nullptr;
+    }
+
     /** Enable or disable a specific generator */
     void setEnabledFiltered(OutputType o,bool enabled)
     {
@@ -0,0 +1,129 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pathsuffixindex.h"
+
+struct PathSuffixIndex::Node
+{
+  std::unordered_map<std::string,std::unique_ptr<Node>> children;
+  Match here;        // paths that end at this node
+  Match inChildren;  // paths that continue in one of the children
+  Match below;       // here and inChildren combined
+  Match suffixMatch; // for a child: paths that continue in a sibling whose name ends with the name of this node
+};
+
+static void add(PathSuffixIndex::Match &m,size_t index)
+{
+  m.count++;
+  m.last = index;
+}
+
+static void add(PathSuffixIndex::Match &m,const PathSuffixIndex::Match &other)
+{
+  if (other.count==0) return;
+  m.last = m.count==0 ? other.last : std::max(m.last,other.last);
+  m.count += other.count;
+}
+
+//! splits \a path in its components, ignoring the final '/'
+static std::vector<std::string_view> splitPath(std::string_view path)
+{
+  std::vector<std::string_view> components;
+  if (path.empty()) return components;
+  if (path.back()=='/') path.remove_suffix(1);
+  size_t start=0;
+  size_t end=0;
+  while ((end=path.find('/',start))!=std::string_view::npos)
+  {
+    components.push_back(path.substr(start,end-start));
+    start=end+1;
+  }
+  components.push_back(path.substr(start));
+  return components;
+}
+
+static bool endsWith(std::string_view s,std::string_view suffix)
+{
+  return s.size()>=suffix.size() && s.compare(s.size()-suffix.size(),suffix.size(),suffix)==0;
+}
+
+//! fills in the suffixMatch of the children of \a node and its descendants
+void PathSuffixIndex::computeSuffixMatches(Node &node)
+{
+  for (auto &[name,child] : node.children)
+  {
+    // each child contributes to all siblings whose name is a suffix of its name, including itself
+    for (size_t i=0; i<=name.size(); i++)
+    {
+      auto it = node.children.find(name.substr(i));
+      if (it!=node.children.end()) add(it->second->suffixMatch,child->below);
+    }
+    computeSuffixMatches(*child);
+  }
+}
+
+PathSuffixIndex::PathSuffixIndex(const StringVector &paths) : m_root(std::make_unique<Node>()), m_size(paths.size())
+{
+  for (size_t index=0; index<paths.size(); index++)
+  {
+    auto components = splitPath(paths[index]);
+    Node *node = m_root.get();
+    add(node->below,index);
+    for (auto it=components.rbegin(); it!=components.rend(); ++it)
+    {
+      add(node->inChildren,index);
+      auto &child = node->children[std::string(*it)];
+      if (!child) child = std::make_unique<Node>();
+      node = child.get();
+      add(node->below,index);
+    }
+    add(node->here,index);
+  }
+  computeSuffixMatches(*m_root);
+}
+
+PathSuffixIndex::~PathSuffixIndex() = default;
+
+PathSuffixIndex::Match PathSuffixIndex::find(std::string_view path) const
+{
+  auto components = splitPath(path);
+  if (components.empty()) return m_root->here;
+
+  // all but the first component must match a complete path component
+  const Node *node = m_root.get();
+  for (size_t i=components.size()-1; i>0; i--)
+  {
+    auto it = node->children.find(std::string(components[i]));
+    if (it==node->children.end()) return Match();
+    node = it->second.get();
+  }
+
+  // the first component may also match the end of a component
+  std::string_view first = components[0];
+  if (first.empty()) return node->inChildren;
+  auto it = node->children.find(std::string(first));
+  if (it!=node->children.end()) return it->second->suffixMatch;
+  Match result;
+  for (const auto &[name,child] : node->children)
+  {
+    if (endsWith(name,first)) add(result,child->below);
+  }
+  return result;
+}
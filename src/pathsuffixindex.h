@@ -0,0 +1,64 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef PATHSUFFIXINDEX_H
+#define PATHSUFFIXINDEX_H
+
+#include <memory>
+#include <string_view>
+
+#include "containers.h"
+#include "construct.h"
+
+/** @brief Immutable index that finds which paths of a list end with a given path.
+ *
+ *  The paths are stored in a trie of their components, last component first,
+ *  so a lookup visits one node per component of the searched path. Paths
+ *  are expected to be empty or end with a '/'. As with a plain string
+ *  compare, the first component of the searched path may match the end
+ *  of a longer component, so "b/" is found in "a/ab/".
+ *
+ *  The index is not modified after construction, so it can be searched from
+ *  several threads without locking.
+ */
+class PathSuffixIndex
+{
+  public:
+    /** Result of a lookup */
+    struct Match
+    {
+      size_t count = 0; //!< number of matching paths
+      size_t last = 0;  //!< position of the last matching path in the list, valid if count>0
+    };
+
+    /** Creates the index for \a paths */
+    explicit PathSuffixIndex(const StringVector &paths);
+   ~PathSuffixIndex();
+    NON_COPYABLE(PathSuffixIndex)
+
+    /** Returns the paths that end with \a path. An empty \a path only matches empty paths. */
+    Match find(std::string_view path) const;
+
+    /** Returns the number of indexed paths */
+    size_t size() const { return m_size; }
+
+  private:
+    struct Node;
+    static void computeSuffixMatches(Node &node);
+    std::unique_ptr<Node> m_root;
+    size_t m_size;
+};
+
+#endif
@@ -14,6 +14,9 @@
  */
 
 #include <mutex>
+#include <functional>
+#include <algorithm>
+
 #include "plantuml.h"
 #include "util.h"
 #include "portable.h"
@@ -26,6 +29,7 @@
 #include "indexlist.h"
 #include "stringutil.h"
 #include "plantumlsvgpatcher.h"
+#include "threadpool.h"
 
 static std::mutex g_PlantUmlMutex;
 
@@ -239,9 +243,31 @@ PlantumlManager::PlantumlManager()
 {
 }
 
+/** Returns the name of the image that PlantUML generates in \a outDir
+ *  for the diagram \a name. For EPS output with pdflatex the EPS file is
+ *  converted to PDF afterwards, so the PDF file is the final result.
+ */
+static QCString plantumlImageName(const QCString &outDir,const std::string &name,
+                                  PlantumlManager::OutputFormat format)
+{
+  switch (format)
+  {
+    case PlantumlManager::PUML_BITMAP:
+      return outDir+name+".png";
+    case PlantumlManager::PUML_EPS:
+      return outDir+name+(Config_getBool(USE_PDFLATEX) ? ".pdf" : ".eps");
+    case PlantumlManager::PUML_SVG:
+      return outDir+name+".svg";
+  }
+  return QCString();
+}
+
+using PlantumlJobs = std::vector< std::function<void()> >;
+
 static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
                                const PlantumlManager::ContentMap &plantumlContent,
-                               PlantumlManager::OutputFormat format)
+                               PlantumlManager::OutputFormat format,
+                               PlantumlJobs &jobs)
 {
   /* example : running: java -Djava.awt.headless=true
                -jar "/usr/local/bin/plantuml.jar"
@@ -252,14 +278,12 @@ static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
                outDir:test_doxygen/DOXYGEN_OUTPUT/html
                test_doxygen/DOXYGEN_OUTPUT/html/A
    */
-  int exitCode = 0;
   QCString plantumlJarPath = Config_getString(PLANTUML_JAR_PATH);
   QCString plantumlConfigFile = Config_getString(PLANTUML_CFG_FILE);
 
   QCString pumlExe = "java";
   QCString pumlArgs = "";
   QCString pumlType = "";
-  QCString pumlOutDir = "";
 
   const StringVector &pumlIncludePathList = Config_getList(PLANTUML_INCLUDE_PATH);
   {
@@ -308,106 +332,89 @@ static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
       break;
   }
 
+  for (const auto &[name,nb] : plantumlContent)
   {
-    for (const auto &[name,nb] : plantumlContent)
+    if (nb.content.isEmpty()) continue;
+
+    QCString pumlArguments = pumlArgs;
+    pumlArguments+="-o \"";
+    pumlArguments+=nb.outDir;
+    pumlArguments+="\" ";
+    pumlArguments+="-charset UTF-8 -t";
+    pumlArguments+=pumlType;
+    pumlArguments+=" ";
+
+    QCString pumlOutDir = nb.outDir+"/";
+    QCString puFileName = pumlOutDir+"inline_umlgraph_"+pumlType+name.c_str()+".pu";
+
+    pumlArguments+="\"";
+    pumlArguments+=puFileName;
+    pumlArguments+="\" ";
+
+    // Only the diagrams for which the content or the PlantUML settings changed since the
+    // previous run, or for which the image is missing, are passed to PlantUML.
+    // Like for dot graphs a .md5 file next to the image stores the signature.
+    QCString changedContent;
+    std::vector< std::pair<std::string,QCString> > changedDiagrams; // name + signature
+    for (const auto &diagram : nb.diagrams)
     {
-      if (nb.content.isEmpty()) continue;
-
-      QCString pumlArguments = pumlArgs;
-      msg("Generating PlantUML {} Files in {}\n",pumlType,name);
-      pumlArguments+="-o \"";
-      pumlArguments+=nb.outDir;
-      pumlArguments+="\" ";
-      pumlArguments+="-charset UTF-8 -t";
-      pumlArguments+=pumlType;
-      pumlArguments+=" ";
-
-      QCString puFileName("");
-      puFileName+=nb.outDir;
-      puFileName+="/";
-      pumlOutDir=puFileName;
-      puFileName+="inline_umlgraph_";
-      puFileName+=pumlType;
-      puFileName+=name.c_str();
-      puFileName+=".pu";
-
-      pumlArguments+="\"";
-      pumlArguments+=puFileName;
-      pumlArguments+="\" ";
-
-
-      QCString cachedContent;
-      FileInfo fi(puFileName.str());
-      if (fi.exists())
+      QCString sig = computeMd5Signature(pumlArguments+diagram.content);
+      FileInfo fi(plantumlImageName(pumlOutDir,diagram.name,format).str());
+      if (!fi.exists() || !sameMd5Signature(pumlOutDir+diagram.name,sig))
       {
-        cachedContent = fileToString(puFileName);
+        changedContent+=diagram.content;
+        changedDiagrams.emplace_back(diagram.name,sig);
       }
+    }
 
-      std::ofstream file = Portable::openOutputStream(puFileName);
-      if (!file.is_open())
-      {
-        err_full(nb.srcFile,nb.srcLine,"Could not open file {} for writing",puFileName);
-      }
-      file.write( nb.content.data(), nb.content.length() );
-      file.close();
-      Debug::print(Debug::Plantuml,0,"*** PlantumlManager::runPlantumlContent Running Plantuml arguments:{}\n",pumlArguments);
+    StringVector files;
+    auto files_kv = plantumlFiles.find(name);
+    if (files_kv!=plantumlFiles.end())
+    {
+      files = files_kv->second;
+    }
 
-      if (cachedContent != nb.content)
+    jobs.emplace_back([=,srcFile=nb.srcFile,srcLine=nb.srcLine]()
+    {
+      int exitCode = 0;
+      if (!changedDiagrams.empty())
       {
+        msg("Generating PlantUML {} Files in {}\n",pumlType,name);
+        std::ofstream file = Portable::openOutputStream(puFileName);
+        if (!file.is_open())
+        {
+          err_full(srcFile,srcLine,"Could not open file {} for writing",puFileName);
+        }
+        file.write( changedContent.data(), changedContent.length() );
+        file.close();
+        Debug::print(Debug::Plantuml,0,"*** PlantumlManager::runPlantumlContent Running Plantuml arguments:{}\n",pumlArguments);
+
         if ((exitCode=Portable::system(pumlExe.data(),pumlArguments.data(),TRUE))!=0)
         {
-          err_full(nb.srcFile,nb.srcLine,"Problems running PlantUML. Verify that the command 'java -jar \"{}\" -h' works from the command line. Exit code: {}.",
+          err_full(srcFile,srcLine,"Problems running PlantUML. Verify that the command 'java -jar \"{}\" -h' works from the command line. Exit code: {}.",
               plantumlJarPath,exitCode);
         }
-      }
-
-      // Patch SVG files after generation if patching info is registered
-      // This should run regardless of whether content was cached or not
-      if (format == PlantumlManager::PUML_SVG)
-      {
-        auto files_kv = plantumlFiles.find(name);
-        if (files_kv != plantumlFiles.end())
+        else
         {
-          for (const auto &str : files_kv->second)
+          for (const auto &[diagramName,sig] : changedDiagrams)
           {
-            QCString svgPath = pumlOutDir + str + ".svg";
-            // Normalize path separators for comparison
-            QCString normalizedSvgPath = svgPath;
-            for (size_t i = 0; i < normalizedSvgPath.length(); i++)
-            {
-              if (normalizedSvgPath[i] == '\\') normalizedSvgPath[i] = '/';
-            }
-            // Try both original and normalized paths
-            auto patchIt = PlantumlManager::instance().m_svgPatchInfo.find(svgPath.str());
-            if (patchIt == PlantumlManager::instance().m_svgPatchInfo.end())
-            {
-              patchIt = PlantumlManager::instance().m_svgPatchInfo.find(normalizedSvgPath.str());
-            }
-            if (patchIt != PlantumlManager::instance().m_svgPatchInfo.end())
-            {
-              const PlantumlManager::SVGPatchInfo &patchInfo = patchIt->second;
-              PlantumlSvgPatcher patcher(svgPath, patchInfo.relPath, patchInfo.context);
-              patcher.run();
-            }
+            writeMd5Signature(pumlOutDir+diagramName,sig);
           }
         }
-      }
 
-      if ( (format==PlantumlManager::PUML_EPS) && (Config_getBool(USE_PDFLATEX)) )
-      {
-        Debug::print(Debug::Plantuml,0,"*** PlantumlManager::runPlantumlContent Running epstopdf\n");
-        auto files_kv = plantumlFiles.find(name);
-        if (files_kv!=plantumlFiles.end())
+        if ( (format==PlantumlManager::PUML_EPS) && (Config_getBool(USE_PDFLATEX)) )
         {
-          for (const auto &str : files_kv->second)
+          Debug::print(Debug::Plantuml,0,"*** PlantumlManager::runPlantumlContent Running epstopdf\n");
+          for (const auto &changed : changedDiagrams)
           {
+            const std::string &str = changed.first;
             const int maxCmdLine = 40960;
             QCString epstopdfArgs(maxCmdLine, QCString::ExplicitSize);
             epstopdfArgs.sprintf("\"%s%s.eps\" --outfile=\"%s%s.pdf\"",
                 pumlOutDir.data(),str.c_str(), pumlOutDir.data(),str.c_str());
             if ((exitCode=Portable::system("epstopdf",epstopdfArgs.data()))!=0)
             {
-              err_full(nb.srcFile,nb.srcLine,"Problems running epstopdf. Check your TeX installation! Exit code: {}.",exitCode);
+              err_full(srcFile,srcLine,"Problems running epstopdf. Check your TeX installation! Exit code: {}.",exitCode);
             }
             else
             {
@@ -416,7 +423,35 @@ static void runPlantumlContent(const PlantumlManager::FilesMap &plantumlFiles,
           }
         }
       }
-    }
+
+      // Patch SVG files after generation if patching info is registered
+      // This should run regardless of whether content was cached or not
+      if (format == PlantumlManager::PUML_SVG)
+      {
+        for (const auto &str : files)
+        {
+          QCString svgPath = pumlOutDir + str + ".svg";
+          // Normalize path separators for comparison
+          QCString normalizedSvgPath = svgPath;
+          for (size_t i = 0; i < normalizedSvgPath.length(); i++)
+          {
+            if (normalizedSvgPath[i] == '\\') normalizedSvgPath[i] = '/';
+          }
+          // Try both original and normalized paths
+          auto patchIt = PlantumlManager::instance().m_svgPatchInfo.find(svgPath.str());
+          if (patchIt == PlantumlManager::instance().m_svgPatchInfo.end())
+          {
+            patchIt = PlantumlManager::instance().m_svgPatchInfo.find(normalizedSvgPath.str());
+          }
+          if (patchIt != PlantumlManager::instance().m_svgPatchInfo.end())
+          {
+            const PlantumlManager::SVGPatchInfo &patchInfo = patchIt->second;
+            PlantumlSvgPatcher patcher(svgPath, patchInfo.relPath, patchInfo.context);
+            patcher.run();
+          }
+        }
+      }
+    });
   }
 }
 
@@ -431,9 +466,33 @@ void PlantumlManager::registerSVGPatch(const QCString &svgName, const QCString &
 void PlantumlManager::run()
 {
   Debug::print(Debug::Plantuml,0,"*** PlantumlManager::run\n");
-  runPlantumlContent(m_pngPlantumlFiles, m_pngPlantumlContent, PUML_BITMAP);
-  runPlantumlContent(m_svgPlantumlFiles, m_svgPlantumlContent, PUML_SVG);
-  runPlantumlContent(m_epsPlantumlFiles, m_epsPlantumlContent, PUML_EPS);
+  PlantumlJobs jobs;
+  runPlantumlContent(m_pngPlantumlFiles, m_pngPlantumlContent, PUML_BITMAP, jobs);
+  runPlantumlContent(m_svgPlantumlFiles, m_svgPlantumlContent, PUML_SVG, jobs);
+  runPlantumlContent(m_epsPlantumlFiles, m_epsPlantumlContent, PUML_EPS, jobs);
+
+  // each job runs one PlantUML batch, the batches are independent so they can run in parallel
+  std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
+  if (numThreads>1 && jobs.size()>1) // multi-threaded version
+  {
+    ThreadPool threadPool(std::min(numThreads,jobs.size()));
+    std::vector< std::future<void> > results;
+    for (const auto &job : jobs)
+    {
+      results.emplace_back(threadPool.queue(job));
+    }
+    for (auto &f : results)
+    {
+      f.get();
+    }
+  }
+  else // single threaded version
+  {
+    for (const auto &job : jobs)
+    {
+      job();
+    }
+  }
 }
 
 static void print(const PlantumlManager::FilesMap &plantumlFiles)
@@ -475,7 +534,8 @@ static void addPlantumlFiles(PlantumlManager::FilesMap &plantumlFiles,
 }
 
 static void addPlantumlContent(PlantumlManager::ContentMap &plantumlContent,
-                               const std::string &key, const QCString &outDir, const QCString &puContent,
+                               const std::string &key, const std::string &value,
+                               const QCString &outDir, const QCString &puContent,
                                const QCString &srcFile,int srcLine)
 {
   auto kv = plantumlContent.find(key);
@@ -484,6 +544,7 @@ static void addPlantumlContent(PlantumlManager::ContentMap &plantumlContent,
     kv = plantumlContent.emplace(key,PlantumlContent("",outDir,srcFile,srcLine)).first;
   }
   kv->second.content+=puContent;
+  kv->second.diagrams.emplace_back(value,puContent);
 }
 
 void PlantumlManager::insert(const std::string &key, const std::string &value,
@@ -497,19 +558,19 @@ void PlantumlManager::insert(const std::string &key, const std::string &value,
     case PUML_BITMAP:
       addPlantumlFiles(m_pngPlantumlFiles,key,value);
       print(m_pngPlantumlFiles);
-      addPlantumlContent(m_pngPlantumlContent,key,outDir,puContent,srcFile,srcLine);
+      addPlantumlContent(m_pngPlantumlContent,key,value,outDir,puContent,srcFile,srcLine);
       print(m_pngPlantumlContent);
       break;
     case PUML_EPS:
       addPlantumlFiles(m_epsPlantumlFiles,key,value);
       print(m_epsPlantumlFiles);
-      addPlantumlContent(m_epsPlantumlContent,key,outDir,puContent,srcFile,srcLine);
+      addPlantumlContent(m_epsPlantumlContent,key,value,outDir,puContent,srcFile,srcLine);
       print(m_epsPlantumlContent);
       break;
     case PUML_SVG:
       addPlantumlFiles(m_svgPlantumlFiles,key,value);
       print(m_svgPlantumlFiles);
-      addPlantumlContent(m_svgPlantumlContent,key,outDir,puContent,srcFile,srcLine);
+      addPlantumlContent(m_svgPlantumlContent,key,value,outDir,puContent,srcFile,srcLine);
       print(m_svgPlantumlContent);
       break;
   }
@@ -18,6 +18,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "containers.h"
 #include "qcstring.h"
@@ -26,6 +27,16 @@
 #define MIN_PLANTUML_COUNT      8
 
 class QCString;
+
+/** A single diagram that is part of a PlantUML batch */
+struct PlantumlDiagram
+{
+  PlantumlDiagram(const std::string &name_, const QCString &content_)
+     : name(name_), content(content_) {}
+  std::string name;  //!< base name of the generated image (without extension)
+  QCString content;  //!< the \@start...\@end block for this diagram
+};
+
 struct PlantumlContent
 {
   PlantumlContent(const QCString &content_, const QCString &outDir_, const QCString &srcFile_, int srcLine_)
@@ -34,6 +45,7 @@ struct PlantumlContent
   QCString outDir;
   QCString srcFile;
   int srcLine;
+  std::vector<PlantumlDiagram> diagrams;
 };
 
 /** Singleton that manages plantuml relation actions */
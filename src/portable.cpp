@@ -3,20 +3,29 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <map>
+#include <vector>
+#include <algorithm>
 
 #if defined(_WIN32) && !defined(__CYGWIN__)
 #undef UNICODE
 #define _WIN32_DCOM
 #include <windows.h>
+#include <psapi.h>
 #else
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
 extern char **environ;
 #endif
 
@@ -30,6 +39,8 @@ extern char **environ;
 
 #include "util.h"
 #include "dir.h"
+#include "config.h"
+#include "profiler.h"
 #ifndef NODEBUG
 #include "debug.h"
 #endif
@@ -42,7 +53,7 @@ static std::map<std::string,std::string> proc_env = std::map<std::string,std::st
 
 //---------------------------------------------------------------------------------------------------------
 
-/*! Helper class to keep time interval per thread */
+/*! Helper class to keep time interval per thread and the time spent per external tool */
 class SysTimeKeeper
 {
   public:
@@ -53,8 +64,8 @@ class SysTimeKeeper
       std::lock_guard<std::mutex> lock(m_mutex);
       m_startTimes[std::this_thread::get_id()] = std::chrono::steady_clock::now();
     }
-    //! ends a timer for this thread, accumulate time difference since start
-    void stop()
+    //! ends a timer for this thread, accumulate time difference since start, also for \a tool
+    double stop(const std::string &tool)
     {
       std::lock_guard<std::mutex> lock(m_mutex);
       std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
@@ -62,22 +73,39 @@ class SysTimeKeeper
       if (it == m_startTimes.end())
       {
         err("SysTimeKeeper stop() called without matching start()\n");
-        return;
+        return 0.0;
       }
       double timeSpent = static_cast<double>(std::chrono::duration_cast<
                          std::chrono::microseconds>(endTime - it->second).count())/1000000.0;
       //printf("timeSpent on thread %zu: %.4f seconds\n",std::hash<std::thread::id>{}(std::this_thread::get_id()),timeSpent);
       m_elapsedTime += timeSpent;
+      ToolTime &tt = m_toolTimes[tool];
+      tt.calls++;
+      tt.elapsed += timeSpent;
+      tt.maxElapsed = std::max(tt.maxElapsed,timeSpent);
+      return timeSpent;
     }
 
     double elapsedTime() const { return m_elapsedTime; }
 
-  private:
-    struct TimeData
+    //! returns the time spent per tool, the most expensive tool first
+    std::vector<Portable::ToolTime> toolTimes()
     {
-      std::chrono::steady_clock::time_point startTime;
-    };
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::vector<Portable::ToolTime> tools;
+      for (const auto &[tool,tt] : m_toolTimes)
+      {
+        tools.push_back(tt);
+        tools.back().tool = tool;
+      }
+      std::sort(tools.begin(),tools.end(),[](const auto &t1,const auto &t2) { return t1.elapsed>t2.elapsed; });
+      return tools;
+    }
+
+  private:
+    using ToolTime = Portable::ToolTime;
     std::map<std::thread::id,std::chrono::steady_clock::time_point> m_startTimes;
+    std::map<std::string,ToolTime> m_toolTimes;
     double m_elapsedTime = 0;
     std::mutex m_mutex;
 };
@@ -91,8 +119,18 @@ SysTimeKeeper &SysTimeKeeper::instance()
 class AutoTimeKeeper
 {
   public:
-    AutoTimeKeeper() { SysTimeKeeper::instance().start(); }
-   ~AutoTimeKeeper() { SysTimeKeeper::instance().stop();  }
+    AutoTimeKeeper(const std::string &tool) : m_tool(tool) { SysTimeKeeper::instance().start(); }
+   ~AutoTimeKeeper()
+    {
+      double timeSpent = SysTimeKeeper::instance().stop(m_tool);
+#ifndef NODEBUG
+      Debug::print(Debug::ExtCmd,0,"Finished external command `{}` in {:.6f} seconds\n",m_tool,timeSpent);
+#else
+      (void)timeSpent;
+#endif
+    }
+  private:
+    std::string m_tool;
 };
 
 double Portable::getSysElapsedTime()
@@ -100,98 +138,317 @@ double Portable::getSysElapsedTime()
   return SysTimeKeeper::instance().elapsedTime();
 }
 
-//---------------------------------------------------------------------------------------------------------
-
+std::vector<Portable::ToolTime> Portable::getSysToolTimes()
+{
+  return SysTimeKeeper::instance().toolTimes();
+}
 
-int Portable::system(const QCString &command,const QCString &args,bool commandHasConsole)
+void Portable::printSysToolTimes()
 {
-  if (command.isEmpty()) return 1;
-  AutoTimeKeeper timeKeeper;
+  for (const auto &tt : getSysToolTimes())
+  {
+    msg("  {:<20} {:6d} calls {:12.6f} seconds (max {:.6f})\n",tt.tool,tt.calls,tt.elapsed,tt.maxElapsed);
+  }
+}
 
+size_t Portable::peakMemoryUsage()
+{
 #if defined(_WIN32) && !defined(__CYGWIN__)
-  QCString commandCorrectedPath = substitute(command,'/','\\');
-  QCString fullCmd=commandCorrectedPath;
-#else
-  QCString fullCmd=command;
-#endif
-  fullCmd=fullCmd.stripWhiteSpace();
-  if (fullCmd.at(0)!='"' && fullCmd.find(' ')!=-1)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(),&counters,sizeof(counters)))
   {
-    // add quotes around command as it contains spaces and is not quoted already
-    fullCmd="\""+fullCmd+"\"";
+    return counters.PeakWorkingSetSize;
   }
-  fullCmd += " ";
-  fullCmd += args;
-#ifndef NODEBUG
-  Debug::print(Debug::ExtCmd,0,"Executing external command `{}`\n",fullCmd);
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF,&usage)!=0) return 0;
+#if defined(__APPLE__)
+  return static_cast<size_t>(usage.ru_maxrss); // in bytes
+#else
+  return static_cast<size_t>(usage.ru_maxrss)*1024; // in kilobytes
+#endif
 #endif
+}
 
-#if !defined(_WIN32) || defined(__CYGWIN__)
-  (void)commandHasConsole;
-  /*! taken from the system() manpage on my Linux box */
-  int pid,status=0;
+//---------------------------------------------------------------------------------------------------------
 
-#ifdef _OS_SOLARIS // for Solaris we use vfork since it is more memory efficient
+/*! Limits the number of external processes running at the same time. The slots are shared by
+ *  all threads, so parallel phases that each start tools do not oversubscribe the machine.
+ */
+class JobSlots
+{
+  public:
+    static JobSlots &instance()
+    {
+      static JobSlots theInstance;
+      return theInstance;
+    }
+    void acquire()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if (m_maxJobs==0)
+      {
+        int numThreads = std::max(Config_getInt(NUM_PROC_THREADS),Config_getInt(DOT_NUM_THREADS));
+        if (numThreads<1) numThreads = static_cast<int>(std::thread::hardware_concurrency());
+        m_maxJobs = std::max(numThreads,1);
+      }
+      m_cond.wait(lock,[this]{ return m_running<m_maxJobs; });
+      m_running++;
+    }
+    void release()
+    {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running--;
+      }
+      m_cond.notify_one();
+    }
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    int m_running = 0;
+    int m_maxJobs = 0;
+};
 
-  // on Solaris fork() duplicates the memory usage
-  // so we use vfork instead
+class JobSlot
+{
+  public:
+    JobSlot()  { JobSlots::instance().acquire(); }
+   ~JobSlot()  { JobSlots::instance().release(); }
+    JobSlot(const JobSlot &) = delete;
+    JobSlot &operator=(const JobSlot &) = delete;
+};
 
-  // spawn shell
-  if ((pid=vfork())<0)
+//! returns the name of the tool started by \a command, used to group the timing statistics
+static std::string toolName(const QCString &command)
+{
+  std::string cmd = command.stripWhiteSpace().str();
+  if (!cmd.empty() && cmd[0]=='"')
   {
-    status=-1;
+    size_t e = cmd.find('"',1);
+    cmd = cmd.substr(1,e==std::string::npos ? std::string::npos : e-1);
   }
-  else if (pid==0)
+  else
   {
-     execl("/bin/sh","sh","-c",fullCmd.data(),(char*)0);
-     _exit(127);
+    size_t e = cmd.find_first_of(" \t");
+    if (e!=std::string::npos) cmd.resize(e);
   }
-  else
+  size_t i = cmd.find_last_of("/\\");
+  if (i!=std::string::npos) cmd = cmd.substr(i+1);
+  if (cmd.length()>4 && qstricmp(cmd.c_str()+cmd.length()-4,".exe")==0) cmd.resize(cmd.length()-4);
+  return cmd;
+}
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+
+/** Splits the command line \a cmd into arguments in the same way as /bin/sh would do.
+ *  Returns false if \a cmd uses shell features other than quoting and escaping
+ *  (pipes, redirection, variables, wildcards, ...), so it has to be run by the shell.
+ */
+static bool splitCommandLine(const std::string &cmd,std::vector<std::string> &args)
+{
+  args.clear();
+  std::string arg;
+  bool inArg=false;
+  size_t i=0, n=cmd.length();
+  while (i<n)
   {
-    while (waitpid(pid,&status,0 )<0)
+    char c=cmd[i];
+    if (c==' ' || c=='\t')
     {
-      if (errno!=EINTR)
+      if (inArg) { args.push_back(arg); arg.clear(); inArg=false; }
+      i++;
+    }
+    else if (c=='\'') // everything up to the next quote is literal
+    {
+      size_t e = cmd.find('\'',i+1);
+      if (e==std::string::npos) return false;
+      arg.append(cmd,i+1,e-i-1);
+      inArg=true;
+      i=e+1;
+    }
+    else if (c=='"')
+    {
+      i++;
+      while (i<n && cmd[i]!='"')
       {
-        status=-1;
-        break;
+        if (cmd[i]=='$' || cmd[i]=='`') return false; // substitution
+        if (cmd[i]=='\\' && i+1<n && strchr("$`\"\\\n",cmd[i+1]))
+        {
+          if (cmd[i+1]!='\n') arg+=cmd[i+1];
+          i+=2;
+        }
+        else
+        {
+          arg+=cmd[i++];
+        }
       }
+      if (i>=n) return false;
+      inArg=true;
+      i++;
+    }
+    else if (c=='\\')
+    {
+      if (i+1>=n) return false;
+      if (cmd[i+1]!='\n') arg+=cmd[i+1];
+      inArg=true;
+      i+=2;
+    }
+    else if (strchr("|&;<>()$`*?[\n\r",c) ||                 // operators, substitution and wildcards
+             (!inArg && (c=='#' || c=='~')) ||               // comment or home directory
+             (c=='=' && args.empty()))                       // variable assignment
+    {
+      return false;
+    }
+    else
+    {
+      arg+=c;
+      inArg=true;
+      i++;
     }
   }
-  return status;
+  if (inArg) args.push_back(arg);
+  return !args.empty();
+}
 
-#else  // Other Unices just use fork
+static bool createPipe(int fds[2])
+{
+#if defined(__linux__)
+  return pipe2(fds,O_CLOEXEC)==0;
+#else
+  if (pipe(fds)!=0) return false;
+  fcntl(fds[0],F_SETFD,FD_CLOEXEC);
+  fcntl(fds[1],F_SETFD,FD_CLOEXEC);
+  return true;
+#endif
+}
 
-  pid = fork();
-  if (pid==-1)
+/** Runs the command line \a fullCmd and waits for it to finish. The program is started directly
+ *  with posix_spawn unless the command line needs a shell. If \a output or \a errors is given,
+ *  the standard output or error stream of the program is collected in it.
+ *  Returns the exit code of the program, or -1 if it could not be started.
+ */
+static int runProcess(const QCString &fullCmd,std::string *output,std::string *errors)
+{
+  std::string file;
+  std::vector<std::string> args;
+  if (!splitCommandLine(fullCmd.str(),args))
   {
-    perror("fork error");
-	  return -1;
+    file = "/bin/sh";
+    args = { "sh", "-c", fullCmd.str() };
   }
-  if (pid==0)
+  else
+  {
+    file = args[0];
+  }
+  std::vector<char *> argv;
+  for (auto &arg : args) argv.push_back(arg.data());
+  argv.push_back(nullptr);
+
+  int outPipe[2] = { -1, -1 };
+  int errPipe[2] = { -1, -1 };
+  if ((output && !createPipe(outPipe)) || (errors && !createPipe(errPipe)))
+  {
+    for (int fd : { outPipe[0], outPipe[1], errPipe[0], errPipe[1] }) if (fd!=-1) close(fd);
+    return -1;
+  }
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (output) posix_spawn_file_actions_adddup2(&actions,outPipe[1],STDOUT_FILENO);
+  if (errors) posix_spawn_file_actions_adddup2(&actions,errPipe[1],STDERR_FILENO);
+
+  pid_t pid = 0;
+  int rc = posix_spawnp(&pid,file.c_str(),&actions,nullptr,argv.data(),environ);
+  posix_spawn_file_actions_destroy(&actions);
+  if (outPipe[1]!=-1) close(outPipe[1]);
+  if (errPipe[1]!=-1) close(errPipe[1]);
+  if (rc!=0)
   {
-    const char * const argv[4] = { "sh", "-c", fullCmd.data(), 0 };
-    execve("/bin/sh",const_cast<char * const*>(argv),environ);
-    exit(127);
+    if (outPipe[0]!=-1) close(outPipe[0]);
+    if (errPipe[0]!=-1) close(errPipe[0]);
+#ifndef NODEBUG
+    Debug::print(Debug::ExtCmd,0,"Could not start `{}`: {}\n",file,strerror(rc));
+#endif
+    return -1;
   }
-  for (;;)
+
+  // collect the output of the program until it closes both streams
+  struct pollfd fds[2];
+  std::string *buffers[2] = { output, errors };
+  int numFds=0;
+  if (output) fds[numFds++] = { outPipe[0], POLLIN, 0 };
+  if (errors) fds[numFds++] = { errPipe[0], POLLIN, 0 };
+  if (!output) buffers[0] = errors;
+  char buf[16384];
+  int numOpen=numFds;
+  while (numOpen>0)
   {
-    if (waitpid(pid,&status,0)==-1)
+    if (poll(fds,static_cast<nfds_t>(numFds),-1)<0)
     {
-      if (errno!=EINTR) return -1;
+      if (errno==EINTR) continue;
+      break;
     }
-    else
+    for (int i=0;i<numFds;i++)
     {
-      if (WIFEXITED(status))
+      if (fds[i].fd<0 || fds[i].revents==0) continue;
+      ssize_t numRead = read(fds[i].fd,buf,sizeof(buf));
+      if (numRead>0)
       {
-        return WEXITSTATUS(status);
+        buffers[i]->append(buf,static_cast<size_t>(numRead));
       }
-      else
+      else if (numRead==0 || errno!=EINTR)
       {
-        return status;
+        close(fds[i].fd);
+        fds[i].fd=-1;
+        numOpen--;
       }
     }
   }
-#endif // !_OS_SOLARIS
+  for (int i=0;i<numFds;i++) if (fds[i].fd>=0) close(fds[i].fd);
+
+  int status=0;
+  while (waitpid(pid,&status,0)==-1)
+  {
+    if (errno!=EINTR) return -1;
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : status;
+}
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------
+
+
+int Portable::system(const QCString &command,const QCString &args,bool commandHasConsole)
+{
+  if (command.isEmpty()) return 1;
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  QCString commandCorrectedPath = substitute(command,'/','\\');
+  QCString fullCmd=commandCorrectedPath;
+#else
+  QCString fullCmd=command;
+#endif
+  fullCmd=fullCmd.stripWhiteSpace();
+  if (fullCmd.at(0)!='"' && fullCmd.find(' ')!=-1)
+  {
+    // add quotes around command as it contains spaces and is not quoted already
+    fullCmd="\""+fullCmd+"\"";
+  }
+  fullCmd += " ";
+  fullCmd += args;
+#ifndef NODEBUG
+  Debug::print(Debug::ExtCmd,0,"Executing external command `{}`\n",fullCmd);
+#endif
+
+  JobSlot slot;
+  AutoTimeKeeper timeKeeper(toolName(command));
+  ProfileScope profile("extcmd",fullCmd);
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  (void)commandHasConsole;
+  return runProcess(fullCmd,nullptr,nullptr);
 
 #else // Win32 specific
   if (commandHasConsole)
@@ -246,6 +503,35 @@ int Portable::system(const QCString &command,const QCString &args,bool commandHa
 
 }
 
+int Portable::runCommand(const QCString &commandLine,std::string &output,std::string *errors)
+{
+  output.clear();
+  if (errors) errors->clear();
+  QCString cmd = commandLine.stripWhiteSpace();
+  if (cmd.isEmpty()) return -1;
+#ifndef NODEBUG
+  Debug::print(Debug::ExtCmd,0,"Executing external command `{}`\n",cmd);
+#endif
+
+  JobSlot slot;
+  AutoTimeKeeper timeKeeper(toolName(cmd));
+  ProfileScope profile("extcmd",cmd);
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  return runProcess(cmd,&output,errors);
+#else
+  FILE *f = Portable::popen(cmd,"r");
+  if (f==nullptr) return -1;
+  char buf[16384];
+  size_t numRead;
+  while ((numRead=fread(buf,1,sizeof(buf),f))>0)
+  {
+    output.append(buf,numRead);
+  }
+  return Portable::pclose(f);
+#endif
+}
+
 uint32_t Portable::pid()
 {
   uint32_t pid;
@@ -18,7 +18,17 @@ class Buf;
 
 namespace Portable
 {
+  //! time spent running an external tool, see getSysToolTimes()
+  struct ToolTime
+  {
+    std::string tool;
+    size_t calls = 0;
+    double elapsed = 0;
+    double maxElapsed = 0;
+  };
+
   int            system(const QCString &command,const QCString &args,bool commandHasConsole=true);
+  int            runCommand(const QCString &commandLine,std::string &output,std::string *errors=nullptr);
   uint32_t       pid();
   QCString       getenv(const QCString &variable);
   void           setenv(const QCString &variable,const QCString &value);
@@ -34,6 +44,9 @@ namespace Portable
   FILE *         popen(const QCString &name,const QCString &type);
   int            pclose(FILE *stream);
   double         getSysElapsedTime();
+  std::vector<ToolTime> getSysToolTimes();
+  void           printSysToolTimes();
+  size_t         peakMemoryUsage();
   bool           isAbsolutePath(const QCString &fileName);
   void           correctPath(const StringVector &list);
   void           setShortDir();
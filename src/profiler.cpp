@@ -0,0 +1,161 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "profiler.h"
+#include "debug.h"
+#include "message.h"
+#include "portable.h"
+#include "util.h"
+
+namespace
+{
+
+struct Event
+{
+  const char *category; // "lock" for lock waits
+  std::string name;
+  Profiler::TimePoint start;
+  Profiler::TimePoint end;
+};
+
+/** Events recorded by one thread. Only the owning thread appends to it, the lock
+ *  is needed as threads that are still running, such as the logger thread,
+ *  may record events while writeTrace() reads them.
+ */
+struct ThreadBuffer
+{
+  ThreadBuffer(size_t i,bool main) : index(i), isMain(main) {}
+  size_t index;
+  bool isMain;
+  std::mutex mutex; // uncontended, except while the trace is written
+  std::vector<Event> events;
+
+  void add(Event &&e)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back(std::move(e));
+  }
+};
+
+std::mutex                                 g_buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+const Profiler::TimePoint                  g_startTime = Profiler::Clock::now();
+const std::thread::id                      g_mainThreadId = std::this_thread::get_id();
+
+ThreadBuffer &threadBuffer()
+{
+  // the buffers are owned by g_buffers, so they survive the threads of a ThreadPool
+  thread_local ThreadBuffer *buffer = nullptr;
+  if (buffer==nullptr)
+  {
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+    g_buffers.push_back(std::make_unique<ThreadBuffer>(g_buffers.size(),std::this_thread::get_id()==g_mainThreadId));
+    buffer = g_buffers.back().get();
+  }
+  return *buffer;
+}
+
+int64_t toMicroSeconds(Profiler::TimePoint t)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(t-g_startTime).count();
+}
+
+} // namespace
+
+//------------------------------------------------------------------------
+
+bool Profiler::isEnabled()
+{
+  return Debug::isFlagSet(Debug::Profile);
+}
+
+void Profiler::addSpan(const char *category,const std::string &name,TimePoint start,TimePoint end)
+{
+  threadBuffer().add(Event{category,name,start,end});
+}
+
+void Profiler::addLockWait(const char *name,TimePoint start,TimePoint end)
+{
+  threadBuffer().add(Event{"lock",name,start,end});
+}
+
+void Profiler::writeTrace(const QCString &fileName)
+{
+  struct LockStats
+  {
+    size_t waits = 0;
+    int64_t total = 0;
+    int64_t max = 0;
+  };
+  std::map<std::string,LockStats> lockStats;
+  bool written = false;
+  {
+    // note: msg() cannot be used while holding the lock, as it may record a lock wait itself
+    std::lock_guard<std::mutex> lock(g_buffersMutex);
+    std::ofstream f = Portable::openOutputStream(fileName);
+    if (f.is_open())
+    {
+      f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+      f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"doxygen\"}}";
+      for (const auto &buffer : g_buffers)
+      {
+        f << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->index
+          << ",\"args\":{\"name\":\"" << (buffer->isMain ? "main" : fmt::format("thread {}",buffer->index)) << "\"}}";
+        std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+        for (const auto &e : buffer->events)
+        {
+          int64_t ts  = toMicroSeconds(e.start);
+          int64_t dur = toMicroSeconds(e.end)-ts;
+          f << ",\n{\"name\":\"" << convertToJSONString(e.name) << "\",\"cat\":\"" << e.category
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->index
+            << ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+          if (qstrcmp(e.category,"lock")==0)
+          {
+            LockStats &ls = lockStats[e.name];
+            ls.waits++;
+            ls.total += dur;
+            ls.max = std::max(ls.max,dur);
+          }
+        }
+      }
+      f << "\n]}\n";
+      written = true;
+    }
+  }
+
+  if (!written)
+  {
+    err("Could not open file {} for writing\n",fileName);
+    return;
+  }
+  msg("Profiling trace written to {}\n",fileName);
+  if (!lockStats.empty())
+  {
+    std::vector<std::pair<std::string,LockStats>> locks(lockStats.begin(),lockStats.end());
+    std::sort(locks.begin(),locks.end(),[](const auto &l1,const auto &l2) { return l1.second.total>l2.second.total; });
+    msg("Time spent waiting for locks:\n");
+    for (const auto &[name,ls] : locks)
+    {
+      msg("  {:<24} {:8d} waits {:12.6f} seconds (max {:.6f})\n",name,ls.waits,
+          static_cast<double>(ls.total)/1000000.0,static_cast<double>(ls.max)/1000000.0);
+    }
+  }
+}
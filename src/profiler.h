@@ -0,0 +1,111 @@
+/******************************************************************************
+ *
+ * Copyright (C) 1997-2025 by Dimitri van Heesch.
+ *
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation under the terms of the GNU General Public License is hereby
+ * granted. No representations are made about the suitability of this software
+ * for any purpose. It is provided "as is" without express or implied warranty.
+ * See the GNU General Public License for more details.
+ *
+ * Documents produced by Doxygen are derivative works derived from the
+ * input used in their production; they are not affected by this license.
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "qcstring.h"
+#include "construct.h"
+
+/** Records what each thread is doing when profiling is enabled via `-d profile`.
+ *
+ *  The recorded spans (phases, parsed files, generated pages, external commands)
+ *  and the time spent waiting for a ProfiledMutex are written as a trace in
+ *  the Chrome trace event format, which can be viewed with chrome://tracing
+ *  or https://ui.perfetto.dev.
+ *
+ *  Each thread records into its own buffer, so recording needs no locking.
+ */
+class Profiler
+{
+  public:
+    using Clock     = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    static bool isEnabled();
+
+    /** Records a span named \a name of category \a category on the calling thread. */
+    static void addSpan(const char *category,const std::string &name,TimePoint start,TimePoint end);
+
+    /** Records that the calling thread waited from \a start to \a end for the mutex \a name. */
+    static void addLockWait(const char *name,TimePoint start,TimePoint end);
+
+    /** Writes all recorded events to \a fileName and prints a summary of the lock waits. */
+    static void writeTrace(const QCString &fileName);
+};
+
+/** Records the lifetime of the object as a span, if profiling is enabled. */
+class ProfileScope
+{
+  public:
+    ProfileScope(const char *category,const QCString &name) : m_enabled(Profiler::isEnabled())
+    {
+      if (m_enabled)
+      {
+        m_category = category;
+        m_name     = name.str();
+        m_start    = Profiler::Clock::now();
+      }
+    }
+   ~ProfileScope()
+    {
+      if (m_enabled)
+      {
+        Profiler::addSpan(m_category,m_name,m_start,Profiler::Clock::now());
+      }
+    }
+    NON_COPYABLE(ProfileScope)
+  private:
+    bool m_enabled;
+    const char *m_category = nullptr;
+    std::string m_name;
+    Profiler::TimePoint m_start;
+};
+
+/** Drop-in replacement for std::mutex that reports contention to the profiler.
+ *  When profiling is disabled, the only overhead is checking the flag.
+ */
+class ProfiledMutex
+{
+  public:
+    constexpr ProfiledMutex(const char *name) : m_name(name) {}
+    NON_COPYABLE(ProfiledMutex)
+
+    void lock()
+    {
+      if (!Profiler::isEnabled())
+      {
+        m_mutex.lock();
+      }
+      else if (!m_mutex.try_lock()) // contended
+      {
+        Profiler::TimePoint start = Profiler::Clock::now();
+        m_mutex.lock();
+        Profiler::addLockWait(m_name,start,Profiler::Clock::now());
+      }
+    }
+    bool try_lock() { return m_mutex.try_lock(); }
+    void unlock()   { m_mutex.unlock(); }
+
+  private:
+    std::mutex m_mutex;
+    const char *m_name;
+};
+
+#endif
@@ -50,12 +50,34 @@
 #include "datetime.h"
 #include "outputlist.h"
 #include "moduledef.h"
+#include "asyncfilewriter.h"
 
 //#define DBG_RTF(x) x;
 #define DBG_RTF(x)
 
 static StringSet removeSet;
 
+//! A page kept in memory until it is combined into the main document, see RTF_COMBINE_IN_MEMORY
+struct RTFPage
+{
+  QCString    fileName; //!< path of the page on disk
+  std::string contents;
+};
+
+//! pages kept in memory, keyed by their name, see rtfPageKey()
+static std::mutex g_rtfPagesMutex;
+static std::unordered_map<std::string,RTFPage> g_rtfPages;
+//! keys of the pages in g_rtfPages that have been read while combining the document
+static StringSet g_rtfPagesRead;
+
+//! Returns the key under which the page \a fileName is kept in memory. All pages are
+//! written directly into RTF_OUTPUT, so the file name identifies a page, independent of
+//! how the directory is reached (relative, absolute or via a symbolic link).
+static std::string rtfPageKey(const QCString &fileName)
+{
+  return stripPath(fileName).str();
+}
+
 static QCString dateToRTFDateString()
 {
   auto tm = getCurrentDateTime();
@@ -720,7 +742,20 @@ void RTFGenerator::endFile()
   DBG_RTF(m_t << "{\\comment endFile}\n")
   m_t << "}";
 
-  endPlainFile();
+  static bool rtfDebug = Debug::isFlagSet(Debug::Rtf);
+  if (Config_getBool(RTF_COMBINE_IN_MEMORY) && !rtfDebug) // debugging needs the intermediate pages on disk
+  {
+    // keep the page until preProcessFileInplace() merges it into the main document
+    QCString name = fileName();
+    std::string key = rtfPageKey(name);
+    std::string contents = takePlainFile();
+    std::lock_guard<std::mutex> lock(g_rtfPagesMutex);
+    g_rtfPages[key] = RTFPage{ name, std::move(contents) };
+  }
+  else
+  {
+    endPlainFile();
+  }
   setSourceFileName("");
 }
 
@@ -2193,8 +2228,15 @@ static void encodeForOutput(TextStream &t,const QCString &s)
   encoding.sprintf("CP%s",qPrint(theTranslator->trRTFansicp()));
   if (!encoding.isEmpty())
   {
-    // convert from UTF-8 back to the output encoding
-    void *cd = portable_iconv_open(encoding.data(),"UTF-8");
+    // convert from UTF-8 back to the output encoding, the converter is opened once per encoding
+    static QCString cdEncoding;
+    static void *cd = reinterpret_cast<void *>(-1);
+    if (encoding!=cdEncoding)
+    {
+      if (cd!=reinterpret_cast<void *>(-1)) portable_iconv_close(cd);
+      cd = portable_iconv_open(encoding.data(),"UTF-8");
+      cdEncoding = encoding;
+    }
     if (cd!=reinterpret_cast<void *>(-1))
     {
       size_t iLeft=l;
@@ -2206,7 +2248,10 @@ static void encodeForOutput(TextStream &t,const QCString &s)
         enc.resize(enc.size()-oLeft);
         converted=TRUE;
       }
-      portable_iconv_close(cd);
+      else // reset the conversion state for the next call
+      {
+        portable_iconv(cd, nullptr, nullptr, nullptr, nullptr);
+      }
     }
   }
   if (!converted) // if we did not convert anything, copy as is.
@@ -2242,38 +2287,120 @@ static void encodeForOutput(TextStream &t,const QCString &s)
   }
 }
 
+/** Tracks the brace nesting of the combined RTF document while it is written,
+ *  so its integrity can be checked without reading the result back.
+ */
+struct RTFBraceChecker
+{
+  int  count     = 0;
+  int  line      = 1;
+  int  errorLine = 0;     // line where the nesting first became negative
+  bool escape    = false; // previous character was a backslash
+
+  void scan(std::string_view s)
+  {
+    for (char c : s)
+    {
+      if (escape)
+      {
+        escape=false;
+      }
+      else if (c=='\\')
+      {
+        escape=true;
+      }
+      else if (c=='{')
+      {
+        count++;
+      }
+      else if (c=='}')
+      {
+        if (--count<0 && errorLine==0) errorLine=line;
+      }
+      if (c=='\n') line++;
+    }
+  }
+  bool ok() const { return errorLine==0 && count==0; }
+};
+
+//! writes \a s to the combined document \a t in the output encoding, tracking its braces in \a bc
+static void writeCombined(TextStream &t,RTFBraceChecker &bc,const std::string &s)
+{
+  bc.scan(s);
+  encodeForOutput(t,s);
+}
+
+/** Reads an RTF page line by line, either from the copy kept in memory or from disk. */
+class RTFPageReader
+{
+  public:
+    bool open(const QCString &absName)
+    {
+      {
+        std::lock_guard<std::mutex> lock(g_rtfPagesMutex);
+        auto it = g_rtfPages.find(rtfPageKey(absName));
+        if (it!=g_rtfPages.end())
+        {
+          // the page stays in the map until the combine has succeeded, see writeRemainingPages()
+          m_contents = &it->second.contents;
+          g_rtfPagesRead.insert(it->first);
+          m_inMemory = true;
+          return true;
+        }
+      }
+      m_file = Portable::openInputStream(absName);
+      return m_file.is_open();
+    }
+    bool getline(std::string &line)
+    {
+      if (!m_inMemory) return static_cast<bool>(std::getline(m_file,line));
+      if (m_pos>=m_contents->size()) return false;
+      size_t end = m_contents->find('\n',m_pos);
+      if (end==std::string::npos) end=m_contents->size();
+      line.assign(*m_contents,m_pos,end-m_pos);
+      m_pos=end+1;
+      return true;
+    }
+    bool inMemory() const { return m_inMemory; }
+
+  private:
+    const std::string *m_contents = nullptr;
+    size_t        m_pos = 0;
+    bool          m_inMemory = false;
+    std::ifstream m_file;
+};
+
 /**
  * VERY brittle routine inline RTF's included by other RTF's.
  * it is recursive and ugly.
  */
-static bool preProcessFile(Dir &d,const QCString &infName, TextStream &t, bool bIncludeHeader=true, bool removeFile = true)
+static bool preProcessFile(Dir &d,const QCString &infName, TextStream &t, RTFBraceChecker &bc,
+                           bool bIncludeHeader=true, bool removeFile = true)
 {
   static bool rtfDebug = Debug::isFlagSet(Debug::Rtf);
-  std::ifstream f = Portable::openInputStream(infName);
-  if (!f.is_open())
+  QCString absName = FileInfo(d.filePath(infName.str())).absFilePath();
+  RTFPageReader f;
+  if (!f.open(absName))
   {
     err("problems opening rtf file '{}' for reading\n",infName);
     return false;
   }
 
-  const int maxLineLength = 10240;
-  static QCString lineBuf(maxLineLength, QCString::ExplicitSize);
-
   // scan until find end of header
   // this is EXTREEEEEEEMLY brittle.  It works on OUR rtf
   // files because the first line before the body
   // ALWAYS contains "{\comment begin body}"
   std::string line;
-  while (getline(f,line))
+  while (f.getline(line))
   {
     line+='\n';
     if (line.find("\\comment begin body")!=std::string::npos) break;
-    if (bIncludeHeader) encodeForOutput(t,line);
+    if (bIncludeHeader) writeCombined(t,bc,line);
   }
 
   std::string prevLine;
   bool first=true;
-  while (getline(f,line))
+  while (f.getline(line))
   {
     line+='\n';
     size_t pos=prevLine.find("INCLUDETEXT \"");
@@ -2283,16 +2410,17 @@ static bool preProcessFile(Dir &d,const QCString &infName, TextStream &t, bool b
       size_t endNamePos    = prevLine.find('"',startNamePos);
       QCString fileName    = prevLine.substr(startNamePos,endNamePos-startNamePos);
       DBG_RTF(t << "{\\comment begin include " << fileName << "}\n")
-      if (!preProcessFile(d,fileName,t,FALSE)) return FALSE;
+      if (!preProcessFile(d,fileName,t,bc,FALSE)) return FALSE;
       DBG_RTF(t << "{\\comment end include " << fileName << "}\n")
     }
     else if (!first) // no INCLUDETEXT on this line
     {
-      encodeForOutput(t,prevLine);
+      writeCombined(t,bc,prevLine);
     }
-    prevLine = line;
+    prevLine.swap(line);
     first=false;
   }
+  line.swap(prevLine); // last line read
   if (!bIncludeHeader) // skip final '}' in case we don't include headers
   {
     size_t pos = line.rfind('}');
@@ -2301,15 +2429,14 @@ static bool preProcessFile(Dir &d,const QCString &infName, TextStream &t, bool b
       err("Strange, the last char was not a '}}'\n");
       pos = line.length();
     }
-    encodeForOutput(t,line.substr(0,pos));
+    writeCombined(t,bc,line.substr(0,pos));
   }
   else
   {
-    encodeForOutput(t,line);
+    writeCombined(t,bc,line);
   }
-  f.close();
   // remove temporary file
-  if (!rtfDebug && removeFile) removeSet.insert(FileInfo(d.filePath(infName.str())).absFilePath());
+  if (!rtfDebug && removeFile && !f.inMemory()) removeSet.insert(absName.str());
   return TRUE;
 }
 
@@ -2410,50 +2537,52 @@ void RTFGenerator::endDirDepGraph(DotDirDeps &g)
   DBG_RTF(m_t << "{\\comment (endDirDepGraph)}\n")
 }
 
-/** Tests the integrity of the result by counting brackets.
- *
+/** Reports a failed integrity test of the combined document \a name,
+ *  based on the brackets counted while it was written.
+ */
+static void testRTFOutput(const QCString &name,const RTFBraceChecker &bc)
+{
+  if (bc.ok()) return; // file is OK.
+  err("RTF integrity test failed at line {:d} of {} due to a bracket mismatch.\n"
+      "       Please try to create a small code example that produces this error \n"
+      "       and send that to doxygen@gmail.com.\n",bc.errorLine>0 ? bc.errorLine : bc.line,name);
+}
+
+/** Writes the pages kept in memory to disk. If \a combined is set, the pages read
+ *  while combining the document are part of it and are dropped; otherwise the combine
+ *  failed and all pages are written, as they would be in the disk based mode.
  */
-void testRTFOutput(const QCString &name)
+static void writeRemainingPages(bool combined)
 {
-  int bcount=0;
-  int line=1;
-  int c=0;
-  std::ifstream f = Portable::openInputStream(name);
-  if (f.is_open())
+  std::unordered_map<std::string,RTFPage> pages;
   {
-    while ((c=f.get())!=-1)
+    std::lock_guard<std::mutex> lock(g_rtfPagesMutex);
+    if (combined)
     {
-      if (c=='\\') // escape char
-      {
-        c=f.get();
-        if (c==-1) break;
-      }
-      else if (c=='{') // open bracket
-      {
-        bcount++;
-      }
-      else if (c=='}') // close bracket
-      {
-        bcount--;
-        if (bcount<0)
-        {
-          goto err;
-          break;
-        }
-      }
-      else if (c=='\n') // newline
-      {
-        line++;
-      }
+      for (const auto &key : g_rtfPagesRead) g_rtfPages.erase(key);
     }
+    g_rtfPagesRead.clear();
+    pages.swap(g_rtfPages);
   }
-  if (bcount==0) return; // file is OK.
-err:
-  err("RTF integrity test failed at line {:d} of {} due to a bracket mismatch.\n"
-      "       Please try to create a small code example that produces this error \n"
-      "       and send that to doxygen@gmail.com.\n",line,name);
+  if (pages.empty()) return;
+  for (auto &[key,page] : pages)
+  {
+    AsyncFileWriter::instance().write(page.fileName,std::move(page.contents));
+  }
+  AsyncFileWriter::instance().waitForCompletion();
 }
 
+/** Calls writeRemainingPages() when it goes out of scope, so the pages kept in memory
+ *  are written on every exit from preProcessFileInplace().
+ */
+struct RemainingPagesWriter
+{
+  bool combined = false; //!< set once the combined document is complete
+  RemainingPagesWriter() = default;
+ ~RemainingPagesWriter() { writeRemainingPages(combined); }
+  NON_COPYABLE(RemainingPagesWriter)
+};
+
 /**
  * This is an API to a VERY brittle RTF preprocessor that combines nested
  * RTF files.  This version replaces the infile with the new file
@@ -2461,6 +2590,7 @@ err:
 bool RTFGenerator::preProcessFileInplace(const QCString &path,const QCString &name)
 {
   static bool rtfDebug = Debug::isFlagSet(Debug::Rtf);
+  RemainingPagesWriter remainingPages;
 
   Dir d(path.str());
   // store the original directory
@@ -2487,7 +2617,8 @@ bool RTFGenerator::preProcessFileInplace(const QCString &path,const QCString &na
   }
   TextStream outt(&f);
 
-  if (!preProcessFile(thisDir,mainRTFName,outt,true,false))
+  RTFBraceChecker bc;
+  if (!preProcessFile(thisDir,mainRTFName,outt,bc,true,false))
   {
     // it failed, remove the temp file
     outt.flush();
@@ -2496,6 +2627,7 @@ bool RTFGenerator::preProcessFileInplace(const QCString &path,const QCString &na
     Dir::setCurrent(oldDir);
     return FALSE;
   }
+  remainingPages.combined = true;
 
   // everything worked, move the files
   outt.flush();
@@ -2510,7 +2642,7 @@ bool RTFGenerator::preProcessFileInplace(const QCString &path,const QCString &na
   }
   thisDir.rename(combinedName.str(),mainRTFName.str());
 
-  testRTFOutput(mainRTFName);
+  testRTFOutput(mainRTFName,bc);
 
   QCString rtfOutputDir = Dir::currentDirPath();
   for (auto &s : removeSet)
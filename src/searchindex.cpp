@@ -19,6 +19,9 @@
 #include <mutex>
 #include <map>
 #include <unordered_map>
+#include <algorithm>
+#include <atomic>
+#include <string_view>
 
 #include "searchindex.h"
 
@@ -50,30 +53,122 @@ static std::mutex g_searchIndexMutex;
 
 //--------------------------------------------------------------------
 
-void SearchIndex::IndexWord::addUrlIndex(int idx,bool hiPriority)
+namespace {
+
+/** Title and link of a document in the index */
+struct URL
+{
+  URL(const QCString &n,const QCString &u) : name(n), url(u) {}
+  QCString name;
+  QCString url;
+};
+
+/** Occurrence count of a word in a document, freq is 2*count and bit 0 marks a high priority hit */
+struct URLInfo
+{
+  int urlIdx;
+  int freq;
+};
+
+/** Words collected by one thread. Words are interned per thread and each word keeps a flat
+ *  list of (document,frequency) pairs that is only sorted and folded when the index is written.
+ */
+struct ThreadBuffer
 {
-  //printf("IndexWord::addUrlIndex(%d,%d)\n",idx,hiPriority);
-  auto it = m_urls.find(idx);
-  if (it==m_urls.end())
+  int urlIndex = -1;
+  std::unordered_map<std::string,size_t> wordIds;
+  std::vector<std::string> words;
+  std::vector<std::vector<URLInfo>> urls;
+
+  void addWord(const std::string &word,bool hiPriority)
   {
-    //printf("URLInfo::URLInfo(%d)\n",idx);
-    it = m_urls.emplace(idx,URLInfo(idx,0)).first;
+    auto it = wordIds.find(word);
+    if (it==wordIds.end())
+    {
+      it = wordIds.emplace(word,words.size()).first;
+      words.push_back(word);
+      urls.emplace_back();
+    }
+    auto &list = urls[it->second];
+    if (list.empty() || list.back().urlIdx!=urlIndex) // words are added document by document
+    {
+      list.push_back({urlIndex,0});
+    }
+    list.back().freq+=2;
+    if (hiPriority) list.back().freq|=1; // mark as high priority document
   }
-  it->second.freq+=2;
-  if (hiPriority) it->second.freq|=1; // mark as high priority document
+};
+
+/** A word of the final index with its merged document list */
+struct IndexWord
+{
+  const std::string *word;
+  std::vector<URLInfo> urls;
+};
+
+/** Sorts \a list on document and folds the entries for the same document into one */
+void foldUrls(std::vector<URLInfo> &list)
+{
+  std::sort(list.begin(),list.end(),[](const URLInfo &u1,const URLInfo &u2) { return u1.urlIdx<u2.urlIdx; });
+  size_t n=0;
+  for (size_t i=0;i<list.size();i++)
+  {
+    if (n>0 && list[n-1].urlIdx==list[i].urlIdx)
+    {
+      list[n-1].freq = ((list[n-1].freq&~1) + (list[i].freq&~1)) | ((list[n-1].freq|list[i].freq)&1);
+    }
+    else
+    {
+      list[n++] = list[i];
+    }
+  }
+  list.resize(n);
 }
 
+} // namespace
+
+struct SearchIndex::Private
+{
+  std::mutex mutex;
+  uint64_t id;
+  std::unordered_map<std::string,int> url2IdMap;
+  std::vector<URL> urls;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+  Private()
+  {
+    static std::atomic<uint64_t> nextId(1);
+    id = nextId++;
+  }
+  ThreadBuffer &threadBuffer()
+  {
+    // each thread gets its own buffer per index, so adding words does not need a lock
+    thread_local uint64_t      t_owner  = 0;
+    thread_local ThreadBuffer *t_buffer = nullptr;
+    if (t_owner!=id)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      buffers.push_back(std::make_unique<ThreadBuffer>());
+      t_buffer = buffers.back().get();
+      t_owner  = id;
+    }
+    return *t_buffer;
+  }
+};
+
 //--------------------------------------------------------------------
 
-SearchIndex::SearchIndex()
+SearchIndex::SearchIndex() : p(std::make_unique<Private>())
 {
-  m_index.resize(numIndexEntries);
 }
 
+SearchIndex::~SearchIndex() = default;
+SearchIndex::SearchIndex(SearchIndex &&) = default;
+SearchIndex &SearchIndex::operator=(SearchIndex &&) = default;
+
 void SearchIndex::setCurrentDoc(const Definition *ctx,const QCString &anchor,bool isSourceFile)
 {
   if (ctx==nullptr) return;
-  std::lock_guard<std::mutex> lock(g_searchIndexMutex);
   assert(!isSourceFile || ctx->definitionType()==Definition::TypeFile);
   //printf("SearchIndex::setCurrentDoc(%s,%s,%s)\n",name,baseName,anchor);
   QCString url=isSourceFile ? (toFileDef(ctx))->getSourceFileBase() : ctx->getOutputFileBase();
@@ -157,34 +252,28 @@ void SearchIndex::setCurrentDoc(const Definition *ctx,const QCString &anchor,boo
     }
   }
 
-  auto it = m_url2IdMap.find(baseUrl.str());
-  if (it == m_url2IdMap.end()) // new entry
+  int urlIndex;
   {
-    m_urlIndex = m_urlMaxIndex++;
-    m_url2IdMap.emplace(baseUrl.str(),m_urlIndex);
-    m_urls.emplace(m_urlIndex,URL(name,url));
-  }
-  else // existing entry
-  {
-    m_urlIndex=it->second;
-    m_urls.emplace(it->second,URL(name,url));
+    std::lock_guard<std::mutex> lock(p->mutex);
+    auto it = p->url2IdMap.find(baseUrl.str());
+    if (it == p->url2IdMap.end()) // new entry
+    {
+      urlIndex = static_cast<int>(p->urls.size());
+      p->url2IdMap.emplace(baseUrl.str(),urlIndex);
+      p->urls.emplace_back(name,url);
+    }
+    else // existing entry
+    {
+      urlIndex = it->second;
+    }
   }
+  p->threadBuffer().urlIndex = urlIndex;
 }
 
-static int charsToIndex(const QCString &word)
+static int charsToIndex(const std::string &word)
 {
   if (word.length()<2) return -1;
 
-  // Fast string hashing algorithm
-  //register uint16_t h=0;
-  //const char *k = word;
-  //uint16_t mask=0xfc00;
-  //while ( *k )
-  //{
-  //  h = (h&mask)^(h<<6)^(*k++);
-  //}
-  //return h;
-
   // Simple hashing that allows for substring searching
   uint32_t c1=static_cast<uint8_t>(word[0]);
   uint32_t c2=static_cast<uint8_t>(word[1]);
@@ -194,18 +283,13 @@ static int charsToIndex(const QCString &word)
 void SearchIndex::addWordRec(const QCString &word,bool hiPriority,bool recurse)
 {
   if (word.isEmpty()) return;
-  QCString wStr = QCString(word).lower();
+  ThreadBuffer &buf = p->threadBuffer();
+  if (buf.urlIndex<0) return; // no current document
+  std::string wStr = word.lower().str();
   //printf("SearchIndex::addWord(%s,%d) wStr=%s\n",word,hiPriority,qPrint(wStr));
   int idx=charsToIndex(wStr);
-  if (idx<0 || idx>=static_cast<int>(m_index.size())) return;
-  auto it = m_words.find(wStr.str());
-  if (it==m_words.end())
-  {
-    //fprintf(stderr,"addWord(%s) at index %d\n",word,idx);
-    m_index[idx].emplace_back(wStr);
-    it = m_words.emplace( wStr.str(), static_cast<int>(m_index[idx].size())-1 ).first;
-  }
-  m_index[idx][it->second].addUrlIndex(m_urlIndex,hiPriority);
+  if (idx<0 || idx>=static_cast<int>(numIndexEntries)) return;
+  buf.addWord(wStr,hiPriority);
   bool found=FALSE;
   if (!recurse) // the first time we check if we can strip the prefix
   {
@@ -234,7 +318,6 @@ void SearchIndex::addWordRec(const QCString &word,bool hiPriority,bool recurse)
 
 void SearchIndex::addWord(const QCString &word,bool hiPriority)
 {
-  std::lock_guard<std::mutex> lock(g_searchIndexMutex);
   addWordRec(word,hiPriority,FALSE);
 }
 
@@ -246,85 +329,92 @@ static void writeInt(std::ostream &f,size_t index)
   f.put(static_cast<int>(index&0xff));
 }
 
-static void writeString(std::ostream &f,const QCString &s)
+static void writeString(std::ostream &f,const char *s,size_t l)
 {
-  size_t l = s.length();
-  for (size_t i=0;i<l;i++) f.put(s[i]);
+  f.write(s,static_cast<std::streamsize>(l));
   f.put(0);
 }
 
 void SearchIndex::write(const QCString &fileName)
 {
-  size_t size=4; // for the header
-  size+=4*numIndexEntries; // for the index
-  size_t wordsOffset = size;
-  // first pass: compute the size of the wordlist
-  for (size_t i=0;i<numIndexEntries;i++)
+  // merge the words collected by the different threads
+  std::unordered_map<std::string_view,size_t> wordIds;
+  std::vector<IndexWord> words;
+  for (auto &buf : p->buffers)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
+    for (size_t i=0;i<buf->words.size();i++)
     {
-      for (const auto &iw : wlist)
+      auto it = wordIds.find(buf->words[i]);
+      if (it==wordIds.end())
       {
-        size_t ws = iw.word().length()+1;
-        size+=ws+4; // word + url info list offset
+        wordIds.emplace(buf->words[i],words.size());
+        words.push_back({&buf->words[i],std::move(buf->urls[i])});
+      }
+      else
+      {
+        auto &dst = words[it->second].urls;
+        dst.insert(dst.end(),buf->urls[i].begin(),buf->urls[i].end());
+        buf->urls[i].clear();
+        buf->urls[i].shrink_to_fit();
       }
-      size+=1; // zero list terminator
     }
+    buf->wordIds.clear();
+  }
+  wordIds.clear();
+  for (auto &iw : words) foldUrls(iw.urls);
+
+  // bucket the words on their first two characters, sorted so the output does not
+  // depend on the order in which the threads processed the documents
+  std::vector<std::vector<const IndexWord*>> index(numIndexEntries);
+  for (const auto &iw : words)
+  {
+    index[charsToIndex(*iw.word)].push_back(&iw);
+  }
+  for (auto &wlist : index)
+  {
+    std::sort(wlist.begin(),wlist.end(),[](const IndexWord *w1,const IndexWord *w2) { return *w1->word < *w2->word; });
   }
 
-  // second pass: compute the offsets in the index
-  size_t indexOffsets[numIndexEntries];
-  size_t offset=wordsOffset;
+  size_t size=4; // for the header
+  size+=4*numIndexEntries; // for the index
+
+  // first pass: compute the offsets in the index and the size of the word lists
+  std::vector<size_t> indexOffsets(numIndexEntries,0);
   for (size_t i=0;i<numIndexEntries;i++)
   {
-    const auto &wlist = m_index[i];
+    const auto &wlist = index[i];
     if (!wlist.empty())
     {
-      indexOffsets[i]=offset;
+      indexOffsets[i]=size;
       for (const auto &iw : wlist)
       {
-        offset+= iw.word().length()+1;
-        offset+=4; // word + offset to url info array
+        size+=iw->word->length()+1+4; // word + offset to url info array
       }
-      offset+=1; // zero list terminator
-    }
-    else
-    {
-      indexOffsets[i]=0;
+      size+=1; // zero list terminator
     }
   }
   size_t padding = size;
   size = (size+3)&~3; // round up to 4 byte boundary
   padding = size - padding;
 
-  std::vector<size_t> wordStatOffsets(m_words.size());
-
-  int count=0;
-
-  // third pass: compute offset to stats info for each word
-  for (size_t i=0;i<numIndexEntries;i++)
+  // second pass: compute offset to stats info for each word
+  size_t statsOffset = size;
+  for (const auto &wlist : index)
   {
-    const auto &wlist = m_index[i];
-    if (!wlist.empty())
+    for (const auto &iw : wlist)
     {
-      for (const auto &iw : wlist)
-      {
-        //printf("wordStatOffsets[%d]=%d\n",count,size);
-        wordStatOffsets[count++] = size;
-        size+=4 + iw.urls().size() * 8; // count + (url_index,freq) per url
-      }
+      size+=4 + iw->urls.size() * 8; // count + (url_index,freq) per url
     }
   }
-  std::vector<size_t> urlOffsets(m_urls.size());
-  for (const auto &udi : m_urls)
+  std::vector<size_t> urlOffsets(p->urls.size());
+  for (size_t i=0;i<p->urls.size();i++)
   {
-    urlOffsets[udi.first]=size;
-    size+=udi.second.name.length()+1+
-          udi.second.url.length()+1;
+    urlOffsets[i]=size;
+    size+=p->urls[i].name.length()+1+
+          p->urls[i].url.length()+1;
   }
 
-  //printf("Total size %x bytes (word=%x stats=%x urls=%x)\n",size,wordsOffset,statsOffset,urlsOffset);
+  //printf("Total size %x bytes\n",size);
   std::ofstream f = Portable::openOutputStream(fileName);
   if (f.is_open())
   {
@@ -336,16 +426,16 @@ void SearchIndex::write(const QCString &fileName)
       writeInt(f,indexOffsets[i]);
     }
     // write word lists
-    count=0;
-    for (size_t i=0;i<numIndexEntries;i++)
+    size_t wordStatOffset = statsOffset;
+    for (const auto &wlist : index)
     {
-      const auto &wlist = m_index[i];
       if (!wlist.empty())
       {
         for (const auto &iw : wlist)
         {
-          writeString(f,iw.word());
-          writeInt(f,wordStatOffsets[count++]);
+          writeString(f,iw->word->data(),iw->word->length());
+          writeInt(f,wordStatOffset);
+          wordStatOffset+=4 + iw->urls.size() * 8;
         }
         f.put(0);
       }
@@ -353,28 +443,23 @@ void SearchIndex::write(const QCString &fileName)
     // write extra padding bytes
     for (size_t i=0;i<padding;i++) f.put(0);
     // write word statistics
-    for (size_t i=0;i<numIndexEntries;i++)
+    for (const auto &wlist : index)
     {
-      const auto &wlist = m_index[i];
-      if (!wlist.empty())
+      for (const auto &iw : wlist)
       {
-        for (const auto &iw : wlist)
+        writeInt(f,iw->urls.size());
+        for (const auto &ui : iw->urls)
         {
-          size_t numUrls = iw.urls().size();
-          writeInt(f,numUrls);
-          for (const auto &ui : iw.urls())
-          {
-            writeInt(f,urlOffsets[ui.second.urlIdx]);
-            writeInt(f,ui.second.freq);
-          }
+          writeInt(f,urlOffsets[ui.urlIdx]);
+          writeInt(f,ui.freq);
         }
       }
     }
     // write urls
-    for (const auto &udi : m_urls)
+    for (const auto &u : p->urls)
     {
-      writeString(f,udi.second.name);
-      writeString(f,udi.second.url);
+      writeString(f,u.name.data(),u.name.length());
+      writeString(f,u.url.data(),u.url.length());
     }
   }
 
@@ -63,47 +63,18 @@ struct SIData_Word
 /** Writes search index for doxygen provided server based search engine that uses PHP. */
 class SearchIndex
 {
-    struct URL
-    {
-      URL(const QCString &n,const QCString &u) : name(n), url(u) {}
-      QCString name;
-      QCString url;
-    };
-
-    struct URLInfo
-    {
-      URLInfo(int idx,int f) : urlIdx(idx), freq(f) {}
-      int urlIdx;
-      int freq;
-    };
-
-    class IndexWord
-    {
-      public:
-        using URLInfoMap = std::unordered_map<int,URLInfo>;
-        IndexWord(const QCString &word) : m_word(word) {}
-        void addUrlIndex(int,bool);
-        URLInfoMap urls() const { return m_urls; }
-        QCString word() const { return m_word; }
-
-      private:
-        QCString    m_word;
-        URLInfoMap  m_urls;
-    };
-
   public:
     SearchIndex();
+   ~SearchIndex();
+    SearchIndex(SearchIndex &&);
+    SearchIndex &operator=(SearchIndex &&);
     void setCurrentDoc(const Definition *ctx,const QCString &anchor,bool isSourceFile);
     void addWord(const QCString &word,bool hiPriority);
     void write(const QCString &file);
   private:
     void addWordRec(const QCString &word,bool hiPrio,bool recurse);
-    std::unordered_map<std::string,int> m_words;
-    std::vector< std::vector< IndexWord> > m_index;
-    std::unordered_map<std::string,int> m_url2IdMap;
-    std::map<int,URL> m_urls;
-    int m_urlIndex = -1;
-    int m_urlMaxIndex = 0;
+    struct Private;
+    std::unique_ptr<Private> p;
 };
 
 /** Writes search index that should be used with an externally provided search engine,
@@ -16,6 +16,7 @@
 #include <utility>
 #include <algorithm>
 #include <cassert>
+#include <unordered_map>
 
 #include "searchindex_js.h"
 #include "doxygen.h"
@@ -578,10 +579,31 @@ static void writeJavascriptSearchData(const QCString &searchDirName)
     }
     if (j>0) t << "\n";
     t << "};\n\n";
+    if (Config_getBool(COMPACT_SEARCH_INDEX))
+    {
+      t << "var searchDataCompact = true;\n\n";
+    }
   }
 }
 
-static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCString &dataFileName,const SearchIndexList &list)
+//! A single link of an entry in the search data
+struct SearchDataLink
+{
+  QCString url;          //!< link target (escaped for JavaScript)
+  bool     parentTarget; //!< true if the link should be opened in the parent window
+  bool     hasScope;     //!< false if no scope is known
+  QCString scope;        //!< scope shown with the link (escaped for JavaScript)
+};
+
+//! An entry in the search data; a search word with one or more links
+struct SearchDataEntry
+{
+  QCString id;                       //!< unique id of the entry, used for matching
+  QCString name;                     //!< name as shown (escaped for JavaScript)
+  std::vector<SearchDataLink> links;
+};
+
+static std::vector<SearchDataEntry> collectSearchDataEntries(const SearchIndexList &list)
 {
   auto isDef = [](const SearchTerm::LinkInfo &info)
   {
@@ -600,30 +622,9 @@ static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCStri
     return isSection(info) ? std::get<const SectionInfo *>(info) : nullptr;
   };
 
+  std::vector<SearchDataEntry> entries;
   int cnt = 0;
-  std::ofstream ti = Portable::openOutputStream(dataFileName);
-  if (!ti.is_open())
-  {
-    err("Failed to open file '{}' for writing...\n",dataFileName);
-    return;
-  }
-
-  ti << "var searchData=\n";
-  // format
-  // searchData[] = array of items
-  // searchData[x][0] = id
-  // searchData[x][1] = [ name + child1 + child2 + .. ]
-  // searchData[x][1][0] = name as shown
-  // searchData[x][1][y+1] = info for child y
-  // searchData[x][1][y+1][0] = url
-  // searchData[x][1][y+1][1] = 1 => target="_parent"
-  // searchData[x][1][y+1][1] = 0 => target="_blank"
-  // searchData[x][1][y+1][2] = scope
-
-  ti << "[\n";
-  bool firstEntry=TRUE;
-
-  int childCount=0;
+  bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
   QCString lastWord;
   const Definition *prevScope = nullptr;
   for (auto it = list.begin(); it!=list.end();)
@@ -642,32 +643,23 @@ static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCStri
     const MemberDef  *md            = toMemberDef(d);
     QCString         anchor         = d ? d->anchor() : si ? si->label() : QCString();
 
-    if (word!=lastWord) // this item has a different search word
+    if (word!=lastWord || entries.empty()) // this item has a different search word
     {
-      if (!firstEntry)
-      {
-        ti << "]]]";
-        ti << ",\n";
-      }
-      firstEntry=FALSE;
-      ti << "  ['" << id << "_" << cnt++ << "',['";
+      SearchDataEntry entry;
+      entry.id = id+"_"+QCString().setNum(cnt++);
       if (next==SearchTerm::LinkInfo() || it->word!=word) // unique result, show title
       {
-        ti << convertToJSString(convertToXML(term.title),true,true);
+        entry.name = convertToJSString(convertToXML(term.title),true,true);
       }
       else // multiple results, show matching word only, expanded list will show title
       {
-        ti << convertToJSString(convertToXML(term.word),true,true);
+        entry.name = convertToJSString(convertToXML(term.word),true,true);
       }
-      ti << "',[";
-      childCount=0;
+      entries.push_back(std::move(entry));
       prevScope=nullptr;
     }
 
-    if (childCount>0)
-    {
-      ti << "],[";
-    }
+    SearchDataLink link;
     QCString fn  = d ? d->getOutputFileBase() : si ? si->fileName() : QCString();
     QCString ref = d ? d->getReference()      : si ? si->ref()      : QCString();
     addHtmlExtensionIfMissing(fn);
@@ -676,23 +668,15 @@ static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCStri
     {
       extRef+="#"+anchor;
     }
-    ti << "'" << convertToJSString(extRef,true,true) << "',";
-
-    bool extLinksInWindow = Config_getBool(EXT_LINKS_IN_WINDOW);
-    if (!extLinksInWindow || ref.isEmpty())
-    {
-      ti << "1,";
-    }
-    else
-    {
-      ti << "0,";
-    }
+    link.url = convertToJSString(extRef,true,true);
+    link.parentTarget = !extLinksInWindow || ref.isEmpty();
+    link.hasScope = true;
 
     if (lastWord!=word && (next==SearchTerm::LinkInfo() || it->word!=word)) // unique search result
     {
       if (d && d->getOuterScope()!=Doxygen::globalScope)
       {
-        ti << "'" << convertToJSString(convertToXML(d->getOuterScope()->name()),true,true) << "'";
+        link.scope = convertToJSString(convertToXML(d->getOuterScope()->name()),true,true);
       }
       else if (md)
       {
@@ -700,12 +684,12 @@ static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCStri
         if (fd==nullptr) fd = md->getFileDef();
         if (fd)
         {
-          ti << "'" << convertToJSString(convertToXML(fd->localName()),true,true) << "'";
+          link.scope = convertToJSString(convertToXML(fd->localName()),true,true);
+        }
+        else
+        {
+          link.hasScope = false;
         }
-      }
-      else
-      {
-        ti << "''";
       }
     }
     else // multiple entries with the same name
@@ -776,13 +760,63 @@ static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCStri
         name = prefix + "("+theTranslator->trGlobalNamespace()+")";
       }
 
-      ti << "'" << convertToJSString(name,true,true) << "'";
+      link.scope = convertToJSString(name,true,true);
 
       prevScope = scope;
-      childCount++;
     }
+    entries.back().links.push_back(std::move(link));
     lastWord = word;
   }
+  return entries;
+}
+
+static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCString &dataFileName,const SearchIndexList &list)
+{
+  std::ofstream ti = Portable::openOutputStream(dataFileName);
+  if (!ti.is_open())
+  {
+    err("Failed to open file '{}' for writing...\n",dataFileName);
+    return;
+  }
+
+  ti << "var searchData=\n";
+  // format
+  // searchData[] = array of items
+  // searchData[x][0] = id
+  // searchData[x][1] = [ name + child1 + child2 + .. ]
+  // searchData[x][1][0] = name as shown
+  // searchData[x][1][y+1] = info for child y
+  // searchData[x][1][y+1][0] = url
+  // searchData[x][1][y+1][1] = 1 => target="_parent"
+  // searchData[x][1][y+1][1] = 0 => target="_blank"
+  // searchData[x][1][y+1][2] = scope
+
+  ti << "[\n";
+  bool firstEntry=TRUE;
+  for (const auto &entry : collectSearchDataEntries(list))
+  {
+    if (!firstEntry)
+    {
+      ti << "]]]";
+      ti << ",\n";
+    }
+    firstEntry=FALSE;
+    ti << "  ['" << entry.id << "',['" << entry.name << "',[";
+    bool firstLink=TRUE;
+    for (const auto &link : entry.links)
+    {
+      if (!firstLink)
+      {
+        ti << "],[";
+      }
+      firstLink=FALSE;
+      ti << "'" << link.url << "'," << (link.parentTarget ? "1," : "0,");
+      if (link.hasScope)
+      {
+        ti << "'" << link.scope << "'";
+      }
+    }
+  }
   if (!firstEntry)
   {
     ti << "]]]\n";
@@ -791,11 +825,130 @@ static void writeJavasScriptSearchDataPage(const QCString &baseName,const QCStri
   Doxygen::indexList->addStyleSheetFile(("search/"+baseName+".js").data());
 }
 
+//! returns the length in UTF-16 code units of the longest common prefix of \a s1 and \a s2
+//! that ends at a character boundary, and the byte offset of that prefix in \a s2 via \a bytes
+static size_t commonPrefixUTF16(const QCString &s1,const QCString &s2,size_t &bytes)
+{
+  size_t n = std::min(s1.length(),s2.length());
+  size_t i = 0;
+  while (i<n && s1.at(i)==s2.at(i)) i++;
+  // do not split a multi-byte UTF-8 character
+  while (i>0 && i<s2.length() && (static_cast<unsigned char>(s2.at(i))&0xC0)==0x80) i--;
+  bytes = i;
+  size_t units = 0;
+  for (size_t j=0;j<i;j++)
+  {
+    unsigned char c = static_cast<unsigned char>(s2.at(j));
+    if      ((c&0xC0)!=0x80) units++; // start of a character
+    if      ((c&0xF8)==0xF0) units++; // 4 byte sequence needs a surrogate pair
+  }
+  return units;
+}
+
+/** Writes the search data for \a list in the compact format. The entries are split into
+ *  shards of a fixed number of entries that are loaded on demand by search.js. File names
+ *  and scopes are stored once per shard and the ids are front-coded.
+ *
+ *  The file \a dataFileName holds the range of ids per shard:
+ *  searchDataIndex(name,[[firstId,lastId],...])
+ *
+ *  Each shard is written to dataFileName_<n>.js:
+ *  searchDataShard(name,[file,...],[scope,...],[entry,...])
+ *  with entry = [sharedPrefixLength,idSuffix,name,link1,link2,...]
+ *  and link   = fileIndex,anchor,target,scopeIndex (-1 if there is no scope)
+ */
+static void writeCompactSearchDataPage(const QCString &baseName,const QCString &dataFileName,const SearchIndexList &list)
+{
+  const size_t shardSize = 500;
+  std::vector<SearchDataEntry> entries = collectSearchDataEntries(list);
+  QCString shardFileBase = dataFileName.left(dataFileName.length()-3); // strip .js
+
+  std::ofstream ti = Portable::openOutputStream(dataFileName);
+  if (!ti.is_open())
+  {
+    err("Failed to open file '{}' for writing...\n",dataFileName);
+    return;
+  }
+  ti << "searchDataIndex('" << baseName << "',[\n";
+  size_t numShards = (entries.size()+shardSize-1)/shardSize;
+  for (size_t shard=0; shard<numShards; shard++)
+  {
+    auto first = entries.begin()+shard*shardSize;
+    auto last  = entries.begin()+std::min(entries.size(),(shard+1)*shardSize);
+    QCString shardName;
+    shardName.sprintf("%s_%x",baseName.data(),static_cast<unsigned int>(shard));
+
+    // collect the tables of file names and scopes
+    std::unordered_map<std::string,int> fileIndex, scopeIndex;
+    std::vector<QCString> files, scopes;
+    QCString minId = first->id, maxId = first->id;
+    for (auto it=first; it!=last; ++it)
+    {
+      if (qstrcmp(it->id,minId)<0) minId = it->id;
+      if (qstrcmp(it->id,maxId)>0) maxId = it->id;
+      for (const auto &link : it->links)
+      {
+        int i = link.url.find('#');
+        QCString file = i==-1 ? link.url : link.url.left(i);
+        if (fileIndex.emplace(file.str(),static_cast<int>(files.size())).second) files.push_back(file);
+        if (link.hasScope && scopeIndex.emplace(link.scope.str(),static_cast<int>(scopes.size())).second) scopes.push_back(link.scope);
+      }
+    }
+    ti << (shard>0 ? ",\n" : "") << "['" << minId << "','" << maxId << "']";
+
+    QCString shardFileName;
+    shardFileName.sprintf("%s_%x.js",shardFileBase.data(),static_cast<unsigned int>(shard));
+    std::ofstream ts = Portable::openOutputStream(shardFileName);
+    if (!ts.is_open())
+    {
+      err("Failed to open file '{}' for writing...\n",shardFileName);
+      continue;
+    }
+    auto writeTable = [&ts](const std::vector<QCString> &table)
+    {
+      ts << "[";
+      bool firstItem=true;
+      for (const auto &str : table)
+      {
+        ts << (firstItem ? "'" : ",'") << str << "'";
+        firstItem=false;
+      }
+      ts << "],\n";
+    };
+    ts << "searchDataShard('" << shardName << "',\n";
+    writeTable(files);
+    writeTable(scopes);
+    ts << "[\n";
+    QCString prevId;
+    for (auto it=first; it!=last; ++it)
+    {
+      size_t bytes=0;
+      size_t prefixLen = commonPrefixUTF16(prevId,it->id,bytes);
+      ts << (it!=first ? ",\n" : "") << "[" << prefixLen << ",'" << it->id.mid(bytes) << "','" << it->name << "'";
+      for (const auto &link : it->links)
+      {
+        int i = link.url.find('#');
+        QCString file   = i==-1 ? link.url : link.url.left(i);
+        QCString anchor = i==-1 ? QCString() : link.url.mid(i+1);
+        ts << "," << fileIndex[file.str()] << ",'" << anchor << "'," << (link.parentTarget ? 1 : 0) << ","
+           << (link.hasScope ? scopeIndex[link.scope.str()] : -1);
+      }
+      ts << "]";
+      prevId = it->id;
+    }
+    ts << "\n]);\n";
+    Doxygen::indexList->addStyleSheetFile(("search/"+shardName+".js").data());
+  }
+  ti << "]);\n";
+  Doxygen::indexList->addStyleSheetFile(("search/"+baseName+".js").data());
+}
+
 
 void writeJavaScriptSearchIndex()
 {
   // write index files
   QCString searchDirName = Config_getString(HTML_OUTPUT)+"/search";
+  bool compact = Config_getBool(COMPACT_SEARCH_INDEX);
 
   std::size_t numThreads = static_cast<std::size_t>(Config_getInt(NUM_PROC_THREADS));
   if (numThreads>1) // multi threaded version
@@ -811,9 +964,12 @@ void writeJavaScriptSearchIndex()
         baseName.sprintf("%s_%x",sii.name.data(),p);
         QCString dataFileName = searchDirName + "/"+baseName+".js";
         auto &list = symList;
-        auto processFile = [p,baseName,dataFileName,&list]()
+        auto processFile = [p,baseName,dataFileName,&list,compact]()
         {
-          writeJavasScriptSearchDataPage(baseName,dataFileName,list);
+          if (compact)
+            writeCompactSearchDataPage(baseName,dataFileName,list);
+          else
+            writeJavasScriptSearchDataPage(baseName,dataFileName,list);
           return p;
         };
         results.emplace_back(threadPool.queue(processFile));
@@ -833,7 +989,10 @@ void writeJavaScriptSearchIndex()
         QCString baseName;
         baseName.sprintf("%s_%x",sii.name.data(),p);
         QCString dataFileName = searchDirName + "/"+baseName+".js";
-        writeJavasScriptSearchDataPage(baseName,dataFileName,symList);
+        if (compact)
+          writeCompactSearchDataPage(baseName,dataFileName,symList);
+        else
+          writeJavasScriptSearchDataPage(baseName,dataFileName,symList);
         p++;
       }
     }
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <string_view>
+#include <cstring>
 
 /** @file
  *  @brief Some helper functions for std::string
@@ -93,6 +94,42 @@ inline void addTerminalCharIfMissing(std::string &s,char c)
   }
 }
 
+/** Returns the number of newlines in \a s and sets \a tail to the part of \a s that follows
+ *  the last newline (or to \a s itself if there is none). Uses memchr, so long runs
+ *  of text without newlines are skipped in bulk.
+ */
+inline int countLines(std::string_view s,std::string_view &tail)
+{
+  int count=0;
+  const char *p = s.data();
+  const char *e = p+s.size();
+  const char *nl;
+  while (p<e && (nl=static_cast<const char*>(memchr(p,'\n',static_cast<size_t>(e-p))))!=nullptr)
+  {
+    count++;
+    p=nl+1;
+  }
+  tail = std::string_view(p,static_cast<size_t>(e-p));
+  return count;
+}
+
+/** Returns the column reached after advancing \a col over \a s, where \a s should not contain
+ *  newlines and tabs advance to the next multiple of \a tabSize.
+ */
+inline int advanceColumn(std::string_view s,int col,int tabSize)
+{
+  const char *p = s.data();
+  const char *e = p+s.size();
+  const char *tab;
+  while (p<e && (tab=static_cast<const char*>(memchr(p,'\t',static_cast<size_t>(e-p))))!=nullptr)
+  {
+    col+=static_cast<int>(tab-p);
+    col+=tabSize-(col%tabSize);
+    p=tab+1;
+  }
+  return col+static_cast<int>(e-p);
+}
+
 /// returns TRUE iff \a data points to a substring that matches string literal \a str
 template <size_t N>
 bool literal_at(const char *data,const char (&str)[N])
@@ -25,6 +25,7 @@
 #include "config.h"
 #include "defargs.h"
 #include "trace.h"
+#include "profiler.h"
 
 #if !ENABLE_SYMBOLRESOLVER_TRACING
 #undef  AUTO_TRACE
@@ -35,7 +36,7 @@
 #define AUTO_TRACE_EXIT(...) (void)0
 #endif
 
-static std::mutex g_cacheMutex;
+static ProfiledMutex g_cacheMutex("g_cacheMutex");
 static std::recursive_mutex g_cacheTypedefMutex;
 
 static std::mutex g_substMapMutex;
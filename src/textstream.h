@@ -218,6 +218,17 @@ class TextStream final
       return m_buffer;
     }
 
+    /** Returns the contents of the buffer and leaves the buffer empty.
+     *  Unlike str() this does not copy the data.
+     */
+    std::string take()
+    {
+      std::string result;
+      std::swap(result,m_buffer);
+      m_buffer.reserve(INITIAL_CAPACITY);
+      return result;
+    }
+
     /** Sets the buffer's contents to string \a s.
      *  Any data already in the buffer will be flushed.
      */
@@ -1431,6 +1431,51 @@ bool transcodeCharacterStringToUTF8(std::string &input, const char *inputEncodin
   return ok;
 }
 
+/*! Returns the MD5 signature of \a s as a string of 32 hexadecimal digits. */
+QCString computeMd5Signature(const QCString &s)
+{
+  uint8_t md5_sig[16];
+  char sigStr[33];
+  MD5Buffer(s.data(),static_cast<unsigned int>(s.length()),md5_sig);
+  MD5SigToString(md5_sig,sigStr);
+  return sigStr;
+}
+
+/*! Checks if a file "baseName".md5 exists. If so the contents
+ *  are compared with \a md5. If equal TRUE is returned.
+ *  The .md5 file is created or updated with writeMd5Signature() after
+ *  successful creation of the output file.
+ */
+bool sameMd5Signature(const QCString &baseName,const QCString &md5)
+{
+  bool same = false;
+  char md5stored[33];
+  md5stored[0]=0;
+  std::ifstream f = Portable::openInputStream(baseName+".md5",true);
+  if (f.is_open())
+  {
+    // read checksum
+    f.read(md5stored,32);
+    md5stored[32]='\0';
+    // compare checksum
+    if (!f.fail() && md5==md5stored)
+    {
+      same = true;
+    }
+  }
+  return same;
+}
+
+/*! Writes the signature \a md5 to the file "baseName".md5 */
+void writeMd5Signature(const QCString &baseName,const QCString &md5)
+{
+  std::ofstream f = Portable::openOutputStream(baseName+".md5");
+  if (f.is_open())
+  {
+    f.write(md5.data(),md5.length());
+  }
+}
+
 /*! reads a file with name \a name and returns it as a string. If \a filter
  *  is TRUE the file will be filtered by any user specified input filter.
  *  If \a name is "-" the string will be read from standard input.
@@ -2835,32 +2880,33 @@ static Cache<std::string,FindFileCacheElem> g_findFileDefCache(5000);
 
 static std::mutex g_findFileDefMutex;
 
-FileDef *findFileDef(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambig)
+std::pair<uint64_t,uint64_t> findFileDefCacheHitsAndMisses()
 {
-  ambig=FALSE;
-  if (n.isEmpty()) return nullptr;
-
-
-  const int maxAddrSize = 20;
-  char addr[maxAddrSize];
-  qsnprintf(addr,maxAddrSize,"%p:",reinterpret_cast<const void*>(fnMap));
-  QCString key = addr;
-  key+=n;
-
   std::lock_guard<std::mutex> lock(g_findFileDefMutex);
-  FindFileCacheElem *cachedResult = g_findFileDefCache.find(key.str());
-  //printf("key=%s cachedResult=%p\n",qPrint(key),cachedResult);
-  if (cachedResult)
-  {
-    ambig = cachedResult->isAmbig;
-    //printf("cached: fileDef=%p\n",cachedResult->fileDef);
-    return cachedResult->fileDef;
-  }
-  else
+  return { g_findFileDefCache.hits(), g_findFileDefCache.misses() };
+}
+
+void buildFileNameIndex(FileNameLinkedMap *fnMap)
+{
+  for (const auto &fn : *fnMap)
   {
-    cachedResult = g_findFileDefCache.insert(key.str(),FindFileCacheElem(nullptr,FALSE));
+    // a file name with a single file is resolved without index
+    if (fn->size()>1)
+    {
+      StringVector paths;
+      paths.reserve(fn->size());
+      for (const auto &fd : *fn)
+      {
+        paths.push_back(stripFromIncludePath(fd->getPath()).str());
+      }
+      fn->setSuffixIndex(std::make_unique<PathSuffixIndex>(paths));
+    }
   }
+  fnMap->setComplete();
+}
 
+static FileDef *findFileDefNoCache(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambig)
+{
   QCString name=Dir::cleanDirPath(n.str());
   QCString path;
   if (name.isEmpty()) return nullptr;
@@ -2883,11 +2929,21 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambi
                  fd->getPath().right(path.length()).lower()==path.lower();
       if (path.isEmpty() || isSamePath)
       {
-        cachedResult->fileDef = fd.get();
         return fd.get();
       }
     }
-    else // file name alone is ambiguous
+    else if (path.isEmpty()) // file name alone is ambiguous
+    {
+      ambig=TRUE;
+      return fn->back().get();
+    }
+    else if (const PathSuffixIndex *index = fn->suffixIndex()) // find the files ending with path
+    {
+      auto match = index->find(stripFromIncludePath(path).view());
+      ambig=(match.count>1);
+      return match.count>0 ? fn->at(match.last).get() : nullptr;
+    }
+    else // no index, check the files one by one
     {
       int count=0;
       FileDef *lastMatch=nullptr;
@@ -2896,8 +2952,7 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambi
       {
         FileDef *fd = fd_p.get();
         QCString fdStripPath = stripFromIncludePath(fd->getPath());
-        if (path.isEmpty() ||
-            (!pathStripped.isEmpty() && fdStripPath.endsWith(pathStripped)) ||
+        if ((!pathStripped.isEmpty() && fdStripPath.endsWith(pathStripped)) ||
             (pathStripped.isEmpty() && fdStripPath.isEmpty()))
         {
           count++;
@@ -2906,8 +2961,6 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambi
       }
 
       ambig=(count>1);
-      cachedResult->isAmbig = ambig;
-      cachedResult->fileDef = lastMatch;
       return lastMatch;
     }
   }
@@ -2918,6 +2971,35 @@ FileDef *findFileDef(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambi
   return nullptr;
 }
 
+FileDef *findFileDef(const FileNameLinkedMap *fnMap,const QCString &n,bool &ambig)
+{
+  ambig=FALSE;
+  if (n.isEmpty()) return nullptr;
+
+  // a complete map is not modified anymore and its ambiguous names are indexed,
+  // so the lookup is fast and can be done without lock
+  if (fnMap->isComplete()) return findFileDefNoCache(fnMap,n,ambig);
+
+  const int maxAddrSize = 20;
+  char addr[maxAddrSize];
+  qsnprintf(addr,maxAddrSize,"%p:",reinterpret_cast<const void*>(fnMap));
+  QCString key = addr;
+  key+=n;
+
+  std::lock_guard<std::mutex> lock(g_findFileDefMutex);
+  FindFileCacheElem *cachedResult = g_findFileDefCache.find(key.str());
+  //printf("key=%s cachedResult=%p\n",qPrint(key),cachedResult);
+  if (cachedResult)
+  {
+    ambig = cachedResult->isAmbig;
+    //printf("cached: fileDef=%p\n",cachedResult->fileDef);
+    return cachedResult->fileDef;
+  }
+  FileDef *fd = findFileDefNoCache(fnMap,n,ambig);
+  g_findFileDefCache.insert(key.str(),FindFileCacheElem(fd,ambig));
+  return fd;
+}
+
 //----------------------------------------------------------------------
 
 QCString findFilePath(const QCString &file,bool &ambig)
@@ -3986,6 +4068,42 @@ QCString convertToJSString(const QCString &s,bool keepEntities,bool singleQuotes
   return keepEntities ? result : convertCharEntitiesToUTF8(result);
 }
 
+/*! Escapes \a s for use inside a double quoted JSON string. Unlike convertToJSString()
+ *  all control characters are escaped and no JavaScript specific escapes are produced.
+ */
+std::string convertToJSONString(const std::string &s)
+{
+  static const char hexDigits[] = "0123456789abcdef";
+  std::string result;
+  result.reserve(s.length()+8);
+  for (char c : s)
+  {
+    switch (c)
+    {
+      case '"':  result+="\\\""; break;
+      case '\\': result+="\\\\"; break;
+      case '\b': result+="\\b";  break;
+      case '\f': result+="\\f";  break;
+      case '\n': result+="\\n";  break;
+      case '\r': result+="\\r";  break;
+      case '\t': result+="\\t";  break;
+      default:
+        if (static_cast<unsigned char>(c)<0x20)
+        {
+          result+="\\u00";
+          result+=hexDigits[(c>>4)&0xf];
+          result+=hexDigits[c&0xf];
+        }
+        else
+        {
+          result+=c;
+        }
+        break;
+    }
+  }
+  return result;
+}
+
 QCString convertCharEntitiesToUTF8(const QCString &str)
 {
   if (str.isEmpty()) return QCString();
@@ -5510,22 +5628,11 @@ bool readInputFile(const QCString &fileName,std::string &contents,bool filter,bo
   else
   {
     QCString cmd=filterName+" \""+fileName+"\"";
-    Debug::print(Debug::ExtCmd,0,"Executing popen(`{}`)\n",cmd);
-    FILE *f=Portable::popen(cmd,"r");
-    if (!f)
+    if (Portable::runCommand(cmd,contents)==-1)
     {
       err("could not execute filter {}\n",filterName);
       return FALSE;
     }
-    const int bufSize=4096;
-    char buf[bufSize];
-    int numRead = 0;
-    while ((numRead=static_cast<int>(fread(buf,1,bufSize,f)))>0)
-    {
-      //printf(">>>>>>>>Reading %d bytes\n",numRead);
-      contents.append(buf,numRead);
-    }
-    Portable::pclose(f);
     Debug::print(Debug::FilterOutput, 0, "Filter output\n");
     Debug::print(Debug::FilterOutput,0,"-------------\n{}\n-------------\n",contents);
   }
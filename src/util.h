@@ -105,6 +105,10 @@ void linkifyText(const TextGeneratorIntf &ol,
 
 QCString fileToString(const QCString &name,bool filter=FALSE,bool isSourceCode=FALSE);
 
+QCString computeMd5Signature(const QCString &s);
+bool sameMd5Signature(const QCString &baseName,const QCString &md5);
+void writeMd5Signature(const QCString &baseName,const QCString &md5);
+
 struct GetDefInput
 {
   GetDefInput(const QCString &scName,const QCString &memName,const QCString &a) :
@@ -198,6 +202,13 @@ QCString removeEmptyLines(const QCString &s);
 
 
 FileDef *findFileDef(const FileNameLinkedMap *fnMap, const QCString &n, bool &ambig);
+
+//! indexes the paths of the files in \a fnMap and marks the map as complete, so findFileDef()
+//! can search it without lock. No files may be added to the map afterwards.
+void buildFileNameIndex(FileNameLinkedMap *fnMap);
+
+//! returns the number of cache hits and misses of findFileDef() for maps that are not indexed
+std::pair<uint64_t,uint64_t> findFileDefCacheHitsAndMisses();
 QCString findFilePath(const QCString &file, bool &ambig);
 
 QCString showFileDefMatches(const FileNameLinkedMap *fnMap,const QCString &n);
@@ -277,6 +288,7 @@ QCString convertToHtml(const QCString &s,bool keepEntities=true);
 QCString convertToXML(const QCString &s, bool keepEntities=false);
 
 QCString convertToJSString(const QCString &s,bool keepEntities=false,bool singleQuotes=false);
+std::string convertToJSONString(const std::string &s);
 
 QCString getOverloadDocs();
 
@@ -24,6 +24,48 @@
  */
 const SEARCH_COOKIE_NAME = '$PROJECTID'+'search_grp';
 
+function convertToId(search) {
+  let result = '';
+  for (let i=0;i<search.length;i++) {
+    const c = search.charAt(i);
+    const cn = c.charCodeAt(0);
+    if (c.match(/[a-z0-9\u0080-\uFFFF]/)) {
+      result+=c;
+    } else if (cn<16) {
+      result+="_0"+cn.toString(16);
+    } else {
+      result+="_"+cn.toString(16);
+    }
+  }
+  return result;
+}
+
+// Storage for the search data written with COMPACT_SEARCH_INDEX enabled.
+// A data file per starting letter lists the id range of each of its shards,
+// the shards themselves are loaded on demand and decoded into the searchData format.
+const searchShardRanges = {};
+const searchShardData = {};
+var searchData;
+
+function searchDataIndex(name,ranges) {
+  searchShardRanges[name] = ranges;
+}
+
+function searchDataShard(name,files,scopes,entries) {
+  const data = [];
+  let id = '';
+  entries.forEach((e) => {
+    id = id.substr(0,e[0])+e[1]; // ids are front-coded
+    const item = [e[2]];
+    for (let i=3; i<e.length; i+=4) {
+      const url = files[e[i]]+(e[i+1]!=='' ? '#'+e[i+1] : '');
+      item.push(e[i+3]>=0 ? [url,e[i+2],scopes[e[i+3]]] : [url,e[i+2]]);
+    }
+    data.push([id,item]);
+  });
+  searchShardData[name] = data;
+}
+
 const searchResults = new SearchResults();
 
 /* A class handling everything associated with the search panel.
@@ -70,6 +112,7 @@ function SearchBox(name, resultsPath, extension) {
   this.hideTimeout           = 0;
   this.searchIndex           = 0;
   this.searchActive          = false;
+  this.searchGeneration      = 0;
   this.extension             = extension;
 
   // ----------- DOM Elements
@@ -316,7 +359,37 @@ function SearchBox(name, resultsPath, extension) {
       }
     }
 
-    if (jsFile) {
+    const searchGeneration = ++this.searchGeneration;
+    const searchBoxObj = this;
+    const loadShards = function() {
+      if (searchGeneration!=searchBoxObj.searchGeneration) return; // a newer search was started
+      const page = indexSectionNames[searchBoxObj.searchIndex] + '_' + idx.toString(16);
+      const ranges = searchShardRanges[page] || [];
+      const searchId = convertToId(searchValue.replace(/ +$/, "").toLowerCase());
+      const exact = /^[\x00-\x7f]*$/.test(searchId); // id ranges are only compared for ASCII input
+      const shards = [];
+      ranges.forEach((r,i) => {
+        if (!exact || (r[0] < searchId+'\uffff' && r[1] >= searchId)) {
+          shards.push(page + '_' + i.toString(16));
+        }
+      });
+      const missing = shards.find((shard) => !(shard in searchShardData));
+      if (missing) {
+        loadJS(searchBoxObj.resultsPath + missing + '.js', loadShards, domPopupSearchResultsWindow);
+      } else {
+        searchData = [].concat(...shards.map((shard) => searchShardData[shard]));
+        handleResults();
+      }
+    }
+
+    if (jsFile && typeof searchDataCompact!=='undefined' && searchDataCompact) {
+      const page = indexSectionNames[this.searchIndex] + '_' + idx.toString(16);
+      if (page in searchShardRanges) {
+        loadShards();
+      } else {
+        loadJS(jsFile, loadShards, this.DOMPopupSearchResultsWindow());
+      }
+    } else if (jsFile) {
       loadJS(jsFile, handleResults, this.DOMPopupSearchResultsWindow());
     } else {
       handleResults();
@@ -350,22 +423,6 @@ function SearchBox(name, resultsPath, extension) {
 // The class that handles everything on the search results page.
 function SearchResults() {
 
-  function convertToId(search) {
-    let result = '';
-    for (let i=0;i<search.length;i++) {
-      const c = search.charAt(i);
-      const cn = c.charCodeAt(0);
-      if (c.match(/[a-z0-9\u0080-\uFFFF]/)) {
-        result+=c;
-      } else if (cn<16) {
-        result+="_0"+cn.toString(16);
-      } else {
-        result+="_"+cn.toString(16);
-      }
-    }
-    return result;
-  }
-
   // The number of matches from the last run of <Search()>.
   this.lastMatchCount = 0;
   this.lastKey = 0;
@@ -0,0 +1,16 @@
+// objective: test combining the RTF pages in memory when RTF_OUTPUT is reached through a symbolic link
+// check: indexpage.xml
+// config: RTF_COMBINE_IN_MEMORY = YES
+// rtf_output_link: YES
+// rtf_check: YES
+/** \mainpage
+ *  Main page of the RTF document.
+ */
+
+/** A class, so the RTF document includes a page for it. */
+class Example
+{
+  public:
+    /** A member function. */
+    void run();
+};
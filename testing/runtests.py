@@ -183,10 +183,14 @@ class Tester:
                 print('XML_OUTPUT=%s/out' % self.test_out, file=f)
             else:
                 print('GENERATE_XML=NO', file=f)
-            if (self.args.rtf):
+            if (self.rtf_wanted()):
                 print('GENERATE_RTF=YES', file=f)
                 print('RTF_HYPERLINKS=YES', file=f)
                 print('RTF_OUTPUT=%s/rtf' % self.test_out, file=f)
+                if 'rtf_output_link' in self.config:
+                    # reach the output directory through a symbolic link
+                    os.mkdir('%s/rtf_target' % self.test_out)
+                    os.symlink('rtf_target','%s/rtf' % self.test_out,target_is_directory=True)
             else:
                 print('GENERATE_RTF=NO', file=f)
             if (self.args.docbook):
@@ -240,12 +244,27 @@ class Tester:
             sys.exit(1)
 
 
+    # RTF output is generated when requested with --rtf or when the test checks it itself
+    def rtf_wanted(self):
+        return self.args.rtf or ('rtf_check' in self.config and not self.update)
+
+    # checks that all pages have been combined into refman.rtf and that no intermediate pages are left behind
+    def check_combined_rtf(self,rtf_output):
+        if not os.path.isfile('%s/refman.rtf' % rtf_output):
+            return (False, "RTF: refman.rtf has not been generated")
+        left = [f for f in os.listdir(rtf_output) if f.endswith('.rtf') and f != 'refman.rtf']
+        if left:
+            return (False, "RTF: intermediate pages left in the output directory: %s" % ' '.join(sorted(left)))
+        return (True,"")
+
     def check_link_rtf_file(self,fil):
         bkmk_res = []
         hyper_res = []
         pageref_res = []
         with xopen(fil,'r') as f:
             for line in f.readlines():
+                if "INCLUDETEXT" in line:
+                    return (False, "RTF: Not all pages have been combined into refman.rtf")
                 if ("bkmkstart" in line) or ("HYPERLINK" in line) or ("PAGEREF" in line):
                     msg = line.split('}')
                     for m in msg:
@@ -447,8 +466,12 @@ class Tester:
                 xml_output='%s/out' % self.test_out
                 shutil.rmtree(xml_output,ignore_errors=True)
 
-        if (self.args.rtf):
-            (res, msg1) = self.check_link_rtf_file("%s/rtf/refman.rtf" % self.test_out)
+        if (self.rtf_wanted()):
+            res = True
+            if 'rtf_check' in self.config:
+                (res, msg1) = self.check_combined_rtf("%s/rtf" % self.test_out)
+            if res:
+                (res, msg1) = self.check_link_rtf_file("%s/rtf/refman.rtf" % self.test_out)
             if not res:
                 #msg += ("RTF: Not all used hyperlinks have been defined",)
                 msg += (msg1,)